@@ -0,0 +1,46 @@
+#!/bin/bash
+# Build the optimisation presets, run the PGO training pass and report the
+# decode throughput gain of each preset over the plain release build.
+#
+# Usage: bench/compare_builds.sh [extra skydecoder_bench arguments]
+#        (e.g. --corpus=recording.ast to train and measure on real traffic)
+set -e
+
+cd "$(dirname "$0")/.."
+BENCH_ARGS=("$@")
+PRESETS=(release release-visibility release-lto pgo-use)
+JOBS=$(nproc 2>/dev/null || echo 4)
+
+build_preset() {
+    cmake --preset "$1" > /dev/null
+    cmake --build --preset "$1" --target skydecoder_bench -j "$JOBS" > /dev/null
+}
+
+run_bench() {
+    "build/$1/skydecoder_bench" "${BENCH_ARGS[@]}" | awk '$2 == "decode_records_per_sec" { print $3 }'
+}
+
+echo "Training run (pgo-generate)..."
+rm -rf build/pgo-profiles
+build_preset pgo-generate
+"build/pgo-generate/skydecoder_bench" "${BENCH_ARGS[@]}" --iterations=1 > /dev/null
+
+if ls build/pgo-profiles/*.profraw > /dev/null 2>&1; then
+    llvm-profdata merge -o build/pgo-profiles/default.profdata build/pgo-profiles/*.profraw
+fi
+
+declare -A RESULTS
+for preset in "${PRESETS[@]}"; do
+    echo "Building and running $preset..."
+    build_preset "$preset"
+    RESULTS[$preset]=$(run_bench "$preset")
+done
+
+BASE=${RESULTS[release]}
+echo
+printf "%-22s %16s %10s\n" "Preset" "Records/s" "Gain"
+for preset in "${PRESETS[@]}"; do
+    value=${RESULTS[$preset]}
+    gain=$(awk -v v="$value" -v b="$BASE" 'BEGIN { printf "%+.1f%%", (v / b - 1) * 100 }')
+    printf "%-22s %16s %10s\n" "$preset" "$value" "$gain"
+done
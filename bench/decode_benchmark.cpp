@@ -0,0 +1,799 @@
+#include <skydecoder/asterix_decoder.h>
+#include <skydecoder/async_file_writer.h>
+#include <skydecoder/binary_serializer.h>
+#include <skydecoder/scan_assembler.h>
+#include <skydecoder/scan_correlator.h>
+#include <skydecoder/window_aggregator.h>
+#include <skydecoder/cpu_features.h>
+#include <skydecoder/utils.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace skydecoder;
+
+#ifndef SKYDECODER_DATA_DIR
+#define SKYDECODER_DATA_DIR "data/asterix_categories"
+#endif
+
+/**
+ * @brief Decode throughput benchmark
+ *
+ * Decodes a CAT002 corpus (a recording given with --corpus, or a synthetic
+ * mix of north markers and sector crossings) repeatedly and prints one
+ * "RESULT <name> <value>" line per metric so that build variants (LTO, PGO,
+ * visibility, ISA) can be compared by bench/compare_builds.sh.
+ */
+struct BenchmarkOptions {
+    std::string categories_dir = SKYDECODER_DATA_DIR;
+    std::string corpus_file;
+    std::string write_corpus;
+    size_t blocks = 20000;
+    size_t iterations = 5;
+    bool plan_cache = true;
+    bool specialize = false;
+    size_t threads = 1;
+};
+
+/**
+ * @brief Generate a deterministic CAT002 corpus
+ */
+std::vector<uint8_t> generate_cat002_corpus(size_t block_count) {
+    std::vector<uint8_t> corpus;
+    std::mt19937 rng(2002);
+    uint32_t time_of_day = 12 * 3600 * 128;
+    uint8_t sector = 0;
+
+    for (size_t b = 0; b < block_count; ++b) {
+        std::vector<uint8_t> block = {0x02, 0x00, 0x00};
+        size_t records = 1 + rng() % 8;
+
+        for (size_t r = 0; r < records; ++r) {
+            uint8_t sic = static_cast<uint8_t>(1 + rng() % 4);
+            bool with_status = sector != 0 && rng() % 4 == 0;
+            time_of_day += 1 + rng() % 64;
+
+            if (sector == 0) {
+                // North marker: I002/010, 000, 020, 030, 041 + FX; I002/090
+                block.insert(block.end(), {0xF9, 0x10});
+                block.insert(block.end(), {0x08, sic, 0x01, 0x00});
+            } else {
+                // Sector crossing: I002/010, 000, 020, 030 (+ I002/050 now and then)
+                block.push_back(with_status ? 0xF4 : 0xF0);
+                block.insert(block.end(), {0x08, sic, 0x02, sector});
+            }
+
+            block.push_back(static_cast<uint8_t>(time_of_day >> 16));
+            block.push_back(static_cast<uint8_t>(time_of_day >> 8));
+            block.push_back(static_cast<uint8_t>(time_of_day));
+
+            if (sector == 0) {
+                block.insert(block.end(), {0x02, 0x00});         // I002/041: 4 s
+                block.insert(block.end(), {0x03, 0xFE});         // I002/090
+            } else if (with_status) {
+                block.insert(block.end(), {0x81, 0x40});         // I002/050, two octets
+            }
+
+            sector = static_cast<uint8_t>(sector + 32);
+        }
+
+        block[1] = static_cast<uint8_t>(block.size() >> 8);
+        block[2] = static_cast<uint8_t>(block.size());
+        corpus.insert(corpus.end(), block.begin(), block.end());
+    }
+
+    return corpus;
+}
+
+/**
+ * @brief Split a corpus into blocks using the header length fields
+ */
+std::vector<std::pair<size_t, size_t>> split_blocks(const std::vector<uint8_t>& corpus) {
+    std::vector<std::pair<size_t, size_t>> blocks;
+    size_t offset = 0;
+
+    while (offset + 3 <= corpus.size()) {
+        size_t length = (corpus[offset + 1] << 8) | corpus[offset + 2];
+        if (length < 3 || offset + length > corpus.size()) {
+            break;
+        }
+        blocks.emplace_back(offset, length);
+        offset += length;
+    }
+
+    return blocks;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const std::string& name, double value, const std::string& unit) {
+    std::cout << "RESULT " << std::left << std::setw(28) << name << " "
+              << std::fixed << std::setprecision(2) << value << " " << unit << std::endl;
+}
+
+/**
+ * @brief Decode the whole corpus several times, keep the best run
+ */
+void bench_decode(AsterixDecoder& decoder, const std::vector<uint8_t>& corpus, size_t iterations) {
+    auto blocks = split_blocks(corpus);
+    double best = 0.0;
+    size_t records = 0;
+    size_t invalid = 0;
+
+    for (size_t it = 0; it < iterations; ++it) {
+        records = 0;
+        invalid = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (const auto& block : blocks) {
+            auto decoded = decoder.decode_block(corpus.data() + block.first, block.second);
+            records += decoded.messages.size();
+            if (!decoded.valid) invalid++;
+        }
+
+        double elapsed = seconds_since(start);
+        if (best == 0.0 || elapsed < best) best = elapsed;
+    }
+
+    report("decode_records_per_sec", records / best, "rec/s");
+    report("decode_mb_per_sec", corpus.size() / best / 1e6, "MB/s");
+    report("decode_ns_per_record", best * 1e9 / std::max<size_t>(records, 1), "ns");
+    report("decode_invalid_blocks", static_cast<double>(invalid), "blocks");
+    
+    if (decoder.is_plan_cache_enabled()) {
+        auto stats = decoder.get_plan_cache_stats(2);
+        report("plan_cache_hit_ratio", stats.hit_ratio() * 100.0, "%");
+        report("specialized_plans", static_cast<double>(stats.specialized_plans), "plans");
+        report("specialized_record_ratio", 100.0 * stats.specialized_records / std::max<size_t>(records * iterations, 1), "%");
+    }
+}
+
+/**
+ * @brief Index every record lazily and read a single item from each
+ */
+void bench_lazy(AsterixDecoder& decoder, const std::vector<uint8_t>& corpus, size_t iterations) {
+    auto blocks = split_blocks(corpus);
+    std::vector<LazyRecord> records;
+    double best = 0.0;
+    size_t message_types = 0;
+
+    for (size_t it = 0; it < iterations; ++it) {
+        records.clear();
+        message_types = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (const auto& block : blocks) {
+            decoder.decode_block_lazy(corpus.data() + block.first, block.second, records);
+        }
+        for (auto& record : records) {
+            if (record.item("I002/000")) message_types++;
+        }
+
+        double elapsed = seconds_since(start);
+        if (best == 0.0 || elapsed < best) best = elapsed;
+    }
+
+    report("lazy_ns_per_record", best * 1e9 / std::max<size_t>(records.size(), 1), "ns");
+    report("lazy_items_decoded", 100.0 * message_types / std::max<size_t>(records.size(), 1), "% of records");
+}
+
+/**
+ * @brief Two-phase decode of the whole corpus: record index, then decode_records
+ */
+void bench_record_index(AsterixDecoder& decoder, const std::vector<uint8_t>& corpus, size_t iterations) {
+    std::vector<RecordSpan> records;
+    double best_index = 0.0;
+    double best_decode = 0.0;
+
+    for (size_t it = 0; it < iterations; ++it) {
+        records.clear();
+        auto start = std::chrono::steady_clock::now();
+        decoder.index_records(corpus.data(), corpus.size(), records);
+        double index_elapsed = seconds_since(start);
+
+        start = std::chrono::steady_clock::now();
+        auto messages = decoder.decode_records(corpus.data(), records);
+        double decode_elapsed = seconds_since(start);
+
+        if (best_index == 0.0 || index_elapsed < best_index) best_index = index_elapsed;
+        if (best_decode == 0.0 || decode_elapsed < best_decode) best_decode = decode_elapsed;
+    }
+
+    size_t count = std::max<size_t>(records.size(), 1);
+    report("index_ns_per_record", best_index * 1e9 / count, "ns");
+    report("indexed_decode_ns_per_record", best_decode * 1e9 / count, "ns");
+    report("decode_threads", static_cast<double>(decoder.get_parallel_threads()), "threads");
+}
+
+/**
+ * @brief JSON export throughput on a decoded sample
+ */
+void bench_json(AsterixDecoder& decoder, const std::vector<uint8_t>& corpus) {
+    auto blocks = split_blocks(corpus);
+    std::vector<AsterixBlock> decoded;
+    for (size_t i = 0; i < std::min<size_t>(blocks.size(), 2000); ++i) {
+        decoded.push_back(decoder.decode_block(corpus.data() + blocks[i].first, blocks[i].second));
+    }
+
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& block : decoded) {
+        bytes += utils::to_json(block).size();
+    }
+    double elapsed = seconds_since(start);
+
+    report("json_mb_per_sec", bytes / elapsed / 1e6, "MB/s");
+}
+
+/**
+ * @brief CBOR and MessagePack output against to_json on the same records
+ */
+void bench_binary_output(AsterixDecoder& decoder, const std::vector<uint8_t>& corpus) {
+    auto blocks = split_blocks(corpus);
+    std::vector<AsterixBlock> decoded;
+    size_t records = 0;
+    for (size_t i = 0; i < std::min<size_t>(blocks.size(), 2000); ++i) {
+        decoded.push_back(decoder.decode_block(corpus.data() + blocks[i].first, blocks[i].second));
+        records += decoded.back().messages.size();
+    }
+    records = std::max<size_t>(records, 1);
+
+    size_t json_bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& block : decoded) {
+        for (const auto& message : block.messages) {
+            json_bytes += utils::to_json(message).size();
+        }
+    }
+    double json_elapsed = seconds_since(start);
+    report("json_ns_per_record", json_elapsed * 1e9 / records, "ns");
+    report("json_bytes_per_record", static_cast<double>(json_bytes) / records, "B");
+
+    auto run = [&](const std::string& name, BinaryFormat format, KeyMode keys) {
+        BinarySerializer serializer(format, keys);
+        size_t bytes = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (const auto& block : decoded) {
+            serializer.write(block);
+            bytes += serializer.size();
+            serializer.clear();
+        }
+        double elapsed = seconds_since(begin);
+        report(name + "_ns_per_record", elapsed * 1e9 / records, "ns");
+        report(name + "_bytes_per_record", static_cast<double>(bytes) / records, "B");
+    };
+
+    run("cbor", BinaryFormat::CBOR, KeyMode::INTEGER);
+    run("msgpack", BinaryFormat::MSGPACK, KeyMode::INTEGER);
+    run("msgpack_strkeys", BinaryFormat::MSGPACK, KeyMode::STRING);
+}
+
+/**
+ * @brief CBOR output to a file: time spent on the decoding thread with
+ * synchronous writes and with the asynchronous writer
+ */
+void bench_async_writer(AsterixDecoder& decoder, const std::vector<uint8_t>& corpus) {
+    auto blocks = split_blocks(corpus);
+    std::vector<AsterixBlock> decoded;
+    size_t records = 0;
+    for (const auto& block : blocks) {
+        decoded.push_back(decoder.decode_block(corpus.data() + block.first, block.second));
+        records += decoded.back().messages.size();
+    }
+    records = std::max<size_t>(records, 1);
+    const std::string path = "skydecoder_bench_output.tmp";
+
+    BinarySerializer sync_serializer(BinaryFormat::CBOR);
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        for (const auto& block : decoded) {
+            sync_serializer.write(block);
+            out.write(reinterpret_cast<const char*>(sync_serializer.buffer().data()),
+                      static_cast<std::streamsize>(sync_serializer.size()));
+            sync_serializer.clear();
+        }
+        out.flush();
+    }
+    report("sync_write_ns_per_record", seconds_since(start) * 1e9 / records, "ns");
+
+    BinarySerializer async_serializer(BinaryFormat::CBOR);
+    AsyncWriterOptions options;
+    options.buffer_size = 256 << 10;
+    AsyncFileWriter out(options);
+    out.open(path);
+    start = std::chrono::steady_clock::now();
+    for (const auto& block : decoded) {
+        async_serializer.write(block);
+        out.write(async_serializer.buffer());
+        async_serializer.clear();
+    }
+    double caller = seconds_since(start);
+    AsyncWriterStats stats = out.stats();
+    out.close();
+    std::remove(path.c_str());
+
+    report("async_write_ns_per_record", caller * 1e9 / records, "ns");
+    report("async_write_waits", static_cast<double>(stats.producer_waits), "waits");
+    report("async_write_wait_us", stats.wait_ns / 1e3, "us");
+}
+
+/**
+ * @brief Flat record layout: decode and convert, convert alone, then read every field in place
+ */
+void bench_flat_records(AsterixDecoder& decoder, const std::vector<uint8_t>& corpus, size_t iterations) {
+    auto blocks = split_blocks(corpus);
+    FlatRecordWriter writer;
+    double best_write = 0.0;
+    double best_append = 0.0;
+    double best_read = 0.0;
+    uint64_t checksum = 0;
+
+    std::vector<AsterixBlock> decoded;
+    for (const auto& block : blocks) {
+        decoded.push_back(decoder.decode_block(corpus.data() + block.first, block.second));
+    }
+
+    for (size_t it = 0; it < iterations; ++it) {
+        writer.clear();
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& block : blocks) {
+            decoder.decode_block_flat(corpus.data() + block.first, block.second, writer);
+        }
+        double write_elapsed = seconds_since(start);
+
+        writer.clear();
+        start = std::chrono::steady_clock::now();
+        for (const auto& block : decoded) {
+            writer.append(block);
+        }
+        double append_elapsed = seconds_since(start);
+
+        start = std::chrono::steady_clock::now();
+        const auto& buffer = writer.buffer();
+        for_each_flat_record(buffer.data(), buffer.size(), [&](const FlatRecordView& record) {
+            for (size_t i = 0; i < record.item_count(); ++i) {
+                FlatItemView item = record.item(i);
+                for (size_t f = 0; f < item.field_count(); ++f) {
+                    checksum += item.field(f).as_unsigned();
+                }
+            }
+        });
+        double read_elapsed = seconds_since(start);
+
+        if (best_write == 0.0 || write_elapsed < best_write) best_write = write_elapsed;
+        if (best_append == 0.0 || append_elapsed < best_append) best_append = append_elapsed;
+        if (best_read == 0.0 || read_elapsed < best_read) best_read = read_elapsed;
+    }
+
+    size_t records = std::max<size_t>(writer.record_count(), 1);
+    report("flat_decode_ns_per_record", best_write * 1e9 / records, "ns");
+    report("flat_append_ns_per_record", best_append * 1e9 / records, "ns");
+    report("flat_read_ns_per_record", best_read * 1e9 / records, "ns");
+    report("flat_bytes_per_record", static_cast<double>(writer.buffer().size()) / records, "B");
+    if (checksum == 0) {
+        std::cout << "flat records read nothing" << std::endl;
+    }
+}
+
+/**
+ * @brief Group decoded records into sector batches
+ */
+void bench_scan_assembler(AsterixDecoder& decoder, const std::vector<uint8_t>& corpus) {
+    auto blocks = split_blocks(corpus);
+    std::vector<AsterixBlock> decoded;
+    size_t records = 0;
+    for (const auto& block : blocks) {
+        decoded.push_back(decoder.decode_block(corpus.data() + block.first, block.second));
+        records += decoded.back().messages.size();
+    }
+    records = std::max<size_t>(records, 1);
+
+    size_t batched_records = 0;
+    ScanAssembler assembler([&](const ScanBatch& batch) { batched_records += batch.records.record_count(); });
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& block : decoded) {
+        assembler.add(block);
+    }
+    assembler.flush();
+    double elapsed = seconds_since(start);
+
+    report("scan_assembler_ns_per_record", elapsed * 1e9 / records, "ns");
+    report("scan_batches", static_cast<double>(assembler.batches_emitted()), "batches");
+    if (batched_records != records) {
+        std::cout << "scan assembler lost records: " << batched_records << " of " << records << std::endl;
+    }
+}
+
+/**
+ * @brief Per radar and message type, per minute: count and antenna rotation
+ * period, from full decodes and from lazy records (projection); both timings
+ * include the decode
+ */
+void bench_window_aggregator(AsterixDecoder& decoder, const std::vector<uint8_t>& corpus) {
+    const AsterixCategory* category = decoder.get_category_definition(2);
+    if (!category) {
+        return;
+    }
+
+    WindowOptions options;
+    options.size = 60.0;
+    options.group_by = {{"I002/010", "SAC"}, {"I002/010", "SIC"}, {"I002/000", "MESSAGE_TYPE"}};
+    options.aggregates = {{AggregateKind::COUNT, {}},
+                          {AggregateKind::AVG, {"I002/041", "ARP"}},
+                          {AggregateKind::MAX, {"I002/041", "ARP"}}};
+
+    auto blocks = split_blocks(corpus);
+    size_t records = 0;
+
+    double eager_total = 0.0;
+    WindowAggregator eager(*category, [&](const WindowResult& result) { eager_total += (*result.values)[0]; }, options);
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& block : blocks) {
+        AsterixBlock decoded = decoder.decode_block(corpus.data() + block.first, block.second);
+        records += decoded.messages.size();
+        eager.add(decoded);
+    }
+    eager.flush();
+    double eager_elapsed = seconds_since(start);
+    records = std::max<size_t>(records, 1);
+
+    double lazy_total = 0.0;
+    WindowAggregator projected(*category, [&](const WindowResult& result) { lazy_total += (*result.values)[0]; }, options);
+    std::vector<LazyRecord> lazy;
+    start = std::chrono::steady_clock::now();
+    for (const auto& block : blocks) {
+        lazy.clear();
+        decoder.decode_block_lazy(corpus.data() + block.first, block.second, lazy);
+        for (auto& record : lazy) {
+            projected.add(record);
+        }
+    }
+    projected.flush();
+    double lazy_elapsed = seconds_since(start);
+
+    report("window_ns_per_record", eager_elapsed * 1e9 / records, "ns");
+    report("window_lazy_ns_per_record", lazy_elapsed * 1e9 / records, "ns");
+    report("window_results", static_cast<double>(eager.stats().results_emitted), "results");
+    if (eager_total != lazy_total || eager_total != static_cast<double>(eager.stats().aggregated)) {
+        std::cout << "window aggregator mismatch: " << eager_total << " eager, " << lazy_total << " lazy, "
+                  << eager.stats().aggregated << " aggregated" << std::endl;
+    }
+}
+
+/**
+ * @brief Correlate plots of 40 radars with their CAT002 sectors
+ *
+ * Each radar sends 32 sector markers per 4 s scan and 50 CAT048 plots per
+ * sector, delivered after the marker that closes their sector.
+ */
+void bench_scan_correlator() {
+    constexpr int kRadars = 40;
+    constexpr int kScans = 10;
+    constexpr int kSectors = 32;
+    constexpr int kPlotsPerSector = 50;
+    constexpr double kSectorTime = 4.0 / kSectors;
+
+    auto make_field = [](const char* name, FieldValue value) {
+        ParsedField field;
+        field.name = name;
+        field.value = value;
+        return field;
+    };
+    auto make_message = [&](uint8_t category, uint16_t radar) {
+        AsterixMessage message;
+        message.category = category;
+        ParsedDataItem source;
+        source.id = category == 2 ? "I002/010" : "I048/010";
+        source.fields.push_back(make_field("SAC", FieldValue::from_unsigned(radar >> 8, 1)));
+        source.fields.push_back(make_field("SIC", FieldValue::from_unsigned(radar & 0xFF, 1)));
+        message.data_items.push_back(source);
+        return message;
+    };
+
+    std::vector<AsterixMessage> markers;
+    std::vector<AsterixMessage> plots;
+    for (int r = 0; r < kRadars; ++r) {
+        uint16_t radar = static_cast<uint16_t>(0x1000 + r);
+        markers.push_back(make_message(2, radar));
+        for (const char* id : {"I002/000", "I002/020", "I002/030"}) {
+            ParsedDataItem item;
+            item.id = id;
+            item.fields.push_back(make_field("VALUE", FieldValue::from_unsigned(0, 4)));
+            markers.back().data_items.push_back(item);
+        }
+        plots.push_back(make_message(48, radar));
+        ParsedDataItem time;
+        time.id = "I048/140";
+        time.fields.push_back(make_field("ToD", FieldValue::from_unsigned(0, 4)));
+        plots.back().data_items.push_back(time);
+    }
+
+    uint64_t summaries = 0;
+    uint64_t summarized = 0;
+    ScanCorrelator correlator([&](const ScanSummary& summary) {
+        summaries++;
+        summarized += summary.plots + summary.tracks;
+    });
+
+    size_t records = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step <= kScans * kSectors; ++step) {
+        double time = 1000.0 + step * kSectorTime;
+        for (int r = 0; r < kRadars; ++r) {
+            AsterixMessage& marker = markers[r];
+            marker.data_items[1].fields[0].value = FieldValue::from_unsigned(step % kSectors == 0 ? 1 : 2, 1);
+            marker.data_items[2].fields[0].value = FieldValue::from_unsigned((step % kSectors) * 8, 1);
+            marker.data_items[3].fields[0].value = FieldValue::from_unsigned(static_cast<uint64_t>(time * 128.0), 4);
+            correlator.add(marker);
+
+            AsterixMessage& plot = plots[r];
+            for (int p = 0; p < kPlotsPerSector && step > 0; ++p) {
+                double plot_time = time - kSectorTime + p * kSectorTime / kPlotsPerSector;
+                plot.data_items[1].fields[0].value = FieldValue::from_unsigned(static_cast<uint64_t>(plot_time * 128.0), 4);
+                correlator.add(plot);
+                records++;
+            }
+        }
+    }
+    correlator.flush();
+    double elapsed = seconds_since(start);
+
+    CorrelatorStats stats = correlator.stats();
+    report("correlator_ns_per_record", elapsed * 1e9 / std::max<size_t>(records, 1), "ns");
+    report("correlator_records_per_sec", records / elapsed, "records/s");
+    report("correlator_scan_summaries", static_cast<double>(summaries), "scans");
+    if (stats.matched != summarized || stats.matched + stats.too_old + stats.unmatched != records) {
+        std::cout << "scan correlator lost records: " << summarized << " summarised, " << stats.matched
+                  << " matched of " << records << std::endl;
+    }
+}
+
+/**
+ * @brief Decode statistics with sketches, split over two halves and merged
+ */
+void bench_statistics(AsterixDecoder& decoder, const std::vector<uint8_t>& corpus) {
+    auto blocks = split_blocks(corpus);
+    std::vector<AsterixBlock> decoded;
+    size_t records = 0;
+    for (const auto& block : blocks) {
+        decoded.push_back(decoder.decode_block(corpus.data() + block.first, block.second));
+        records += decoded.back().messages.size();
+    }
+    records = std::max<size_t>(records, 1);
+
+    utils::MessageStatistics halves[2];
+    size_t index = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& block : decoded) {
+        for (const auto& message : block.messages) {
+            utils::accumulate_statistics(halves[index++ & 1], message);
+        }
+    }
+    utils::merge_statistics(halves[0], halves[1]);
+    double elapsed = seconds_since(start);
+
+    report("statistics_ns_per_record", elapsed * 1e9 / records, "ns");
+    report("statistics_distinct_radars", halves[0].radars.estimate(), "radars");
+    report("statistics_fspec_patterns", static_cast<double>(halves[0].fspec_patterns.top(64).size()), "patterns");
+}
+
+/**
+ * @brief Output of the three kernels of the active ISA on edge-case inputs
+ *
+ * Every input length from 0 to 3 vectors of 64 bytes plus one covers the
+ * tails and odd lengths of the 16, 32 and 64-byte loops; FSPECs end at each
+ * of these positions, so their FX chain crosses every vector boundary, and
+ * are cut before, at and after the terminating byte. Inputs are copied to
+ * exact-size buffers so that an over-read shows up under a sanitizer.
+ */
+struct KernelResults {
+    std::vector<std::string> hex;
+    std::vector<std::vector<uint8_t>> codes;
+    std::vector<size_t> fspec_lengths;
+};
+
+constexpr size_t kKernelCheckBytes = 3 * 64 + 1;
+
+KernelResults run_kernel_checks() {
+    std::mt19937 rng(77);
+    std::vector<uint8_t> random(kKernelCheckBytes + 8);
+    for (auto& byte : random) {
+        byte = static_cast<uint8_t>(rng());
+    }
+
+    KernelResults results;
+    for (size_t size = 0; size <= kKernelCheckBytes; ++size) {
+        std::vector<uint8_t> data(random.begin(), random.begin() + size);
+        results.hex.push_back(utils::to_hex_string(data));
+        results.codes.push_back(utils::unpack_6bit(data));
+    }
+
+    for (size_t last = 0; last < kKernelCheckBytes; ++last) {
+        std::vector<uint8_t> fspec(random);
+        for (size_t i = 0; i < last; ++i) {
+            fspec[i] |= 0x01;
+        }
+        fspec[last] &= 0xFE;
+        for (size_t size : {last, last + 1, last + 8}) {
+            std::vector<uint8_t> data(fspec.begin(), fspec.begin() + size);
+            results.fspec_lengths.push_back(utils::fspec_length(data.data(), data.size()));
+        }
+    }
+    return results;
+}
+
+/**
+ * @brief Time each kernel variant and check all three agree with the scalar ones
+ */
+bool bench_kernels(const std::vector<uint8_t>& corpus) {
+    IsaLevel initial = active_isa();
+    std::vector<uint8_t> sample(corpus.begin(), corpus.begin() + std::min<size_t>(corpus.size(), 1 << 20));
+
+    force_isa(IsaLevel::SCALAR);
+    std::string reference = utils::to_hex_string(sample);
+    KernelResults reference_checks = run_kernel_checks();
+    bool consistent = true;
+
+    // The FSPEC ends at its last byte, or is unterminated when cut before it
+    for (size_t i = 0; i < reference_checks.fspec_lengths.size(); ++i) {
+        size_t last = i / 3;
+        size_t expected = i % 3 == 0 ? 0 : last + 1;
+        if (reference_checks.fspec_lengths[i] != expected) {
+            std::cerr << "Scalar fspec_length is " << reference_checks.fspec_lengths[i]
+                      << " for an FSPEC of " << expected << " bytes" << std::endl;
+            consistent = false;
+            break;
+        }
+    }
+
+    for (IsaLevel level : supported_isa_levels()) {
+        force_isa(level);
+
+        KernelResults checks = run_kernel_checks();
+        for (size_t size = 0; size <= kKernelCheckBytes; ++size) {
+            if (checks.hex[size] != reference_checks.hex[size]) {
+                std::cerr << "to_hex_string mismatch for " << to_string(level) << " at " << size << " bytes" << std::endl;
+                consistent = false;
+            }
+            if (checks.codes[size] != reference_checks.codes[size]) {
+                std::cerr << "unpack_6bit mismatch for " << to_string(level) << " at " << size << " bytes" << std::endl;
+                consistent = false;
+            }
+        }
+        for (size_t i = 0; i < checks.fspec_lengths.size(); ++i) {
+            if (checks.fspec_lengths[i] != reference_checks.fspec_lengths[i]) {
+                std::cerr << "fspec_length mismatch for " << to_string(level) << " with the last FX at byte "
+                          << i / 3 << std::endl;
+                consistent = false;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::string hex;
+        for (int i = 0; i < 10; ++i) {
+            hex = utils::to_hex_string(sample);
+        }
+        double elapsed = seconds_since(start);
+
+        report("hex_" + to_string(level) + "_mb_per_sec", 10.0 * sample.size() / elapsed / 1e6, "MB/s");
+
+        if (hex != reference) {
+            std::cerr << "Kernel mismatch for " << to_string(level) << std::endl;
+            consistent = false;
+        }
+    }
+
+    force_isa(initial);
+    return consistent;
+}
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]" << std::endl;
+    std::cout << "  --categories=<dir>       Category definitions (default: " << SKYDECODER_DATA_DIR << ")" << std::endl;
+    std::cout << "  --corpus=<file>          Decode a recording instead of the synthetic corpus" << std::endl;
+    std::cout << "  --write-corpus=<file>    Save the synthetic corpus and exit" << std::endl;
+    std::cout << "  --blocks=<N>             Synthetic corpus size in blocks (default: 20000)" << std::endl;
+    std::cout << "  --iterations=<N>         Decode passes, best one is reported (default: 5)" << std::endl;
+    std::cout << "  --force-isa=<level>      scalar, sse4.2, avx2 or avx512" << std::endl;
+    std::cout << "  --no-plan-cache          Resolve every FSPEC from scratch" << std::endl;
+    std::cout << "  --specialize             Specialise hot FSPEC patterns of CAT002" << std::endl;
+    std::cout << "  --threads=<N>            Worker threads for the indexed decode (default: 1)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+
+            if (arg.rfind("--categories=", 0) == 0) {
+                options.categories_dir = arg.substr(13);
+            } else if (arg.rfind("--corpus=", 0) == 0) {
+                options.corpus_file = arg.substr(9);
+            } else if (arg.rfind("--write-corpus=", 0) == 0) {
+                options.write_corpus = arg.substr(15);
+            } else if (arg.rfind("--blocks=", 0) == 0) {
+                options.blocks = std::stoul(arg.substr(9));
+            } else if (arg.rfind("--iterations=", 0) == 0) {
+                options.iterations = std::max<size_t>(1, std::stoul(arg.substr(13)));
+            } else if (arg == "--no-plan-cache") {
+                options.plan_cache = false;
+            } else if (arg == "--specialize") {
+                options.specialize = true;
+            } else if (arg.rfind("--threads=", 0) == 0) {
+                options.threads = std::stoul(arg.substr(10));
+            } else if (arg.rfind("--force-isa=", 0) == 0) {
+                if (!force_isa(isa_from_string(arg.substr(12)))) {
+                    std::cerr << "ISA " << arg.substr(12) << " is not available on this build/CPU" << std::endl;
+                    return 1;
+                }
+            } else {
+                print_usage(argv[0]);
+                return arg == "--help" ? 0 : 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid option: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<uint8_t> corpus;
+    if (!options.corpus_file.empty()) {
+        std::ifstream file(options.corpus_file, std::ios::binary);
+        if (!file) {
+            std::cerr << "Cannot open corpus: " << options.corpus_file << std::endl;
+            return 1;
+        }
+        corpus.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    } else {
+        corpus = generate_cat002_corpus(options.blocks);
+    }
+
+    if (!options.write_corpus.empty()) {
+        std::ofstream out(options.write_corpus, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(corpus.data()), corpus.size());
+        std::cout << "Wrote " << corpus.size() << " bytes to " << options.write_corpus << std::endl;
+        return out ? 0 : 1;
+    }
+
+    AsterixDecoder decoder;
+    decoder.set_plan_cache_enabled(options.plan_cache);
+    decoder.set_specialization(2, options.specialize);
+    decoder.set_parallel_decoding(options.threads);
+    if (!decoder.load_categories_from_directory(options.categories_dir)) {
+        std::cerr << "Failed to load category definitions from " << options.categories_dir << std::endl;
+        return 1;
+    }
+
+    std::cout << "Corpus: " << corpus.size() << " bytes, "
+              << split_blocks(corpus).size() << " blocks" << std::endl;
+    std::cout << "Kernels: " << to_string(active_isa()) << std::endl;
+
+    bench_decode(decoder, corpus, options.iterations);
+    bench_lazy(decoder, corpus, options.iterations);
+    bench_record_index(decoder, corpus, options.iterations);
+    bench_json(decoder, corpus);
+    bench_binary_output(decoder, corpus);
+    bench_async_writer(decoder, corpus);
+    bench_flat_records(decoder, corpus, options.iterations);
+    bench_scan_assembler(decoder, corpus);
+    bench_scan_correlator();
+    bench_window_aggregator(decoder, corpus);
+    bench_statistics(decoder, corpus);
+
+    if (!bench_kernels(corpus)) {
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <skydecoder/asterix_decoder.h>
 #include <skydecoder/utils.h>
+#include <skydecoder/delta_filter.h>
 #include <iostream>
 #include <iomanip>
 #include <vector>
@@ -359,7 +360,7 @@ private:
         bool valid = true;
         
         // Check SAC
-        auto sac_value = std::get<uint8_t>(item.fields[0].value);
+        auto sac_value = static_cast<uint8_t>(item.fields[0].value.as_unsigned());
         std::string expected_sac = reference.fields[0].second; // "0x00"
         uint8_t expected_sac_val = std::stoi(expected_sac, nullptr, 16);
         
@@ -370,7 +371,7 @@ private:
         }
         
         // Check SIC
-        auto sic_value = std::get<uint8_t>(item.fields[1].value);
+        auto sic_value = static_cast<uint8_t>(item.fields[1].value.as_unsigned());
         std::string expected_sic = reference.fields[1].second; // "0x10"
         uint8_t expected_sic_val = std::stoi(expected_sic, nullptr, 16);
         
@@ -399,7 +400,7 @@ private:
             return false;
         }
         
-        auto msg_type = std::get<uint8_t>(item.fields[0].value);
+        auto msg_type = static_cast<uint8_t>(item.fields[0].value.as_unsigned());
         std::string expected_type = reference.fields[0].second;
         uint8_t expected_type_val = std::stoi(expected_type, nullptr, 16);
         
@@ -435,7 +436,7 @@ private:
             return false;
         }
         
-        auto sector = std::get<uint8_t>(item.fields[0].value);
+        auto sector = static_cast<uint8_t>(item.fields[0].value.as_unsigned());
         std::string expected_sector = reference.fields[0].second;
         uint8_t expected_sector_val = std::stoi(expected_sector, nullptr, 16);
         
@@ -464,18 +465,12 @@ private:
             return false;
         }
         
-        // Handle different possible value types
-        uint32_t tod_raw = 0;
-        if (std::holds_alternative<uint32_t>(item.fields[0].value)) {
-            tod_raw = std::get<uint32_t>(item.fields[0].value);
-        } else if (std::holds_alternative<uint16_t>(item.fields[0].value)) {
-            tod_raw = std::get<uint16_t>(item.fields[0].value);
-        } else if (std::holds_alternative<uint8_t>(item.fields[0].value)) {
-            tod_raw = std::get<uint8_t>(item.fields[0].value);
-        } else {
+        // Any unsigned width is accepted
+        if (item.fields[0].value.kind() != FieldValue::Kind::UNSIGNED) {
             std::cout << "Unsupported data type for Time of Day" << std::endl;
             return false;
         }
+        uint32_t tod_raw = static_cast<uint32_t>(item.fields[0].value.as_unsigned());
         
         std::string expected_tod = reference.fields[0].second;
         uint32_t expected_tod_val = std::stoi(expected_tod, nullptr, 16);
@@ -517,7 +512,7 @@ private:
             return false;
         }
         
-        auto arp_raw = std::get<uint16_t>(item.fields[0].value);
+        auto arp_raw = static_cast<uint16_t>(item.fields[0].value.as_unsigned());
         std::string expected_arp = reference.fields[0].second;
         uint16_t expected_arp_val = std::stoi(expected_arp, nullptr, 16);
         
@@ -560,28 +555,19 @@ private:
                     std::cout << "  • " << field.name << ": ";
                     
                     // Display value with proper formatting
-                    std::visit([&](const auto& value) {
-                        using T = std::decay_t<decltype(value)>;
-                        if constexpr (std::is_same_v<T, uint8_t>) {
-                            std::cout << "0x" << std::hex << std::setfill('0') << std::setw(2)
-                                      << static_cast<int>(value) << std::dec 
-                                      << " (" << static_cast<int>(value) << ")";
-                        } else if constexpr (std::is_same_v<T, uint16_t>) {
-                            std::cout << "0x" << std::hex << std::setfill('0') << std::setw(4)
-                                      << static_cast<int>(value) << std::dec 
-                                      << " (" << static_cast<int>(value) << ")";
-                        } else if constexpr (std::is_same_v<T, uint32_t>) {
-                            std::cout << "0x" << std::hex << std::setfill('0') << std::setw(8)
-                                      << static_cast<int>(value) << std::dec 
-                                      << " (" << static_cast<int>(value) << ")";
-                        } else if constexpr (std::is_same_v<T, bool>) {
-                            std::cout << (value ? "true" : "false");
-                        } else if constexpr (std::is_same_v<T, std::string>) {
-                            std::cout << "\"" << value << "\"";
-                        } else {
-                            std::cout << "unknown_type";
-                        }
-                    }, field.value);
+                    const FieldValue& value = field.value;
+                    if (value.kind() == FieldValue::Kind::UNSIGNED) {
+                        // Hex digits follow the width of the decoded type
+                        std::cout << "0x" << std::hex << std::setfill('0') << std::setw(value.width() * 2)
+                                  << value.as_unsigned() << std::dec 
+                                  << " (" << value.as_unsigned() << ")";
+                    } else if (value.kind() == FieldValue::Kind::BOOL) {
+                        std::cout << (value.as_bool() ? "true" : "false");
+                    } else if (value.kind() == FieldValue::Kind::STRING) {
+                        std::cout << "\"" << value.as_string() << "\"";
+                    } else {
+                        std::cout << "unknown_type";
+                    }
                     
                     if (!field.description.empty()) {
                         std::cout << " - " << field.description;
@@ -597,6 +583,124 @@ private:
     }
 };
 
+/**
+ * @brief A VARIABLE item whose record stops the FX chain after octet 1
+ *
+ * The fields of the second octet must not be read (past the item, here past
+ * the buffer), so the item's layout must not be marked verified.
+ */
+bool check_truncated_variable_item() {
+    std::cout << "\n=== TRUNCATED VARIABLE ITEM ===" << std::endl;
+    
+    const std::string definition = R"(<?xml version="1.0" encoding="UTF-8"?>
+<asterix_category>
+    <header><category>048</category><name>Variable item check</name></header>
+    <user_application_profile><uap_items><item>I048/020</item></uap_items></user_application_profile>
+    <data_items>
+        <data_item id="I048/020">
+            <name>Target Report Descriptor</name>
+            <format>variable</format>
+            <structure>
+                <field name="TYP" type="uint3" bits="3"/>
+                <field name="SIM" type="bool" bits="1"/>
+                <field name="RDP" type="bool" bits="1"/>
+                <field name="SPI" type="bool" bits="1"/>
+                <field name="RAB" type="bool" bits="1"/>
+                <field name="FX" type="bool" bits="1"/>
+                <field name="TST" type="bool" bits="1"/>
+                <field name="ERR" type="bool" bits="1"/>
+                <field name="XPP" type="bool" bits="1"/>
+                <field name="ME" type="bool" bits="1"/>
+                <field name="MI" type="bool" bits="1"/>
+                <field name="FOE" type="uint2" bits="2"/>
+                <field name="FX2" type="bool" bits="1"/>
+            </structure>
+        </data_item>
+    </data_items>
+</asterix_category>)";
+    
+    AsterixDecoder decoder;
+    if (!decoder.load_category_definition_from_string(definition)) {
+        std::cout << "Cannot load the test definition" << std::endl;
+        return false;
+    }
+    
+    const AsterixCategory* category = decoder.get_category_definition(48);
+    bool verified = category->data_items.at("I048/020").verified;
+    std::cout << "I048/020 verified: " << (verified ? "yes" : "no") << std::endl;
+    
+    // FSPEC 0x80, I048/020 octet 1 with FX=0, end of the block
+    std::vector<uint8_t> block_data = {0x30, 0x00, 0x05, 0x80, 0x20};
+    AsterixBlock block = decoder.decode_block(block_data);
+    
+    bool read_past_item = false;
+    for (const auto& message : block.messages) {
+        for (const auto& item : message.data_items) {
+            for (const auto& field : item.fields) {
+                if (item.valid && field.valid && field.name == "TST") {
+                    read_past_item = true;
+                }
+            }
+        }
+    }
+    
+    bool passed = !verified && !read_past_item;
+    std::cout << "Truncated VARIABLE item check: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+/**
+ * @brief Status changes the CAT002 definition does not decode must pass the delta filter
+ *
+ * I002/050 only defines FX, so every value below decodes to the same fields;
+ * the filter has to tell them apart on the item bytes, on both paths.
+ */
+bool check_delta_status_changes() {
+    std::cout << "\n=== DELTA FILTER STATUS CHANGES ===" << std::endl;
+    
+    AsterixDecoder decoder;
+    if (!decoder.load_category_definition("../data/asterix_categories/cat02.xml") &&
+        !decoder.load_category_definition("data/asterix_categories/cat02.xml") &&
+        !decoder.load_category_definition("cat02.xml")) {
+        std::cout << "CAT002 definition not found" << std::endl;
+        return false;
+    }
+    decoder.set_keep_item_bytes(true);
+    
+    // One north marker per block: FSPEC 0xC4 (I002/010, I002/000, I002/050)
+    const uint8_t status[] = {0x10, 0x20, 0x40, 0x42, 0x80, 0x82};
+    
+    DeltaOptions options;
+    options.keyframe_interval = 0;
+    DeltaFilter message_filter(options);
+    DeltaFilter lazy_filter(options);
+    
+    for (uint8_t value : status) {
+        std::vector<uint8_t> block_data = {0x02, 0x00, 0x08, 0xC4, 0x01, 0x02, 0x01, value};
+        
+        AsterixBlock block = decoder.decode_block(block_data);
+        for (auto& message : block.messages) {
+            message_filter.filter(message);
+        }
+        
+        std::vector<LazyRecord> records;
+        decoder.decode_block_lazy(block_data.data(), block_data.size(), records);
+        for (const auto& record : records) {
+            lazy_filter.filter(record);
+        }
+    }
+    
+    const DeltaStats& messages = message_filter.stats();
+    const DeltaStats& lazy = lazy_filter.stats();
+    std::cout << "Changes (messages / lazy): " << messages.items_changed
+              << " / " << lazy.items_changed << " of " << sizeof(status) << std::endl;
+    
+    bool passed = messages.items_changed == sizeof(status) && lazy.items_changed == sizeof(status) &&
+                  messages.items_without_bytes == 0;
+    std::cout << "Delta filter status check: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
 int main() {
     AsterixCAT002TestValidator validator;
     
@@ -607,6 +711,11 @@ int main() {
     
     validator.run_test();
     
+    if (!check_truncated_variable_item() || !check_delta_status_changes()) {
+        std::cout << "SOME VALIDATIONS FAILED" << std::endl;
+        return 1;
+    }
+    
     std::cout << "\n=== TEST COMPLETED ===" << std::endl;
     return 0;
 }
\ No newline at end of file
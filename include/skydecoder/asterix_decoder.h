@@ -2,6 +2,15 @@
 
 #include "skydecoder/asterix_types.h"
 #include "skydecoder/xml_parser.h"
+#include "skydecoder/numa_buffer.h"
+#include "skydecoder/static_category.h"
+#include "skydecoder/fspec_plan_cache.h"
+#include "skydecoder/lazy_record.h"
+#include "skydecoder/flat_record.h"
+#include "skydecoder/worker_pool.h"
+#include "skydecoder/layout_verifier.h"
+#include "skydecoder/range_checker.h"
+#include <bitset>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -9,6 +18,8 @@
 
 namespace skydecoder {
 
+class QuarantineSink;
+
 // Structure for record statistics
 struct RecordStatistics {
     size_t total_records = 0;
@@ -18,7 +29,14 @@ struct RecordStatistics {
     std::vector<size_t> record_lengths;
 };
 
-class AsterixDecoder {
+// Location of a record inside a buffer of one or more blocks
+struct RecordSpan {
+    uint64_t offset;            // Buffers may exceed 4 GiB (mapped recordings)
+    uint16_t length;
+    uint8_t category;
+};
+
+class SKYDECODER_API AsterixDecoder {
 public:
     AsterixDecoder();
     ~AsterixDecoder();
@@ -32,8 +50,35 @@ public:
     // Load all definitions from a directory
     bool load_categories_from_directory(const std::string& directory);
     
-    // Decode a complete ASTERIX block (with multi-record support)
+    // Load a definition compiled into the binary (replaces an XML-loaded one of the same category);
+    // it is converted to an AsterixCategory, so records decode exactly as with its XML
+    bool load_static_category(const StaticCategory& definition);
+    
+    // Decode a complete ASTERIX block (with multi-record support); the offset
+    // of the block in its stream only goes to the quarantine
     AsterixBlock decode_block(const std::vector<uint8_t>& data);
+    AsterixBlock decode_block(const uint8_t* data, size_t size, uint64_t offset = kUnknownOffset);
+    
+    // Index the records of a block without decoding any field; items are decoded
+    // on access. The block bytes must outlive the records.
+    bool decode_block_lazy(const uint8_t* data, size_t size, std::vector<LazyRecord>& records);
+    
+    // Decode a block and append its records to the writer in the flat layout,
+    // ready to be handed to another thread or process as raw bytes. The block is
+    // decoded as by decode_block() first; the conversion is an extra pass.
+    bool decode_block_flat(const uint8_t* data, size_t size, FlatRecordWriter& writer);
+    
+    // Boundary pass: locate every record of the blocks in a buffer (one block or
+    // several concatenated ones) from FSPECs and item length rules alone
+    bool index_records(const uint8_t* data, size_t size, std::vector<RecordSpan>& records);
+    
+    // Decode indexed records, across the worker pool when there is one
+    std::vector<AsterixMessage> decode_records(const uint8_t* data, const std::vector<RecordSpan>& records);
+    
+    // Decode the records of CAT002 blocks of at least min_block_size bytes on a
+    // pool of threads (placed per the memory options); threads <= 1 disables it
+    void set_parallel_decoding(size_t threads, size_t min_block_size = 4096);
+    size_t get_parallel_threads() const { return worker_pool_ ? worker_pool_->size() : 1; }
     
     // Decode an individual ASTERIX message
     AsterixMessage decode_message(uint8_t category, const std::vector<uint8_t>& data);
@@ -56,26 +101,70 @@ public:
     // Utilities
     std::vector<uint8_t> get_supported_categories() const;
     const AsterixCategory* get_category_definition(uint8_t category) const;
+    // Same, shared: outlives a reload of the definition (null if not loaded)
+    std::shared_ptr<const AsterixCategory> share_category_definition(uint8_t category) const;
     
     // Configuration
     void set_strict_validation(bool strict) { strict_validation_ = strict; }
     void set_debug_mode(bool debug) { debug_mode_ = debug; }
     
+    // Layout verification of the definitions loaded from now on (REPAIR by default)
+    void set_layout_policy(LayoutPolicy policy) { layout_policy_ = policy; }
+    LayoutPolicy get_layout_policy() const { return layout_policy_; }
+    std::vector<LayoutIssue> get_layout_issues(uint8_t category) const;
+    
+    // Count decoded values outside the min/max or enum set of their field (off
+    // by default); applies to decode_block, violations leave records valid
+    void set_range_checks(bool enabled) { range_checks_enabled_ = enabled; }
+    bool is_range_checks_enabled() const { return range_checks_enabled_; }
+    std::vector<FieldCheck> get_range_check_stats(uint8_t category) const;
+    
+    // Keep a copy of every item's bytes in ParsedDataItem::raw (off by default;
+    // one arena copy per record), e.g. for DeltaFilter on decoded messages
+    void set_keep_item_bytes(bool enabled) { keep_item_bytes_ = enabled; }
+    bool is_keep_item_bytes_enabled() const { return keep_item_bytes_; }
+    
+    // Copy blocks that fail to decode (decode_block, decode_file) to the sink;
+    // nullptr disables it. The sink must outlive the decoding.
+    void set_quarantine(QuarantineSink* sink) { quarantine_ = sink; }
+    
+    // Huge page / NUMA placement of the buffers owned by the decoder
+    void set_memory_options(const MemoryOptions& options) { memory_options_ = options; }
+    const MemoryOptions& get_memory_options() const { return memory_options_; }
+    
+    // Per-category cache of resolved FSPEC layouts (enabled by default)
+    void set_plan_cache_enabled(bool enabled);
+    bool is_plan_cache_enabled() const { return plan_cache_enabled_; }
+    PlanCacheStats get_plan_cache_stats(uint8_t category) const;     // Includes the worker caches
+    
+    // Specialised decoders for FSPEC plans used more than the threshold (off by default,
+    // needs the plan cache); other records keep going through the interpreter
+    void set_specialization(uint8_t category, bool enabled);
+    bool is_specialization_enabled(uint8_t category) const { return specialization_enabled_[category]; }
+    void set_specialization_threshold(uint64_t uses) { specialization_threshold_ = uses; }
+    
 private:
     // Private methods for traditional decoding
-    AsterixMessage decode_message_internal(ParseContext& context);
-    std::vector<std::string> parse_uap_items(const std::vector<uint8_t>& fspec, 
-                                            const UserApplicationProfile& uap);
-    std::vector<uint8_t> parse_field_specification(ParseContext& context);
+    AsterixMessage decode_message_internal(ParseContext& context, FspecPlanCache* plan_cache);
+    size_t read_field_specification(ParseContext& context);
+    
+    // FSPEC plans
+    FspecPlan& resolve_fspec_plan(ParseContext& context, FspecPlanCache* plan_cache, FspecPlan& scratch);
+    void decode_plan_items(FspecPlan& plan, ParseContext& context, AsterixMessage& message);
+    FspecPlanCache* plan_cache_for(uint8_t category);
+    RangeChecker* range_checker_for(uint8_t category, const AsterixCategory& definition);
     
     // Private methods for multi-record decoding
-    void decode_multirecord_block(ParseContext& context, AsterixBlock& block);
-    void decode_traditional_block(ParseContext& context, AsterixBlock& block);
-    AsterixMessage decode_single_record(ParseContext& context);
+    void decode_multirecord_block(ParseContext& context, AsterixBlock& block, FspecPlanCache* plan_cache);
+    void decode_traditional_block(ParseContext& context, AsterixBlock& block, FspecPlanCache* plan_cache);
+    void decode_multirecord_block_parallel(ParseContext& context, AsterixBlock& block, FspecPlanCache* plan_cache);
+    bool index_block_records(const uint8_t* data, size_t begin, size_t end, const AsterixCategory& category,
+                             FspecPlanCache* plan_cache, std::vector<RecordSpan>& records);
+    FspecPlanCache* worker_plan_cache(size_t worker, uint8_t category);
+    AsterixMessage decode_single_record(ParseContext& context, FspecPlanCache* plan_cache);
     
-    // Utilities for multi-records
-    size_t calculate_record_length(const std::vector<std::string>& present_items, 
-                                  const AsterixCategory& category);
+    // Verify and register a definition, drop the plans cached for its previous version
+    uint8_t install_category(std::unique_ptr<AsterixCategory> category);
     
     // Validation
     bool validate_mandatory_fields(const AsterixMessage& message, const AsterixCategory& category);
@@ -87,12 +176,28 @@ private:
     void log_debug(const std::string& message);
     
     // Member data
-    std::unordered_map<uint8_t, std::unique_ptr<AsterixCategory>> categories_;
+    std::unordered_map<uint8_t, std::shared_ptr<AsterixCategory>> categories_;   // Shared with decoded messages
     std::unique_ptr<XmlParser> xml_parser_;
+    std::unordered_map<uint8_t, std::unique_ptr<FspecPlanCache>> plan_caches_;
+    std::unordered_map<uint8_t, std::vector<LayoutIssue>> layout_issues_;
+    std::unordered_map<uint8_t, std::unique_ptr<RangeChecker>> range_checkers_;
+    
+    // Parallel decoding; each worker resolves plans through its own caches
+    std::unique_ptr<WorkerPool> worker_pool_;
+    std::vector<std::unordered_map<uint8_t, std::unique_ptr<FspecPlanCache>>> worker_plan_caches_;
+    size_t parallel_min_block_size_ = 4096;
     
     // Configuration
     bool strict_validation_ = false;
     bool debug_mode_ = false;
+    MemoryOptions memory_options_;
+    LayoutPolicy layout_policy_ = LayoutPolicy::REPAIR;
+    bool plan_cache_enabled_ = true;
+    bool range_checks_enabled_ = false;
+    bool keep_item_bytes_ = false;
+    std::bitset<256> specialization_enabled_;
+    uint64_t specialization_threshold_ = 64;
+    QuarantineSink* quarantine_ = nullptr;
 };
 
 } // namespace skydecoder
\ No newline at end of file
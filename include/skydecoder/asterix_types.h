@@ -1,10 +1,13 @@
 #pragma once
 
+#include "skydecoder/export.h"
+#include "skydecoder/decode_core.h"
+#include "skydecoder/field_value.h"
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <memory>
-#include <variant>
+#include <string_view>
 #include <optional>
 #include <stdexcept>
 
@@ -59,20 +62,6 @@ enum class Unit {
     METERS_PER_SECOND
 };
 
-// Field value
-using FieldValue = std::variant<
-    uint8_t,
-    uint16_t,
-    uint32_t,
-    int8_t,
-    int16_t,
-    int32_t,
-    bool,
-    std::string,
-    std::vector<uint8_t>
->;
-
-
 // Structure for enumerations
 struct EnumValue {
     uint32_t value;
@@ -83,13 +72,17 @@ struct EnumValue {
 struct Field {
     std::string name;
     FieldType type;
-    uint8_t bits;
+    uint8_t bits = 0;  // 0 on a BYTES field: the rest of the item
     std::string description;
     double lsb = 1.0;  // Least Significant Bit
     Unit unit = Unit::NONE;
     std::vector<EnumValue> enums;
     std::optional<std::string> encoding;
     
+    // Valid range in the field unit (raw value * lsb)
+    std::optional<double> min_value;
+    std::optional<double> max_value;
+    
     // For conditional extensions
     std::optional<std::string> condition;
     std::vector<Field> extension_fields;
@@ -103,6 +96,7 @@ struct DataItem {
     DataFormat format;
     std::optional<uint16_t> length;  // For fixed formats
     std::vector<Field> fields;
+    bool verified = false;  // Top-level fields checked to lie within the item (see verify_category_layout)
 };
 
 // User Application Profile (UAP)
@@ -143,20 +137,25 @@ struct AsterixCategory {
     std::vector<ValidationRule> validation_rules;
 };
 
-// Field parsing result
+// Field parsing result. Trivially copyable: the name and description view
+// the category definition, the value views the message arena
 struct ParsedField {
-    std::string name;
+    std::string_view name;
     FieldValue value;
-    std::string description;
-    Unit unit;
+    std::string_view description;
+    Unit unit = Unit::NONE;
     bool valid = true;
-    std::string error_message;
+    const char* error_message = "";
 };
 
+static_assert(std::is_trivially_copyable<ParsedField>::value, "ParsedField must be trivially copyable");
+
 // Data item parsing result
 struct ParsedDataItem {
     std::string id;
     std::string name;
+    uint16_t frn = 0;                   // UAP position + 1, 0 if not known
+    FieldValue raw;                     // Item bytes (arena view) if the decoder keeps them, else empty
     std::vector<ParsedField> fields;
     bool valid = true;
     std::string error_message;
@@ -169,14 +168,35 @@ struct AsterixMessage {
     std::vector<ParsedDataItem> data_items;
     bool valid = true;
     std::string error_message;
+    
+    // Keep the field names and the string/byte payloads alive
+    std::shared_ptr<const AsterixCategory> definition;
+    std::shared_ptr<ValueArena> arena;
+};
+
+// Why a block did not decode cleanly (one byte in quarantine files)
+enum class BlockError : uint8_t {
+    NONE = 0,
+    TOO_SHORT = 1,              // Fewer bytes than a block header
+    BAD_LENGTH = 2,             // Header length below 3
+    UNSUPPORTED_CATEGORY = 3,   // No definition loaded
+    TRUNCATED = 4,              // The data ends before the header length
+    MALFORMED = 5,              // Decoding failed otherwise
+    RECORD_ERROR = 6            // Block decoded, but records were invalid or skipped
 };
 
+SKYDECODER_API const char* to_string(BlockError error);
+
+// Stream offset of a block decoded from memory
+constexpr uint64_t kUnknownOffset = ~uint64_t(0);
+
 // ASTERIX data block
 struct AsterixBlock {
     uint8_t category;
     uint16_t length;
     bool valid;
     std::vector<AsterixMessage> messages;
+    BlockError error = BlockError::NONE;    // Set whenever valid is false, RECORD_ERROR also when it is true
 };
 
 // Structure for parsing context
@@ -185,14 +205,19 @@ struct ParseContext {
     size_t size;
     size_t position;
     const AsterixCategory* category;
+    std::shared_ptr<ValueArena> arena;  // Created on the first string or byte value
     
     ParseContext(const uint8_t* d, size_t s, const AsterixCategory* c) 
         : data(d), size(s), position(0), category(c) {}
     
-    bool has_data(size_t bytes) const {
+    bool has_data(size_t bytes) const noexcept {
         return position + bytes <= size;
     }
     
+    const uint8_t* current() const noexcept {
+        return data + position;
+    }
+    
     uint8_t read_uint8() {
         if (!has_data(1)) throw std::runtime_error("Insufficient data");
         return data[position++];
@@ -200,14 +225,14 @@ struct ParseContext {
     
     uint16_t read_uint16() {
         if (!has_data(2)) throw std::runtime_error("Insufficient data");
-        uint16_t value = (data[position] << 8) | data[position + 1];
+        uint16_t value = core::load_be16(data + position);
         position += 2;
         return value;
     }
     
     uint32_t read_uint24() {
         if (!has_data(3)) throw std::runtime_error("Insufficient data");
-        uint32_t value = (data[position] << 16) | (data[position + 1] << 8) | data[position + 2];
+        uint32_t value = core::load_be24(data + position);
         position += 3;
         return value;
     }
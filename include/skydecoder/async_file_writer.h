@@ -0,0 +1,119 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace skydecoder {
+
+struct AsyncWriterOptions {
+    size_t buffer_size = 4 << 20;           // Rounded up to 4 KiB
+    size_t buffer_count = 3;                // 2: double buffering, 3: triple buffering
+    bool append = false;                    // Keep the existing content, else truncate
+    bool direct_io = false;                 // O_DIRECT where the file system allows it (Linux)
+    bool sync_on_close = false;             // fsync before close() returns
+};
+
+struct AsyncWriterStats {
+    uint64_t bytes_submitted = 0;           // Copied into buffers by write()
+    uint64_t bytes_written = 0;             // On the file
+    uint64_t buffers_written = 0;
+    uint64_t producer_waits = 0;            // write() calls that found every buffer in flight
+    uint64_t wait_ns = 0;                   // Time write() and flush() spent waiting for the I/O thread
+    uint64_t max_write_ns = 0;              // Slowest single buffer write
+    uint64_t errors = 0;
+    bool direct_io = false;                 // O_DIRECT actually in use
+};
+
+// Output file written from a dedicated I/O thread. write() only copies into
+// the current buffer; a full buffer is handed to the thread and the next
+// free one taken over, so a slow disk stalls the caller only once all
+// buffer_count buffers are queued (counted in producer_waits and wait_ns).
+// With direct_io the buffers are 4 KiB aligned and whole buffers bypass the
+// page cache; a partial buffer (flush, close) is written through the page
+// cache from then on. Use from one producer thread.
+class SKYDECODER_API AsyncFileWriter {
+public:
+    explicit AsyncFileWriter(AsyncWriterOptions options = {});
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    bool open(const std::string& path);
+    bool is_open() const { return open_; }
+
+    // False once any write has failed
+    bool write(const void* data, size_t size);
+    bool write(const std::string& data) { return write(data.data(), data.size()); }
+    bool write(const std::vector<uint8_t>& data) { return write(data.data(), data.size()); }
+
+    // Hand over the current buffer and wait until everything is written
+    bool flush();
+
+    // flush() and fsync
+    bool sync();
+
+    bool close();
+
+    // File length once everything submitted is written
+    uint64_t position() const { return base_offset_ + submitted_; }
+
+    // From the thread that writes
+    AsyncWriterStats stats() const;
+    std::string error() const;
+
+private:
+    struct Buffer {
+        uint8_t* data = nullptr;
+        size_t size = 0;
+    };
+
+    void submit_current(std::unique_lock<std::mutex>& lock);
+    void take_free_buffer(std::unique_lock<std::mutex>& lock);
+    bool wait_idle();
+
+    void io_loop();
+    bool write_buffer(const Buffer& buffer);
+    void release_buffers();
+
+    AsyncWriterOptions options_;
+    std::vector<Buffer> buffers_;
+
+    // Producer side
+    bool open_ = false;
+    Buffer* current_ = nullptr;
+    uint64_t base_offset_ = 0;
+    uint64_t submitted_ = 0;
+
+    // Shared with the I/O thread
+    mutable std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable buffer_ready_;
+    std::deque<Buffer*> full_;
+    std::deque<Buffer*> free_;
+    bool busy_ = false;
+    bool stopping_ = false;
+    std::atomic<bool> failed_{false};
+    AsyncWriterStats stats_;
+    std::string error_;
+
+    // I/O thread only
+#ifndef _WIN32
+    int fd_ = -1;
+#else
+    std::FILE* file_ = nullptr;
+#endif
+    bool direct_ = false;
+
+    std::thread thread_;
+};
+
+} // namespace skydecoder
\ No newline at end of file
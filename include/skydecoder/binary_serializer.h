@@ -0,0 +1,101 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace skydecoder {
+
+enum class BinaryFormat {
+    CBOR,
+    MSGPACK
+};
+
+enum class KeyMode {
+    INTEGER,    // Items keyed by FRN, fields by index, names in the category header
+    STRING      // Items keyed by id, fields by name; no header
+};
+
+// Writes decoded records as CBOR or MessagePack into a reusable buffer.
+//
+// The stream is a sequence of top-level maps. In INTEGER mode the first
+// record of a category is preceded by its dictionary header:
+//   {"schema": category, "items": [[frn, id, name, [[field, lsb, unit], ...]], ...]}
+// and records are
+//   {0: category, 1: {frn: {field_index: value, ...}, ...}, 2: error (if invalid)}
+// In STRING mode records are
+//   {"category": category, "items": {id: {field: value, ...}, ...}, "error": error}
+// Values are raw (scale them by the field lsb); BYTES fields are byte strings.
+class SKYDECODER_API BinarySerializer {
+public:
+    explicit BinarySerializer(BinaryFormat format, KeyMode keys = KeyMode::INTEGER);
+
+    void write(const AsterixMessage& message);
+    void write(const AsterixBlock& block);
+
+    // Header of a category; write() emits it on first use in INTEGER mode.
+    // The serializer keeps the definition for the records that follow
+    void write_header(std::shared_ptr<const AsterixCategory> category);
+
+    const std::vector<uint8_t>& buffer() const { return buffer_; }
+    size_t size() const { return buffer_.size(); }
+
+    // Drop the written bytes and keep the capacity; headers already
+    // emitted are not repeated
+    void clear() { buffer_.clear(); }
+
+    // Start a new stream: headers are written again
+    void reset();
+
+    BinaryFormat format() const { return format_; }
+    KeyMode key_mode() const { return keys_; }
+
+private:
+    struct ItemEntry {
+        uint32_t frn;
+        const DataItem* item;
+        std::vector<const Field*> fields;       // Flattened, extension fields after their parent
+    };
+
+    struct Dictionary {
+        std::shared_ptr<const AsterixCategory> category;    // Kept alive: entries point into it
+        std::vector<ItemEntry> items;           // In FRN order
+    };
+
+    // Dictionary of the definition, rebuilt (and its header due again) when
+    // the category gets a new definition
+    Dictionary& dictionary_for(const std::shared_ptr<const AsterixCategory>& category);
+    static void build_dictionary(const AsterixCategory& category, Dictionary& dictionary);
+    void emit_header(const Dictionary& dictionary);
+
+    void write_value(const FieldValue& value);
+    void write_fields(const ParsedDataItem& item, const ItemEntry* entry);
+
+    // Encoding primitives
+    void put_head(uint8_t major, uint64_t value);      // CBOR major type and argument
+    void put_be(uint64_t value, size_t bytes);
+    void put_byte(uint8_t byte) { buffer_.push_back(byte); }
+    void put_data(const uint8_t* data, size_t size);
+    void write_uint(uint64_t value);
+    void write_int(int64_t value);
+    void write_double(double value);
+    void write_bool(bool value);
+    void write_null();
+    void write_text(std::string_view text);
+    void write_bytes(const uint8_t* data, size_t size);
+    void write_array(size_t count);
+    void write_map(size_t count);
+
+    BinaryFormat format_;
+    KeyMode keys_;
+    std::vector<uint8_t> buffer_;
+    std::unordered_map<uint8_t, Dictionary> dictionaries_;
+    std::bitset<256> header_written_;
+};
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "skydecoder/export.h"
+#include <string>
+#include <vector>
+
+namespace skydecoder {
+
+// Instruction set levels for which SIMD kernels can be built
+enum class IsaLevel {
+    SCALAR,
+    SSE42,
+    AVX2,
+    AVX512
+};
+
+// CPU features relevant to the decoding kernels
+struct CpuFeatures {
+    bool sse42 = false;
+    bool avx2 = false;
+    bool bmi2 = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+};
+
+// Features of the running CPU (detected once)
+SKYDECODER_API const CpuFeatures& cpu_features();
+
+// ISA variants compiled into this library (see SKYDECODER_ISA_VARIANTS)
+SKYDECODER_API std::vector<IsaLevel> compiled_isa_levels();
+
+// Compiled variants that the running CPU can execute
+SKYDECODER_API std::vector<IsaLevel> supported_isa_levels();
+
+// Kernel variant currently used for dispatch
+SKYDECODER_API IsaLevel active_isa();
+
+// Override the automatic selection (e.g. for benchmarking); false if unavailable
+SKYDECODER_API bool force_isa(IsaLevel level);
+
+// Return to the best variant supported by the CPU
+SKYDECODER_API void reset_isa();
+
+SKYDECODER_API std::string to_string(IsaLevel level);
+SKYDECODER_API IsaLevel isa_from_string(const std::string& level);
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Header-only decoding primitives. Everything here is constexpr/noexcept and
+// works on raw pointers without bounds checks, so that the compiler can inline
+// and specialise it inside the decode loops. Callers validate lengths first.
+namespace skydecoder {
+namespace core {
+
+// Maximum number of FSPEC bytes accepted by the decoder
+constexpr size_t kMaxFspecLength = 16;
+
+// Big-endian loads
+constexpr uint16_t load_be16(const uint8_t* p) noexcept {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+constexpr uint32_t load_be24(const uint8_t* p) noexcept {
+    return (static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[2];
+}
+
+constexpr uint32_t load_be32(const uint8_t* p) noexcept {
+    return (static_cast<uint32_t>(p[0]) << 24) | load_be24(p + 1);
+}
+
+// Number of bytes spanned by num_bits starting at start_bit
+constexpr size_t bytes_spanned(size_t start_bit, size_t num_bits) noexcept {
+    return num_bits == 0 ? 0 : (start_bit + num_bits - 1) / 8 - start_bit / 8 + 1;
+}
+
+// Extract up to 32 bits, MSB first, starting at an arbitrary bit offset
+constexpr uint32_t extract_bits(const uint8_t* data, size_t start_bit, size_t num_bits) noexcept {
+    if (num_bits == 0) {
+        return 0;
+    }
+
+    size_t first = start_bit / 8;
+    size_t last = (start_bit + num_bits - 1) / 8;
+
+    uint64_t accumulator = 0;
+    for (size_t i = first; i <= last; ++i) {
+        accumulator = (accumulator << 8) | data[i];
+    }
+
+    size_t trailing = (last + 1) * 8 - (start_bit + num_bits);
+    uint64_t mask = (num_bits >= 32) ? 0xFFFFFFFFull : ((1ull << num_bits) - 1);
+    return static_cast<uint32_t>((accumulator >> trailing) & mask);
+}
+
+// Two's complement sign extension of a bits-wide value
+constexpr int32_t sign_extend(uint32_t value, unsigned bits) noexcept {
+    if (bits == 0 || bits >= 32) {
+        return static_cast<int32_t>(value);
+    }
+    uint32_t sign = 1u << (bits - 1);
+    value &= (1u << bits) - 1;
+    return static_cast<int32_t>((value ^ sign) - sign);
+}
+
+// Length of an FX-terminated sequence (FSPEC or variable item), 0 if not terminated within size
+constexpr size_t fx_chain_length(const uint8_t* data, size_t size) noexcept {
+    for (size_t i = 0; i < size; ++i) {
+        if ((data[i] & 0x01) == 0) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// Presence bit of a UAP position in an FSPEC (7 item bits per byte, bit 0 is FX)
+constexpr bool fspec_has_item(const uint8_t* fspec, size_t fspec_length, size_t uap_index) noexcept {
+    size_t byte = uap_index / 7;
+    return byte < fspec_length && (fspec[byte] & (0x80 >> (uap_index % 7))) != 0;
+}
+
+// Call f(uap_index) for every item present in the FSPEC, in UAP order
+template <typename Function>
+constexpr void for_each_fspec_item(const uint8_t* fspec, size_t fspec_length, size_t uap_size,
+                                   Function&& f) {
+    for (size_t byte = 0; byte < fspec_length; ++byte) {
+        for (unsigned bit = 7; bit >= 1; --bit) {
+            if (!(fspec[byte] & (1u << bit))) {
+                continue;
+            }
+
+            size_t uap_index = byte * 7 + (7 - bit);
+            if (uap_index >= uap_size) {
+                return;
+            }
+            f(uap_index);
+        }
+    }
+}
+
+// Number of items present in an FSPEC
+constexpr size_t fspec_item_count(const uint8_t* fspec, size_t fspec_length) noexcept {
+    size_t count = 0;
+    for (size_t byte = 0; byte < fspec_length; ++byte) {
+        for (uint8_t bits = fspec[byte] & 0xFE; bits; bits &= static_cast<uint8_t>(bits - 1)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+} // namespace core
+} // namespace skydecoder
\ No newline at end of file
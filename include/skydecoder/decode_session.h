@@ -0,0 +1,97 @@
+#pragma once
+
+#include "skydecoder/asterix_decoder.h"
+#include "skydecoder/file_follower.h"
+#include "skydecoder/utils.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace skydecoder {
+
+struct SessionOptions {
+    std::string checkpoint_path;            // Empty: no checkpoints
+    uint64_t checkpoint_blocks = 10000;     // Checkpoint after that many blocks or that much time,
+    int checkpoint_interval_ms = 5000;      // whichever comes first (0 disables either)
+    size_t buffer_size = 1 << 20;           // Read buffer
+};
+
+// Everything a session needs to carry on where it stopped
+struct SessionCheckpoint {
+    std::string file;
+    uint64_t file_size = 0;                 // At the time of the checkpoint; open() rejects a shorter file
+    uint64_t offset = 0;                    // End of the last block whose output is durable
+    uint64_t blocks = 0;
+    utils::MessageStatistics statistics;
+    std::vector<uint8_t> user_state;        // From the save hook: output positions, monitor state
+};
+
+// Decode job over one file that can be stopped and resumed. Blocks are read
+// from a block-aligned offset and decoded one at a time; every N blocks or
+// T milliseconds the save hook syncs the outputs to disk and serialises the
+// caller's state, and the offset, the streaming statistics and that state
+// are written to the checkpoint file (temporary file, fsync, rename). A job
+// opened on the same file resumes at the checkpoint offset and hands the
+// saved state to the restore hook, which truncates outputs back to it, so
+// nothing is emitted twice.
+class SKYDECODER_API DecodeSession {
+public:
+    // Return false to stop after this block
+    using BlockHandler = std::function<bool(const AsterixBlock& block, uint64_t offset)>;
+    using SaveHook = std::function<bool(std::vector<uint8_t>& state)>;
+    using RestoreHook = std::function<bool(const std::vector<uint8_t>& state)>;
+
+    explicit DecodeSession(AsterixDecoder& decoder, SessionOptions options = {});
+
+    // Set before open(); a failing save hook skips that checkpoint and sets
+    // error(), failing run() if it was the final one. The restore
+    // hook gets an empty state when there is no checkpoint to resume from.
+    void set_state_hooks(SaveHook save, RestoreHook restore);
+
+    // Start at offset 0, or at the checkpoint if it is for this file. False if
+    // the file cannot be read, or the checkpoint is unreadable or for a file
+    // that is now shorter than it was at the checkpoint.
+    bool open(const std::string& path);
+
+    // Decode to the end of the file, checkpointing on the way and at the end
+    bool run(const BlockHandler& handler);
+
+    // Thread and signal safe; run() checkpoints and returns after the current block
+    void stop() { stop_requested_.store(true); }
+
+    bool checkpoint();
+
+    bool resumed() const { return resumed_; }
+    uint64_t offset() const { return offset_; }
+    uint64_t blocks() const { return blocks_; }
+    uint64_t checkpoints_written() const { return checkpoints_written_; }
+    const utils::MessageStatistics& statistics() const { return statistics_; }
+    const std::string& error() const { return error_; }
+
+    static bool read_checkpoint(const std::string& path, SessionCheckpoint& checkpoint);
+    static bool write_checkpoint(const std::string& path, const SessionCheckpoint& checkpoint);
+
+private:
+    AsterixDecoder& decoder_;
+    SessionOptions options_;
+    SaveHook save_hook_;
+    RestoreHook restore_hook_;
+
+    FileFollower reader_;
+    std::string path_;
+    bool resumed_ = false;
+    uint64_t offset_ = 0;
+    uint64_t blocks_ = 0;
+    uint64_t blocks_since_checkpoint_ = 0;
+    uint64_t checkpoints_written_ = 0;
+    std::chrono::steady_clock::time_point last_checkpoint_;
+    utils::MessageStatistics statistics_;
+
+    std::atomic<bool> stop_requested_{false};
+    std::string error_;
+};
+
+} // namespace skydecoder
\ No newline at end of file
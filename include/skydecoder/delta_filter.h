@@ -0,0 +1,75 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include "skydecoder/lazy_record.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace skydecoder {
+
+enum class DeltaMode {
+    ITEMS,      // Strip unchanged tracked items, keep the record
+    RECORDS     // Drop records whose tracked items are all unchanged
+};
+
+struct DeltaOptions {
+    std::vector<std::string> items = {"I002/050", "I002/060"};
+    DeltaMode mode = DeltaMode::ITEMS;
+    uint32_t keyframe_interval = 64;    // Let an unchanged value through every N occurrences per radar (0: never)
+};
+
+struct DeltaStats {
+    uint64_t records_in = 0;
+    uint64_t records_out = 0;
+    uint64_t items_seen = 0;            // Occurrences of tracked items
+    uint64_t items_changed = 0;         // First occurrences included
+    uint64_t keyframes = 0;
+    uint64_t items_suppressed = 0;
+    uint64_t items_without_bytes = 0;   // In messages decoded without item bytes, always passed
+};
+
+// Change-only output for status items that repeat in every north marker.
+// The last value of each tracked item is kept per radar (SAC/SIC of
+// I002/010); an occurrence passes if it differs from that value, is the
+// first one, or is due as a keyframe. Occurrences are compared on their raw
+// item bytes: a lazy record's, or ParsedDataItem::raw of a decoded message
+// (AsterixDecoder::set_keep_item_bytes). The decoded fields are not enough,
+// as definitions need not cover every bit (CAT002 I002/050 only defines FX),
+// so a tracked item decoded without its bytes always passes.
+class SKYDECODER_API DeltaFilter {
+public:
+    explicit DeltaFilter(DeltaOptions options = {});
+
+    // Returns false if the record is to be dropped (RECORDS mode); in ITEMS
+    // mode unchanged tracked items are removed and true is returned
+    bool filter(AsterixMessage& message);
+
+    // Whether the record carries a change or keyframe (or no tracked item);
+    // the items themselves are left alone, so ITEMS mode acts as RECORDS here
+    bool filter(const LazyRecord& record);
+
+    const DeltaStats& stats() const { return stats_; }
+
+    // Forget the last values: every tracked item passes once more
+    void reset();
+
+private:
+    struct State {
+        std::vector<uint8_t> last;
+        uint32_t since_keyframe = 0;
+        bool seen = false;
+    };
+
+    int tracked_index(const std::string& item_id) const;
+
+    // Record the occurrence and tell whether it passes
+    bool observe(uint16_t radar, int tracked, const uint8_t* value, size_t size);
+
+    DeltaOptions options_;
+    DeltaStats stats_;
+    std::unordered_map<uint64_t, State> states_;    // Key: SAC/SIC << 32 | tracked item index
+};
+
+} // namespace skydecoder
\ No newline at end of file
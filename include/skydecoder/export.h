@@ -0,0 +1,16 @@
+#pragma once
+
+// Symbol visibility for the public API. The library is built with
+// -fvisibility=hidden when SKYDECODER_HIDDEN_VISIBILITY is enabled, so every
+// class or function meant to be used by applications is marked SKYDECODER_API.
+#if defined(_WIN32) && defined(SKYDECODER_SHARED)
+    #ifdef SKYDECODER_BUILDING
+        #define SKYDECODER_API __declspec(dllexport)
+    #else
+        #define SKYDECODER_API __declspec(dllimport)
+    #endif
+#elif defined(__GNUC__) || defined(__clang__)
+    #define SKYDECODER_API __attribute__((visibility("default")))
+#else
+    #define SKYDECODER_API
+#endif
\ No newline at end of file
@@ -1,12 +1,12 @@
 #pragma once
 
 #include "skydecoder/asterix_types.h"
+#include <memory>
 #include <vector>
-#include <bitset>
 
 namespace skydecoder {
 
-class FieldParser {
+class SKYDECODER_API FieldParser {
 public:
     // Parse a field from binary data
     static ParsedField parse_field(const Field& field_def, ParseContext& context);
@@ -14,6 +14,15 @@ public:
     // Parse a complete data item
     static ParsedDataItem parse_data_item(const DataItem& item_def, ParseContext& context);
     
+    // Parse a FIXED data item whose bytes are known to be available; string
+    // and byte values are stored in the arena, created on first use
+    static ParsedDataItem parse_fixed_item(const DataItem& item_def, const uint8_t* data,
+                                           std::shared_ptr<ValueArena>& arena);
+    
+    // Bytes taken by an item starting at data, from its format alone (0 if
+    // truncated or the definition lacks a length); no field is decoded
+    static size_t measure_data_item(const DataItem& item_def, const uint8_t* data, size_t size);
+    
     // Parse conditional extension fields
     static std::vector<ParsedField> parse_extension_fields(
         const std::vector<Field>& extension_fields,
@@ -22,12 +31,21 @@ public:
     );
     
 private:
-    // Utility methods for extracting bits
-    static uint32_t extract_bits(const std::vector<uint8_t>& data, size_t start_bit, size_t num_bits);
-    static std::vector<uint8_t> read_field_bytes(const Field& field, ParseContext& context);
+    // Parse the fields of an item whose length is known
+    static void parse_item_fields(const DataItem& item_def, const uint8_t* data, size_t size,
+                                  std::shared_ptr<ValueArena>& arena, ParsedDataItem& result);
+    
+    // Parse a field located at an arbitrary bit offset of an item
+    // (errors are reported through the result, never thrown); the bounds check
+    // is skipped for fields of verified layouts
+    static ParsedField parse_field_at(const Field& field_def, const uint8_t* data, size_t size,
+                                      size_t bit_offset, std::shared_ptr<ValueArena>& arena,
+                                      bool check_bounds);
     
     // Convert raw values to typed values
-    static FieldValue convert_raw_value(uint32_t raw_value, const Field& field);
+    static FieldValue convert_raw_value(uint32_t raw_value, const Field& field,
+                                        std::shared_ptr<ValueArena>& arena);
+    static ValueArena& arena_for(std::shared_ptr<ValueArena>& arena);
     static std::string decode_6bit_ascii(const std::vector<uint8_t>& data);
     
     // Condition validation
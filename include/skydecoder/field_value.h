@@ -0,0 +1,146 @@
+#pragma once
+
+#include "skydecoder/export.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace skydecoder {
+
+// Owner of the string and byte payloads referenced by FieldValue views.
+// Storage is chunked, so returned pointers stay valid for the arena lifetime.
+class SKYDECODER_API ValueArena {
+public:
+    const uint8_t* store(const uint8_t* data, size_t size);
+    size_t bytes_used() const { return used_; }
+
+private:
+    static constexpr size_t kChunkSize = 4096;
+
+    std::vector<std::unique_ptr<uint8_t[]>> chunks_;
+    size_t chunk_used_ = kChunkSize;    // Bytes used in the last chunk
+    size_t used_ = 0;
+};
+
+// Decoded value of a field: a tag plus a 64-bit integer, a double or a view.
+// 16 bytes and trivially copyable, so field vectors are memcpy-able.
+class FieldValue {
+public:
+    enum class Kind : uint8_t {
+        NONE,
+        UNSIGNED,
+        SIGNED,
+        REAL,
+        BOOL,
+        STRING,
+        BYTES
+    };
+
+    constexpr FieldValue() noexcept : u_(0) {}
+
+    // width: bytes of the integer type the field decodes to (1, 2, 4 or 8)
+    static constexpr FieldValue from_unsigned(uint64_t value, uint8_t width = 8) noexcept {
+        return FieldValue(Kind::UNSIGNED, width, value);
+    }
+    static constexpr FieldValue from_signed(int64_t value, uint8_t width = 8) noexcept {
+        return FieldValue(value, width);
+    }
+    static constexpr FieldValue from_double(double value) noexcept {
+        return FieldValue(value);
+    }
+    static constexpr FieldValue from_bool(bool value) noexcept {
+        return FieldValue(Kind::BOOL, 1, value ? 1 : 0);
+    }
+    // Views: the caller keeps the payload alive (normally a ValueArena)
+    static FieldValue string_view(const char* data, size_t size) noexcept {
+        return FieldValue(Kind::STRING, reinterpret_cast<const uint8_t*>(data), size);
+    }
+    static constexpr FieldValue bytes_view(const uint8_t* data, size_t size) noexcept {
+        return FieldValue(Kind::BYTES, data, size);
+    }
+
+    Kind kind() const noexcept { return kind_; }
+    uint8_t width() const noexcept { return width_; }
+    bool empty() const noexcept { return kind_ == Kind::NONE; }
+    bool is_integer() const noexcept { return kind_ == Kind::UNSIGNED || kind_ == Kind::SIGNED; }
+    bool is_numeric() const noexcept { return is_integer() || kind_ == Kind::REAL || kind_ == Kind::BOOL; }
+
+    uint64_t as_unsigned() const noexcept {
+        switch (kind_) {
+            case Kind::UNSIGNED:
+            case Kind::BOOL: return u_;
+            case Kind::SIGNED: return static_cast<uint64_t>(i_);
+            case Kind::REAL: return static_cast<uint64_t>(d_);
+            default: return 0;
+        }
+    }
+
+    int64_t as_signed() const noexcept {
+        return kind_ == Kind::SIGNED ? i_ : static_cast<int64_t>(as_unsigned());
+    }
+
+    double as_double() const noexcept {
+        switch (kind_) {
+            case Kind::UNSIGNED:
+            case Kind::BOOL: return static_cast<double>(u_);
+            case Kind::SIGNED: return static_cast<double>(i_);
+            case Kind::REAL: return d_;
+            default: return 0.0;
+        }
+    }
+
+    bool as_bool() const noexcept { return as_unsigned() != 0; }
+
+    // Payload of STRING and BYTES values, empty otherwise
+    const uint8_t* data() const noexcept { return has_view() ? p_ : nullptr; }
+    size_t size() const noexcept { return has_view() ? size_ : 0; }
+
+    std::string_view as_string() const noexcept {
+        return has_view() ? std::string_view(reinterpret_cast<const char*>(p_), size_) : std::string_view();
+    }
+
+    std::vector<uint8_t> to_bytes() const {
+        return has_view() ? std::vector<uint8_t>(p_, p_ + size_) : std::vector<uint8_t>();
+    }
+
+private:
+    constexpr FieldValue(Kind kind, uint8_t width, uint64_t value) noexcept
+        : u_(value), kind_(kind), width_(width) {}
+    constexpr FieldValue(int64_t value, uint8_t width) noexcept
+        : i_(value), kind_(Kind::SIGNED), width_(width) {}
+    constexpr FieldValue(double value) noexcept
+        : d_(value), kind_(Kind::REAL), width_(8) {}
+    constexpr FieldValue(Kind kind, const uint8_t* data, size_t size) noexcept
+        : p_(data), size_(static_cast<uint32_t>(size)), kind_(kind) {}
+
+    bool has_view() const noexcept { return kind_ == Kind::STRING || kind_ == Kind::BYTES; }
+
+    union {
+        uint64_t u_;
+        int64_t i_;
+        double d_;
+        const uint8_t* p_;
+    };
+    uint32_t size_ = 0;
+    Kind kind_ = Kind::NONE;
+    uint8_t width_ = 0;
+};
+
+static_assert(sizeof(FieldValue) == 16, "FieldValue must stay 16 bytes");
+static_assert(std::is_trivially_copyable<FieldValue>::value, "FieldValue must be trivially copyable");
+
+// Copy a string or byte payload into an arena and return a view of it
+inline FieldValue make_string_value(ValueArena& arena, std::string_view text) {
+    const uint8_t* data = arena.store(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    return FieldValue::string_view(reinterpret_cast<const char*>(data), text.size());
+}
+
+inline FieldValue make_bytes_value(ValueArena& arena, const uint8_t* data, size_t size) {
+    return FieldValue::bytes_view(arena.store(data, size), size);
+}
+
+} // namespace skydecoder
\ No newline at end of file
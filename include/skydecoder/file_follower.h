@@ -0,0 +1,100 @@
+#pragma once
+
+#include "skydecoder/export.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace skydecoder {
+
+struct FollowOptions {
+    size_t buffer_size = 1 << 20;       // Read buffer, raised to hold at least one maximum-size block
+    int poll_interval_ms = 100;         // Growth check without inotify; rotation and stop check with it
+    bool use_inotify = true;            // Linux only, polling elsewhere or if it cannot be set up
+    int idle_timeout_ms = -1;           // run() returns after that long without a new block (-1: never)
+};
+
+struct FollowStats {
+    uint64_t blocks = 0;
+    uint64_t bytes = 0;                 // Of complete blocks handed out
+    uint64_t wakeups = 0;               // Change notifications received
+    uint64_t truncations = 0;           // File shrank below the read position: restarted at 0
+    uint64_t rotations = 0;             // Path replaced by another file: switched to it at 0
+    uint64_t discarded_bytes = 0;       // Partial tail blocks lost to truncation or rotation
+};
+
+enum class FollowStatus {
+    STOPPED,    // stop() was called or the handler returned false
+    IDLE,       // Idle timeout
+    FAILED      // I/O error or invalid block header, see error()
+};
+
+// Decodes a recording while it is being written: hands out every complete
+// block up to the current end of file, keeps a partial block at the tail
+// until the rest arrives, then waits for growth (inotify on the directory,
+// polling otherwise). Memory is bounded by the read buffer. offset() is the
+// end of the last block handed out, so a follower opened at that offset later
+// resumes without duplicates.
+class SKYDECODER_API FileFollower {
+public:
+    // Return false to stop after this block
+    using BlockHandler = std::function<bool(const uint8_t* block, size_t size, uint64_t offset)>;
+
+    explicit FileFollower(FollowOptions options = {});
+    ~FileFollower();
+
+    FileFollower(const FileFollower&) = delete;
+    FileFollower& operator=(const FileFollower&) = delete;
+
+    // The offset must be a block boundary
+    bool open(const std::string& path, uint64_t offset = 0);
+    void close();
+
+    // Hand out the complete blocks available now; returns their number
+    size_t read_available(const BlockHandler& handler);
+
+    // Wait up to timeout_ms for a change of the file; false if none was notified
+    bool wait(int timeout_ms);
+
+    // read_available() and wait() until stopped, idle or failed
+    FollowStatus run(const BlockHandler& handler);
+
+    // Thread and signal safe
+    void stop() { stop_requested_.store(true); }
+
+    uint64_t offset() const { return offset_; }
+    bool using_inotify() const { return watch_fd_ >= 0; }
+    const FollowStats& stats() const { return stats_; }
+    const std::string& error() const { return error_; }
+
+private:
+    bool reopen();
+    bool check_replaced();
+    void reset_buffer(uint64_t offset);
+    void setup_watch();
+
+    FollowOptions options_;
+    std::string path_;
+    int fd_ = -1;
+    uint64_t inode_ = 0;
+    uint64_t device_ = 0;
+
+    std::vector<uint8_t> buffer_;
+    size_t begin_ = 0;                  // First byte of the next block
+    size_t end_ = 0;                    // End of the bytes read
+    uint64_t offset_ = 0;               // File offset of buffer_[begin_]
+    uint64_t read_position_ = 0;        // File offset of buffer_[end_]
+
+    int watch_fd_ = -1;                 // inotify instance, -1 when polling
+    std::string watch_name_;            // File name within the watched directory
+
+    std::atomic<bool> stop_requested_{false};
+    bool handler_stopped_ = false;
+    FollowStats stats_;
+    std::string error_;
+};
+
+} // namespace skydecoder
\ No newline at end of file
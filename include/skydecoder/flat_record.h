@@ -0,0 +1,217 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace skydecoder {
+
+class LazyRecord;
+
+// Self-describing decoded record that is read in place, without parsing.
+//
+//   RecordHeader   24 bytes
+//   ItemEntry      16 bytes per item
+//   FieldEntry     24 bytes per field, items' fields back to back
+//   strings        item ids, item and field names (NUL terminated), payloads
+//
+// All offsets are relative to the start of the record, entries and scalar
+// values are 8-byte aligned and the record size is a multiple of 8, so
+// records of a block can be concatenated and handed over as one buffer.
+// Values are in host (little-endian) byte order and raw (scale by lsb).
+namespace flat {
+
+constexpr uint32_t kMagic = 0x52594B53;     // "SKYR"
+constexpr uint16_t kVersion = 1;
+
+struct RecordHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t category;
+    uint8_t flags;              // Bit 0: valid
+    uint32_t size;              // Whole record, padding included
+    uint16_t length;            // Length of the ASTERIX record
+    uint16_t item_count;
+    uint32_t error;             // Offset of the error message, 0 if none
+    uint32_t reserved;
+};
+
+struct ItemEntry {
+    uint32_t fields;            // Offset of the first FieldEntry
+    uint32_t id;                // Offset of the item id string
+    uint32_t name;              // Offset of the item name string
+    uint16_t field_count;
+    uint16_t frn;               // Field reference number, 0 if unknown
+};
+
+struct FieldEntry {
+    uint32_t name;
+    uint8_t kind;               // FieldValue::Kind
+    uint8_t width;
+    uint8_t unit;               // Unit
+    uint8_t flags;              // Bit 0: valid
+    double lsb;
+    uint64_t value;             // Integer, double bits, or payload offset (low) and size (high)
+};
+
+static_assert(sizeof(RecordHeader) == 24, "RecordHeader layout");
+static_assert(sizeof(ItemEntry) == 16, "ItemEntry layout");
+static_assert(sizeof(FieldEntry) == 24, "FieldEntry layout");
+
+template <typename T>
+inline T load(const uint8_t* base, size_t offset) {
+    T value;
+    std::memcpy(&value, base + offset, sizeof(T));
+    return value;
+}
+
+} // namespace flat
+
+class SKYDECODER_API FlatFieldView {
+public:
+    FlatFieldView() = default;
+    FlatFieldView(const uint8_t* record, flat::FieldEntry entry) : record_(record), entry_(entry) {}
+
+    std::string_view name() const { return reinterpret_cast<const char*>(record_ + entry_.name); }
+    FieldValue::Kind kind() const { return static_cast<FieldValue::Kind>(entry_.kind); }
+    uint8_t width() const { return entry_.width; }
+    Unit unit() const { return static_cast<Unit>(entry_.unit); }
+    double lsb() const { return entry_.lsb; }
+    bool valid() const { return entry_.flags & 1; }
+
+    // A FieldValue whose string and byte payloads view the buffer
+    FieldValue value() const;
+
+    uint64_t as_unsigned() const { return value().as_unsigned(); }
+    int64_t as_signed() const { return value().as_signed(); }
+    double as_double() const { return value().as_double(); }
+    bool as_bool() const { return value().as_bool(); }
+    std::string_view as_string() const { return value().as_string(); }
+
+    // Engineering value (raw * lsb) of a numeric field
+    double scaled() const { return value().as_double() * entry_.lsb; }
+
+private:
+    const uint8_t* record_ = nullptr;
+    flat::FieldEntry entry_{};
+};
+
+class SKYDECODER_API FlatItemView {
+public:
+    FlatItemView() = default;
+    FlatItemView(const uint8_t* record, flat::ItemEntry entry) : record_(record), entry_(entry) {}
+
+    std::string_view id() const { return reinterpret_cast<const char*>(record_ + entry_.id); }
+    std::string_view name() const { return reinterpret_cast<const char*>(record_ + entry_.name); }
+    uint16_t frn() const { return entry_.frn; }
+    size_t field_count() const { return entry_.field_count; }
+
+    FlatFieldView field(size_t index) const {
+        return FlatFieldView(record_, flat::load<flat::FieldEntry>(
+            record_, entry_.fields + index * sizeof(flat::FieldEntry)));
+    }
+
+    // First field of that name; false if absent
+    bool find_field(std::string_view name, FlatFieldView& out) const;
+
+private:
+    const uint8_t* record_ = nullptr;
+    flat::ItemEntry entry_{};
+};
+
+// View of one record; the buffer must outlive it
+class SKYDECODER_API FlatRecordView {
+public:
+    FlatRecordView() = default;
+    explicit FlatRecordView(const uint8_t* record)
+        : record_(record), header_(flat::load<flat::RecordHeader>(record, 0)) {}
+
+    // Check the magic, version and that every offset lies within size bytes;
+    // run it once on buffers from untrusted peers before reading them
+    static bool verify(const uint8_t* data, size_t size);
+
+    const uint8_t* data() const { return record_; }
+    size_t size() const { return header_.size; }
+    uint8_t category() const { return header_.category; }
+    uint16_t length() const { return header_.length; }
+    bool valid() const { return header_.flags & 1; }
+    std::string_view error_message() const {
+        return header_.error ? std::string_view(reinterpret_cast<const char*>(record_ + header_.error))
+                             : std::string_view();
+    }
+
+    size_t item_count() const { return header_.item_count; }
+    FlatItemView item(size_t index) const {
+        return FlatItemView(record_, flat::load<flat::ItemEntry>(
+            record_, sizeof(flat::RecordHeader) + index * sizeof(flat::ItemEntry)));
+    }
+
+    bool find_item(std::string_view id, FlatItemView& out) const;
+
+private:
+    const uint8_t* record_ = nullptr;
+    flat::RecordHeader header_{};
+};
+
+// Appends decoded records to a reusable buffer in the flat layout
+class SKYDECODER_API FlatRecordWriter {
+public:
+    // Returns the offset of the record in the buffer
+    size_t append(const AsterixMessage& message);
+    void append(const AsterixBlock& block);
+    
+    // Decode the items of a lazy record in place, without building a message
+    size_t append(LazyRecord& record);
+    
+    // Copy a record that is already flat (verified by the caller)
+    size_t append(const FlatRecordView& record);
+
+    const std::vector<uint8_t>& buffer() const { return buffer_; }
+    const std::vector<size_t>& offsets() const { return offsets_; }
+    size_t record_count() const { return offsets_.size(); }
+
+    FlatRecordView record(size_t index) const { return FlatRecordView(buffer_.data() + offsets_[index]); }
+
+    // Keeps the capacity
+    void clear();
+    void reserve(size_t bytes, size_t records);
+
+private:
+    struct ItemDefinition {
+        uint16_t frn;
+        const DataItem* item;
+        std::vector<const Field*> fields;
+    };
+
+    void update_definitions(const AsterixCategory* category);
+    
+    template <typename ItemAt>
+    size_t append_record(const AsterixCategory* category, uint8_t category_number, uint16_t length,
+                         bool valid, std::string_view error, size_t item_count, ItemAt&& item_at);
+
+    std::vector<uint8_t> buffer_;
+    std::vector<size_t> offsets_;
+    std::vector<uint8_t> strings_;             // Scratch for the string area of a record
+
+    const AsterixCategory* category_ = nullptr;
+    std::vector<ItemDefinition> definitions_;  // In UAP order
+};
+
+// Walk the records of a buffer of concatenated flat records; stops at the
+// first record that does not verify and returns the number visited
+template <typename Function>
+size_t for_each_flat_record(const uint8_t* data, size_t size, Function&& function) {
+    size_t offset = 0;
+    size_t count = 0;
+    while (offset < size && FlatRecordView::verify(data + offset, size - offset)) {
+        FlatRecordView record(data + offset);
+        function(record);
+        offset += record.size();
+        ++count;
+    }
+    return count;
+}
+
+} // namespace skydecoder
\ No newline at end of file
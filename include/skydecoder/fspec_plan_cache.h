@@ -0,0 +1,96 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include "skydecoder/plan_specializer.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace skydecoder {
+
+// Item layout of records sharing one FSPEC byte sequence
+struct FspecPlan {
+    uint8_t fspec[core::kMaxFspecLength] = {};
+    uint8_t fspec_length = 0;
+
+    std::vector<const DataItem*> items;         // Present items in UAP order
+    std::vector<uint16_t> item_frns;            // FRN of each of them
+    std::vector<std::string> unknown_items;     // Present in the UAP but not defined
+    size_t min_length = 0;                      // Lower bound of the item bytes
+
+    // When every present item is FIXED the layout is known up front
+    bool all_fixed = false;
+    size_t fixed_length = 0;                    // Total item bytes
+    std::vector<uint32_t> item_offsets;         // Offset of each item after the FSPEC
+    
+    // Hot plans are specialised once they have been used often enough
+    uint64_t uses = 0;
+    bool specialization_attempted = false;
+    std::shared_ptr<const SpecializedDecoder> specialized;
+    uint64_t specialized_records = 0;
+};
+
+// Resolve the items of an FSPEC against a category
+SKYDECODER_API FspecPlan build_fspec_plan(const uint8_t* fspec, size_t fspec_length,
+                                          const AsterixCategory& category);
+
+struct PlanCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    size_t entries = 0;
+    size_t specialized_plans = 0;
+    uint64_t specialized_records = 0;
+
+    double hit_ratio() const {
+        uint64_t total = hits + misses;
+        return total > 0 ? static_cast<double>(hits) / total : 0.0;
+    }
+};
+
+class FspecPlanCache;
+
+// Cached plan of an FSPEC, built into scratch when there is no cache or it is full
+SKYDECODER_API const FspecPlan& lookup_fspec_plan(FspecPlanCache* cache, const uint8_t* fspec,
+                                                  size_t fspec_length, const AsterixCategory& category,
+                                                  FspecPlan& scratch);
+
+// Bytes taken by a record (FSPEC + items) measured from its plan, 0 if truncated
+SKYDECODER_API size_t measure_record(const FspecPlan& plan, const uint8_t* data, size_t size);
+
+// Per-category open-addressing table of FSPEC plans keyed by the raw FSPEC bytes
+class SKYDECODER_API FspecPlanCache {
+public:
+    explicit FspecPlanCache(size_t max_entries = 1024);
+
+    // Cached plan for an FSPEC (nullptr on a miss); updates the hit/miss counters
+    FspecPlan* find(const uint8_t* fspec, size_t fspec_length);
+
+    // Store a plan, nullptr if the cache is full
+    FspecPlan* insert(const FspecPlan& plan);
+
+    // Drop the specialised decoders and let hot plans be specialised again
+    void reset_specializations();
+
+    void clear();
+    PlanCacheStats stats() const;
+    size_t max_entries() const { return max_entries_; }
+
+private:
+    static uint64_t hash(const uint8_t* fspec, size_t fspec_length);
+    void grow();
+
+    struct Slot {
+        uint64_t hash = 0;
+        int32_t index = -1;                     // Into plans_, -1 if empty
+    };
+
+    std::vector<Slot> slots_;                   // Power of two, at most half full
+    std::vector<std::unique_ptr<FspecPlan>> plans_;
+    size_t max_entries_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include <string>
+#include <vector>
+
+namespace skydecoder {
+
+// What to do with inconsistent item layouts when a category is loaded
+enum class LayoutPolicy {
+    OFF,        // Load definitions as they are
+    REPAIR,     // Fix what can be fixed (missing spares, bits implied by the type)
+    STRICT      // Reject the category on any inconsistency
+};
+
+struct LayoutIssue {
+    std::string item_id;
+    std::string field;          // Empty for item-level issues
+    std::string message;
+    bool repaired = false;
+};
+
+// Check the field layout of every item against its format: FIXED fields must
+// cover exactly length*8 bits, every field needs a bit width that fits its
+// type, VARIABLE octets end with FX, and only the last field of an EXPLICIT
+// item may be a BYTES field without bits (it takes the rest of the item).
+// Items whose fields are then known to lie within any well-formed instance
+// (FIXED items, VARIABLE items whose top-level fields fit in one octet) are
+// marked verified, which lets the parser drop its per-field bounds checks.
+// Returns false if an issue is left unrepaired (any issue with STRICT).
+SKYDECODER_API bool verify_category_layout(AsterixCategory& category, LayoutPolicy policy,
+                                           std::vector<LayoutIssue>& issues);
+
+SKYDECODER_API std::string to_string(LayoutPolicy policy);
+SKYDECODER_API LayoutPolicy layout_policy_from_string(const std::string& policy);
+
+} // namespace skydecoder
\ No newline at end of file
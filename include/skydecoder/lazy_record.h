@@ -0,0 +1,69 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include "skydecoder/fspec_plan_cache.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace skydecoder {
+
+// Record that keeps a reference to its raw bytes plus the offset of every
+// present item, and decodes an item's fields only when it is first accessed.
+// The raw bytes must outlive the record.
+class SKYDECODER_API LazyRecord {
+public:
+    LazyRecord() = default;
+    LazyRecord(LazyRecord&&) noexcept = default;
+    LazyRecord& operator=(LazyRecord&&) noexcept = default;
+    
+    // Read the FSPEC and measure the present items without decoding them; the
+    // item layout comes from the plan cache when one is given.
+    // Returns false if the record is truncated.
+    bool index(const uint8_t* data, size_t size, std::shared_ptr<const AsterixCategory> category,
+               FspecPlanCache* plan_cache = nullptr);
+    
+    bool valid() const { return valid_; }
+    uint8_t category() const { return category_ ? category_->header.category : 0; }
+    const AsterixCategory* definition() const { return category_.get(); }
+    size_t length() const { return length_; }              // FSPEC + item bytes
+    const uint8_t* data() const { return data_; }
+    
+    // Items in UAP order
+    size_t item_count() const { return items_.size(); }
+    const std::string& item_id(size_t index) const { return items_[index].definition->id; }
+    const uint8_t* item_data(size_t index) const { return data_ + items_[index].offset; }
+    size_t item_size(size_t index) const { return items_[index].size; }
+    bool has_item(const std::string& id) const { return find(id) >= 0; }
+    
+    // Decoded item, cached after the first access (nullptr if not present)
+    const ParsedDataItem* item(const std::string& id);
+    const ParsedDataItem& item_at(size_t index);
+    
+    // Decode the remaining items into a regular message
+    AsterixMessage materialize();
+    
+    size_t decoded_item_count() const;
+    
+private:
+    struct Entry {
+        const DataItem* definition;
+        uint32_t offset;                            // From the start of the record
+        uint32_t size;
+        uint16_t frn;
+        std::unique_ptr<ParsedDataItem> decoded;    // Allocated on first access
+    };
+    
+    int find(const std::string& id) const;
+    
+    const uint8_t* data_ = nullptr;
+    size_t length_ = 0;
+    bool valid_ = false;
+    std::shared_ptr<const AsterixCategory> category_;
+    std::vector<Entry> items_;
+    std::shared_ptr<ValueArena> arena_;             // String and byte values of decoded items
+};
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "skydecoder/export.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace skydecoder {
+
+// Huge page policy for decoder buffers
+enum class HugePageMode {
+    NONE,         // Regular pages
+    TRANSPARENT,  // 2 MiB aligned mapping advised with MADV_HUGEPAGE
+    EXPLICIT      // MAP_HUGETLB, falls back to TRANSPARENT if no huge pages are reserved
+};
+
+// Allocation options of decoder buffers and worker threads
+struct MemoryOptions {
+    HugePageMode huge_pages = HugePageMode::NONE;
+    int numa_node = -1;         // Preferred NUMA node (-1 = first-touch, no binding)
+    bool pin_threads = false;   // Pin pipeline threads to the CPUs of numa_node
+};
+
+// Page-backed buffer honouring MemoryOptions (move-only)
+class SKYDECODER_API NumaBuffer {
+public:
+    NumaBuffer() = default;
+    NumaBuffer(size_t size, const MemoryOptions& options);
+    ~NumaBuffer();
+
+    NumaBuffer(NumaBuffer&& other) noexcept;
+    NumaBuffer& operator=(NumaBuffer&& other) noexcept;
+    NumaBuffer(const NumaBuffer&) = delete;
+    NumaBuffer& operator=(const NumaBuffer&) = delete;
+
+    uint8_t* data() { return data_; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // True if the mapping is backed by (or advised for) huge pages
+    bool huge_pages() const { return huge_; }
+
+private:
+    void release();
+
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t mapped_size_ = 0;
+    bool huge_ = false;
+};
+
+// NUMA topology, thread placement and access statistics
+namespace numa {
+
+// Per-node counters from /sys/devices/system/node/nodeN/numastat
+struct AccessStats {
+    bool available = false;
+    uint64_t numa_hit = 0;
+    uint64_t numa_miss = 0;
+    uint64_t local_node = 0;
+    uint64_t other_node = 0;
+
+    // Share of allocations served by a remote node
+    double remote_ratio() const {
+        uint64_t total = local_node + other_node;
+        return total > 0 ? static_cast<double>(other_node) / total : 0.0;
+    }
+};
+
+SKYDECODER_API int node_count();
+SKYDECODER_API int current_node();
+SKYDECODER_API std::vector<int> node_cpus(int node);
+
+// Pin the calling thread to all CPUs of a node / to a single CPU
+SKYDECODER_API bool pin_current_thread_to_node(int node);
+SKYDECODER_API bool pin_current_thread_to_cpu(int cpu);
+
+SKYDECODER_API AccessStats read_access_stats(int node);
+
+// Difference between two snapshots of the same node
+SKYDECODER_API AccessStats delta(const AccessStats& before, const AccessStats& after);
+
+SKYDECODER_API std::string to_string(HugePageMode mode);
+SKYDECODER_API HugePageMode huge_page_mode_from_string(const std::string& mode);
+
+} // namespace numa
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include "skydecoder/async_file_writer.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace skydecoder {
+
+struct ParquetOptions {
+    size_t row_group_rows = 65536;          // Rows buffered before a row group is written
+    size_t row_group_bytes = 32 << 20;      // Or buffered value bytes, whichever comes first
+    size_t max_dictionary_size = 1024;      // Enum columns with more distinct values fall back to PLAIN
+};
+
+// Column of a category table: one per field of every item ("I002_010_SAC"),
+// extension fields included. All columns are optional (absent items are nulls).
+struct ParquetColumn {
+    std::string name;
+    std::string item_id;
+    std::string field;
+    int32_t physical_type;                  // Parquet Type: BOOLEAN, INT32, INT64 or BYTE_ARRAY
+    int32_t converted_type;                 // Parquet ConvertedType, -1 for none
+    bool dictionary;                        // Enum field: RLE_DICTIONARY encoded
+};
+
+// Writes the records of one category to an uncompressed Parquet file.
+// Records are transposed into per-column buffers; a row group (one data page
+// per column, preceded by a dictionary page for enum fields) is written each
+// time the buffers reach the options' bounds, so memory stays bounded by a
+// row group. Every column chunk carries min/max statistics and a null count,
+// so engines can prune row groups on ToD or SAC/SIC.
+class SKYDECODER_API ParquetWriter {
+public:
+    explicit ParquetWriter(std::shared_ptr<const AsterixCategory> category, ParquetOptions options = {});
+    ~ParquetWriter();
+
+    ParquetWriter(const ParquetWriter&) = delete;
+    ParquetWriter& operator=(const ParquetWriter&) = delete;
+
+    bool open(const std::string& path);
+
+    // Records of other categories are skipped (returns false)
+    bool write(const AsterixMessage& message);
+    void write(const AsterixBlock& block);
+
+    // Write the pending row group and the footer
+    bool close();
+
+    bool is_open() const { return file_.is_open(); }
+    const std::vector<ParquetColumn>& columns() const { return columns_; }
+    uint64_t rows_written() const { return total_rows_; }
+    size_t row_groups_written() const { return row_groups_.size(); }
+
+private:
+    struct ColumnBuffer {
+        std::vector<uint8_t> defined;       // Definition level of every row
+        std::vector<int64_t> integers;      // BOOLEAN, INT32 and INT64 values
+        std::vector<uint8_t> byte_arrays;   // PLAIN encoded (length prefixed)
+    };
+
+    struct ColumnChunkInfo {
+        int64_t file_offset;
+        int64_t data_page_offset;
+        int64_t dictionary_page_offset;     // -1 without dictionary
+        int64_t num_values;
+        int64_t null_count;
+        int64_t size;
+        bool dictionary_encoded;
+        std::vector<uint8_t> min_value;     // PLAIN encoded, empty if no statistics
+        std::vector<uint8_t> max_value;
+    };
+
+    struct RowGroupInfo {
+        std::vector<ColumnChunkInfo> columns;
+        int64_t num_rows;
+        int64_t total_byte_size;
+    };
+
+    // Columns of an item, matched to the parsed fields by name
+    struct ItemColumns {
+        std::string item_id;
+        std::vector<size_t> columns;
+    };
+
+    void build_columns();
+    void flush_row_group();
+    ColumnChunkInfo write_column_chunk(size_t index);
+    bool write_footer();
+    void write_bytes(const std::vector<uint8_t>& bytes);
+
+    std::shared_ptr<const AsterixCategory> category_;
+    ParquetOptions options_;
+    std::vector<ParquetColumn> columns_;
+    std::vector<ItemColumns> items_;
+
+    AsyncFileWriter file_;                  // Row groups are written off the calling thread
+    int64_t offset_ = 0;
+    bool failed_ = false;
+
+    std::vector<ColumnBuffer> buffers_;
+    size_t buffered_rows_ = 0;
+    size_t buffered_bytes_ = 0;
+    std::vector<RowGroupInfo> row_groups_;
+    uint64_t total_rows_ = 0;
+};
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include "skydecoder/binary_serializer.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace skydecoder {
+
+enum class PartitionFormat {
+    RAW,        // ASTERIX blocks as received (write_raw)
+    CBOR,       // BinarySerializer stream per file, header included
+    MSGPACK
+};
+
+struct PartitionOptions {
+    std::string directory = ".";
+    std::string prefix = "asterix";
+    PartitionFormat format = PartitionFormat::CBOR;
+    double partition_seconds = 3600.0;      // Time span of a file
+    double lateness_seconds = 60.0;         // A file is completed that long after its span ends
+    size_t max_open_files = 64;             // File handles kept by the writer thread (LRU)
+    size_t write_size = 1 << 20;            // Bytes buffered per partition before a write
+    size_t max_queued_bytes = 64 << 20;     // Producers wait beyond this until the writer catches up
+
+    // Time of day item per category (first field, scaled by its lsb)
+    std::unordered_map<uint8_t, std::string> time_items = {
+        {2, "I002/030"}, {21, "I021/073"}, {48, "I048/140"}, {62, "I062/070"}
+    };
+};
+
+struct PartitionStats {
+    uint64_t records = 0;
+    uint64_t blocks = 0;
+    uint64_t partitions_opened = 0;
+    uint64_t partitions_completed = 0;
+    uint64_t writes = 0;
+    uint64_t bytes_written = 0;
+    uint64_t file_opens = 0;                // Including reopens after an eviction
+    uint64_t evictions = 0;
+    uint64_t producer_waits = 0;            // Writes that found the queue full
+    uint64_t errors = 0;
+};
+
+// Splits decoded records (or raw blocks) into files per radar (SAC/SIC of
+// I<cat>/010) and time span of the reconstructed record time, e.g.
+//   asterix_025-013_d000_140000.cbor     SAC 25, SIC 13, day 0, from 14:00:00
+// Records are buffered per partition on the calling thread; full buffers go,
+// in 4 KiB multiples, to a writer thread that keeps at most max_open_files handles open (least
+// recently used closed first) and appends to "<file>.part". Once the latest
+// record time passes the end of a span by the lateness, its files are
+// completed: flushed and renamed to their final name, so readers only ever
+// see whole files. Records without time go to their radar's latest span.
+class SKYDECODER_API PartitionSink {
+public:
+    explicit PartitionSink(PartitionOptions options = {});
+    ~PartitionSink();
+
+    PartitionSink(const PartitionSink&) = delete;
+    PartitionSink& operator=(const PartitionSink&) = delete;
+
+    // CBOR and MSGPACK formats
+    void write(const AsterixMessage& message);
+    void write(const AsterixBlock& block);
+
+    // RAW format: the block goes to the partition of its first record
+    void write_raw(const uint8_t* data, size_t size, const AsterixBlock& decoded);
+
+    // Hand every buffer to the writer and wait until it is on disk
+    void flush();
+
+    // Complete all files and stop the writer; false if any write failed
+    bool close();
+
+    // From the thread that writes
+    PartitionStats stats() const;
+    std::vector<std::string> completed_files() const;
+
+private:
+    struct Partition {
+        uint64_t id = 0;
+        uint16_t radar = 0;
+        int64_t span = 0;                   // Index of the time span since the first midnight
+        std::string path;                   // Final name
+        std::vector<uint8_t> buffer;        // Encoded records not yet handed to the writer
+        std::unique_ptr<BinarySerializer> serializer;   // Its header state is per file
+    };
+
+    struct Command {
+        uint64_t id;
+        std::string path;                   // Final name; the data goes to path + ".part"
+        std::vector<uint8_t> data;
+        bool complete;                      // Rename once written
+    };
+
+    struct OpenFile {
+        std::FILE* file;
+        uint64_t last_use;
+    };
+
+    struct Route {
+        uint16_t radar = 0;
+        bool has_time = false;
+        double time = 0.0;
+    };
+
+    Route route_of(const AsterixMessage& message) const;
+    Partition& partition_for(const Route& route);
+    std::string partition_path(uint16_t radar, int64_t span, uint32_t sequence) const;
+
+    // Queue the buffer (all of it if whole or complete, else its 4 KiB multiple)
+    void hand_over(Partition& partition, bool complete, bool whole);
+    void complete_expired();
+
+    void writer_loop();
+    void execute(Command& command);
+    std::FILE* file_for(const Command& command);
+
+    PartitionOptions options_;
+
+    // Producer side
+    std::unordered_map<uint64_t, Partition> partitions_;     // Key: radar << 32 | span
+    std::unordered_map<uint16_t, double> radar_times_;      // Latest time per radar
+    double watermark_ = -1.0;
+    uint64_t next_id_ = 1;
+    PartitionStats produced_;                               // records, blocks, partitions_opened, errors
+    double next_expiry_ = -1.0;                             // Earliest end + lateness of an open span
+    std::unordered_map<uint64_t, uint32_t> completions_;    // Late records of a completed span go to "_<n>" files
+
+    // Shared with the writer thread
+    mutable std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable space_ready_;
+    std::deque<Command> queue_;
+    size_t queued_bytes_ = 0;
+    bool busy_ = false;
+    bool stopping_ = false;
+    PartitionStats stats_;
+    std::vector<std::string> completed_;
+
+    // Writer thread only
+    std::unordered_map<uint64_t, OpenFile> files_;
+    std::unordered_set<uint64_t> started_;                  // Partitions whose .part file was created
+    uint64_t use_counter_ = 0;
+
+    std::thread writer_;
+    bool closed_ = false;
+};
+
+} // namespace skydecoder
\ No newline at end of file
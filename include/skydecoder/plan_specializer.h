@@ -0,0 +1,46 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace skydecoder {
+
+struct FspecPlan;
+
+// Straight-line decoder for one hot FSPEC pattern. Every field becomes an
+// operation with a fixed byte offset, shift and mask, bound to a kernel
+// pre-instantiated for its byte span and value type, so decoding a record
+// is a loop over function pointers with no per-field dispatch.
+class SKYDECODER_API SpecializedDecoder {
+public:
+    // Specialise an all-FIXED plan; nullptr if any field needs the interpreter
+    // (conditions, extensions, strings, bytes or fields wider than 32 bits)
+    static std::unique_ptr<SpecializedDecoder> build(const FspecPlan& plan);
+
+    // Decode the items of a record; data must hold length() bytes
+    void decode(const uint8_t* data, std::vector<ParsedDataItem>& items) const;
+
+    size_t length() const { return length_; }
+    size_t operation_count() const { return ops_.size(); }
+
+    using Kernel = void (*)(const uint8_t* data, uint32_t shift, uint32_t mask, FieldValue& out);
+
+private:
+    struct Operation {
+        Kernel kernel;
+        uint32_t byte_offset;
+        uint32_t shift;
+        uint32_t mask;
+        uint16_t item;
+        uint16_t field;
+    };
+
+    std::vector<Operation> ops_;
+    std::vector<ParsedDataItem> prototype_;     // Ids, names and field metadata of the items
+    size_t length_ = 0;
+};
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace skydecoder {
+
+struct QuarantineOptions {
+    size_t queue_capacity = 1024;               // Entries in flight (power of two); a full queue drops
+    bool include_record_errors = true;          // Also blocks that decoded with invalid or skipped records
+    uint64_t max_file_bytes = 256ULL << 20;     // Entries beyond are dropped (0: no limit)
+    int flush_interval_ms = 100;                // Longest time an entry waits in the writer's buffer
+};
+
+struct QuarantineStats {
+    uint64_t submitted = 0;
+    uint64_t written = 0;
+    uint64_t bytes_written = 0;
+    uint64_t dropped_queue_full = 0;
+    uint64_t dropped_file_limit = 0;
+    uint64_t errors = 0;
+    uint64_t by_error[8] = {};                  // Submitted, indexed by BlockError
+};
+
+struct QuarantineEntry {
+    uint64_t offset = kUnknownOffset;           // Of the block in its stream
+    uint64_t time_us = 0;                       // Capture time, microseconds since the Unix epoch
+    BlockError error = BlockError::NONE;
+    std::vector<uint8_t> data;                  // The block as received
+};
+
+// Side file for blocks that failed to decode. submit() copies the block and
+// hands it to a writer thread through a bounded lock-free queue; it never
+// waits, and drops the block when the queue is full. The file is "SKYQ",
+// a version, then per block a 24-byte little-endian header (size u32,
+// error u8, 3 reserved, offset u64, time u64) and the raw bytes, so replay()
+// can feed exactly the problematic traffic back to a decoder.
+class SKYDECODER_API QuarantineSink {
+public:
+    explicit QuarantineSink(QuarantineOptions options = {});
+    ~QuarantineSink();
+
+    QuarantineSink(const QuarantineSink&) = delete;
+    QuarantineSink& operator=(const QuarantineSink&) = delete;
+
+    bool open(const std::string& path);
+    bool is_open() const { return open_; }
+
+    // Thread safe and wait-free apart from the copy; false if dropped
+    bool submit(const uint8_t* data, size_t size, uint64_t offset, BlockError error);
+
+    // Submit the block if its error is one to keep
+    bool check(const AsterixBlock& block, const uint8_t* data, size_t size, uint64_t offset);
+
+    // Write what is queued and close the file; false if any write failed
+    bool close();
+
+    QuarantineStats stats() const;
+
+    // Entries in file order; a truncated last entry (crash while writing)
+    // ends the replay. False if the file is unreadable or not a quarantine file.
+    using EntryHandler = std::function<bool(const QuarantineEntry& entry)>;
+    static bool replay(const std::string& path, const EntryHandler& handler);
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        QuarantineEntry* entry;
+    };
+
+    bool push(QuarantineEntry* entry);
+    QuarantineEntry* pop();
+
+    void writer_loop();
+    bool write_entry(const QuarantineEntry& entry);
+
+    QuarantineOptions options_;
+    bool open_ = false;
+    std::FILE* file_ = nullptr;
+    uint64_t file_bytes_ = 0;
+
+    // Bounded multi-producer queue (sequence numbered slots), one consumer
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) size_t tail_ = 0;
+
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> sleeping_{false};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::thread writer_;
+
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> bytes_written_{0};
+    std::atomic<uint64_t> dropped_queue_full_{0};
+    std::atomic<uint64_t> dropped_file_limit_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::atomic<uint64_t> by_error_[8] = {};
+};
+
+} // namespace skydecoder
\ No newline at end of file
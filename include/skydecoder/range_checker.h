@@ -0,0 +1,63 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace skydecoder {
+
+// Range and enum membership check of one field, compiled to raw values
+struct FieldCheck {
+    std::string item_id;
+    std::string field;
+    int64_t raw_min = std::numeric_limits<int64_t>::min();
+    int64_t raw_max = std::numeric_limits<int64_t>::max();
+    std::vector<uint64_t> allowed;      // Bitset of the enum values, empty without an enum set
+    
+    uint64_t checked = 0;
+    uint64_t range_violations = 0;
+    uint64_t enum_violations = 0;
+};
+
+// Counts the decoded values falling outside the min/max attributes or the
+// enum set of their field. Checks are branch-light: one compare pair and one
+// bitset probe per value. Violations are only counted; records stay valid.
+// The checks are resolved to UAP positions and field positions when the
+// checker is built, so check() indexes them by the FRN of each decoded item.
+class SKYDECODER_API RangeChecker {
+public:
+    explicit RangeChecker(const AsterixCategory& category);
+    
+    bool empty() const { return checks_.empty(); }
+    
+    // Check the integer fields of a decoded record
+    void check(const AsterixMessage& message);
+    
+    // Check a column of raw values of checks()[index], e.g. from columnar output
+    void check_column(size_t index, const int64_t* raw, size_t count);
+    
+    const std::vector<FieldCheck>& checks() const { return checks_; }
+    uint64_t total_violations() const;
+    void reset();
+    
+private:
+    // Fields of an item in the order the parser emits them (spares left out,
+    // extension fields after the field carrying their condition)
+    struct ItemPlan {
+        std::vector<const Field*> fields;
+        std::vector<int32_t> checks;        // Index into checks_ per field, -1 if unchecked
+    };
+    
+    void add_checks(const std::string& item_id, const std::vector<Field>& fields,
+                    std::unordered_map<const Field*, int32_t>& check_of_field);
+    void check_item(const ItemPlan& plan, const ParsedDataItem& item);
+    
+    std::vector<FieldCheck> checks_;     // Grouped by item
+    std::vector<ItemPlan> items_;        // By FRN - 1, empty where no field is checked
+    std::unordered_map<std::string, uint16_t> frn_by_id_;   // Items decoded without their FRN
+};
+
+} // namespace skydecoder
\ No newline at end of file
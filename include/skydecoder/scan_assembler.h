@@ -0,0 +1,81 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include "skydecoder/flat_record.h"
+#include "skydecoder/lazy_record.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace skydecoder {
+
+enum class ScanGranularity {
+    SECTOR,     // A batch per sector crossing
+    SCAN        // A batch per antenna revolution (north marker to north marker)
+};
+
+struct ScanAssemblerOptions {
+    ScanGranularity granularity = ScanGranularity::SECTOR;
+    size_t reserve_records = 64;        // Storage preallocated for each radar's batch
+    size_t reserve_bytes = 16384;
+};
+
+// Records of one radar between two CAT002 markers, stored contiguously as
+// flat records (FlatRecordView over records.buffer())
+struct ScanBatch {
+    uint16_t radar = 0;                 // SAC << 8 | SIC
+    uint32_t scan = 0;                  // North markers seen for the radar (0: before the first)
+    int sector = -1;                    // Raw I002/020 of the opening marker (0 after a north marker), -1 if not opened by one
+    double start_time = -1.0;           // ToD of the opening marker in seconds, -1 if unknown
+    double end_time = -1.0;             // ToD of the closing marker in seconds, -1 if unknown
+    bool complete = false;              // Opened and closed by markers
+    FlatRecordWriter records;
+};
+
+// Groups a record stream per radar (SAC/SIC of I<cat>/010) into scan or
+// sector batches. CAT002 north markers (message type 1) and sector crossings
+// (type 2) close the radar's open batch and open the next one with the
+// marker as first record; other records, of any category, are appended to
+// the open batch of their radar. Completed batches are handed to the handler
+// whole, then their storage is reused, so the batches allocate nothing in the
+// steady state. A lazy record still decodes its items into its own cache
+// (one allocation per item) before they are written to the batch.
+class SKYDECODER_API ScanAssembler {
+public:
+    using BatchHandler = std::function<void(const ScanBatch&)>;
+
+    explicit ScanAssembler(BatchHandler handler, ScanAssemblerOptions options = {});
+
+    void add(const AsterixMessage& message);
+    void add(const AsterixBlock& block);
+    void add(const FlatRecordView& record);
+    void add(LazyRecord& record);       // Markers read from the raw bytes, items decoded straight into the batch
+
+    // Hand out the open batches (as incomplete) and start over
+    void flush();
+
+    uint64_t batches_emitted() const { return batches_emitted_; }
+    size_t radar_count() const { return batches_.size(); }
+
+private:
+    struct Marker {
+        uint16_t radar = 0;
+        int message_type = -1;
+        int sector = -1;
+        double time = -1.0;
+    };
+
+    template <typename Append>
+    void route(const Marker& marker, Append&& append);
+
+    ScanBatch& batch_for(uint16_t radar);
+    void emit(ScanBatch& batch, double end_time, bool closed_by_marker);
+
+    BatchHandler handler_;
+    ScanAssemblerOptions options_;
+    std::unordered_map<uint16_t, std::unique_ptr<ScanBatch>> batches_;
+    uint64_t batches_emitted_ = 0;
+};
+
+} // namespace skydecoder
\ No newline at end of file
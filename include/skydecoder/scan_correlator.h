@@ -0,0 +1,117 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include "skydecoder/flat_record.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace skydecoder {
+
+struct CorrelatorOptions {
+    size_t boundaries_per_radar = 256;      // Ring of recent scan/sector boundaries per radar
+    size_t scans_retained = 4;              // Scans kept open for late records before their summary is emitted
+    size_t max_sectors = 256;               // Sector counters per scan (raw I002/020 is 8 bits)
+
+    // Time of day item of each category (first field, seconds after lsb)
+    std::unordered_map<uint8_t, std::string> time_items = {
+        {1, "I001/141"}, {10, "I010/140"}, {21, "I021/073"}, {48, "I048/140"}, {62, "I062/070"}
+    };
+    std::vector<uint8_t> track_categories = {62};   // Others are counted as plots
+};
+
+// Where a plot or track record falls in its radar's scans
+struct Correlation {
+    bool matched = false;
+    uint16_t radar = 0;                     // SAC << 8 | SIC
+    uint32_t scan = 0;
+    int sector = 0;                         // Raw I002/020 of the sector, 0 after the north marker
+    double sector_start = 0.0;              // ToD of the boundary opening the sector
+    double delay = 0.0;                     // Latest marker time of the radar minus the record time
+};
+
+// Per-scan counts, emitted when the scan leaves the retention window
+struct ScanSummary {
+    uint16_t radar = 0;
+    uint32_t scan = 0;
+    double start_time = 0.0;
+    uint64_t plots = 0;
+    uint64_t tracks = 0;
+    std::vector<uint32_t> sector_records;   // Indexed by raw sector value
+    double min_delay = 0.0;
+    double max_delay = 0.0;
+    double total_delay = 0.0;
+
+    double mean_delay() const { return plots + tracks ? total_delay / static_cast<double>(plots + tracks) : 0.0; }
+};
+
+struct CorrelatorStats {
+    uint64_t markers = 0;
+    uint64_t matched = 0;
+    uint64_t too_old = 0;                   // Older than the boundary ring or the retained scans
+    uint64_t unmatched = 0;                 // No radar marker yet, or no time
+};
+
+// Windowed join of plot and track records with the CAT002 scan and sector
+// boundaries of their radar, keyed by SAC/SIC and time of day. Each radar
+// has fixed-size rings (boundaries, retained scans) behind its own mutex and
+// radars are found through a lock-free table, so records of different radars
+// never contend. Times wrapping at midnight are not handled.
+class SKYDECODER_API ScanCorrelator {
+public:
+    using SummaryHandler = std::function<void(const ScanSummary&)>;
+
+    explicit ScanCorrelator(SummaryHandler handler = nullptr, CorrelatorOptions options = {});
+    ~ScanCorrelator();
+
+    ScanCorrelator(const ScanCorrelator&) = delete;
+    ScanCorrelator& operator=(const ScanCorrelator&) = delete;
+
+    // CAT002 records update the boundaries, other records are correlated
+    Correlation add(const AsterixMessage& message);
+    Correlation add(const FlatRecordView& record);
+
+    // The same with the keys already extracted
+    void add_marker(uint16_t radar, int message_type, int sector, double time);
+    Correlation add_record(uint16_t radar, uint8_t category, double time);
+
+    // Emit the summaries of all retained scans
+    void flush();
+
+    CorrelatorStats stats() const;
+
+private:
+    struct Boundary {
+        double time;
+        uint32_t scan;
+        int sector;
+    };
+
+    struct RadarState {
+        std::mutex mutex;
+        std::vector<Boundary> boundaries;   // Ring
+        size_t next = 0;
+        size_t count = 0;
+        uint32_t scan = 0;
+        double latest_time = 0.0;
+        std::vector<ScanSummary> scans;     // Ring indexed by scan % scans_retained
+        std::vector<bool> scan_open;
+        CorrelatorStats stats;
+    };
+
+    RadarState& radar_state(uint16_t radar);
+    void emit(RadarState& state, size_t slot);
+    bool is_track(uint8_t category) const;
+    double time_lsb(const AsterixMessage& message, const std::string& item_id) const;
+
+    SummaryHandler handler_;
+    CorrelatorOptions options_;
+    std::unique_ptr<std::atomic<RadarState*>[]> radars_;   // 65536 entries, created on first use
+};
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace skydecoder {
+
+// 64-bit mix of a key (splitmix64 finaliser), used by all sketches
+inline uint64_t sketch_hash(uint64_t key) {
+    key += 0x9E3779B97F4A7C15ULL;
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+    return key ^ (key >> 31);
+}
+
+// Frequency upper bounds in width * depth counters; estimates exceed the
+// true count by at most 2 * total / width with probability 1 - 2^-depth.
+// Sketches of the same dimensions merge by adding their counters.
+class SKYDECODER_API CountMinSketch {
+public:
+    explicit CountMinSketch(size_t width = 1024, size_t depth = 4);
+
+    void add(uint64_t key, uint64_t count = 1);
+    uint64_t estimate(uint64_t key) const;
+    uint64_t total() const { return total_; }
+
+    // False if the dimensions differ
+    bool merge(const CountMinSketch& other);
+    void clear();
+
+    // Saved state, e.g. for checkpoints; deserialize() returns false on malformed input
+    std::vector<uint8_t> serialize() const;
+    bool deserialize(const uint8_t* data, size_t size);
+
+private:
+    size_t width_;      // Power of two
+    size_t depth_;
+    std::vector<uint64_t> counters_;
+    uint64_t total_ = 0;
+};
+
+// Space-Saving top-k summary with a fixed number of counters. Every key
+// counted more than total / capacity times is kept; count is an upper bound
+// of the true count and count - error a lower bound.
+class SKYDECODER_API SpaceSaving {
+public:
+    struct Entry {
+        uint64_t key;
+        uint64_t count;
+        uint64_t error;
+    };
+
+    explicit SpaceSaving(size_t capacity = 64);
+
+    void add(uint64_t key, uint64_t count = 1);
+
+    // Largest counts first
+    std::vector<Entry> top(size_t n) const;
+
+    // Keys missing from a full summary are assumed to have its smallest count
+    void merge(const SpaceSaving& other);
+    void clear();
+
+    // Saved state, e.g. for checkpoints; deserialize() returns false on malformed input
+    std::vector<uint8_t> serialize() const;
+    bool deserialize(const uint8_t* data, size_t size);
+
+    size_t size() const { return entries_.size(); }
+    size_t capacity() const { return capacity_; }
+
+private:
+    uint64_t min_count() const;
+    size_t min_slot() const;
+
+    size_t capacity_;
+    std::vector<Entry> entries_;
+    std::unordered_map<uint64_t, uint32_t> slots_;  // Key to entry, at most capacity entries
+};
+
+// Space-Saving candidates whose counts are tightened by a Count-Min sketch
+class SKYDECODER_API HeavyHitters {
+public:
+    explicit HeavyHitters(size_t capacity = 64, size_t width = 1024, size_t depth = 4)
+        : candidates_(capacity), frequencies_(width, depth) {}
+
+    void add(uint64_t key, uint64_t count = 1) {
+        candidates_.add(key, count);
+        frequencies_.add(key, count);
+    }
+
+    std::vector<SpaceSaving::Entry> top(size_t n) const;
+    uint64_t estimate(uint64_t key) const { return frequencies_.estimate(key); }
+    uint64_t total() const { return frequencies_.total(); }
+
+    bool merge(const HeavyHitters& other);
+    void clear();
+
+    // Saved state, e.g. for checkpoints; deserialize() returns false on malformed input
+    std::vector<uint8_t> serialize() const;
+    bool deserialize(const uint8_t* data, size_t size);
+
+private:
+    SpaceSaving candidates_;
+    CountMinSketch frequencies_;
+};
+
+// Distinct count in 2^precision one-byte registers (standard error about
+// 1.04 / sqrt(2^precision), 1.6% at the default). Merging takes the
+// register-wise maximum.
+class SKYDECODER_API HyperLogLog {
+public:
+    explicit HyperLogLog(unsigned precision = 12);
+
+    void add(uint64_t key) { add_hash(sketch_hash(key)); }
+    void add_hash(uint64_t hash);
+
+    double estimate() const;
+
+    // False if the precisions differ
+    bool merge(const HyperLogLog& other);
+    void clear();
+
+    // Saved state, e.g. for checkpoints; deserialize() returns false on malformed input
+    std::vector<uint8_t> serialize() const;
+    bool deserialize(const uint8_t* data, size_t size);
+
+private:
+    unsigned precision_;
+    std::vector<uint8_t> registers_;
+};
+
+} // namespace skydecoder
\ No newline at end of file
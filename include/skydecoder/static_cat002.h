@@ -0,0 +1,189 @@
+#pragma once
+
+// Generated from the XML definition of category 002 (Monoradar Service Messages, version 1.2)
+#include "skydecoder/static_category.h"
+
+namespace skydecoder {
+namespace static_categories {
+
+inline constexpr const char* cat002_uap[] = {
+    "I002/010",
+    "I002/000",
+    "I002/020",
+    "I002/030",
+    "I002/041",
+    "I002/050",
+    "I002/060",
+    "spare",
+    "I002/070",
+    "I002/100",
+    "I002/090",
+    "I002/080",
+    "spare",
+    "I002/SP",
+    "I002/RE",
+};
+
+inline constexpr StaticEnum cat002_i002_000_message_type_enums[] = {
+    {1, "North marker message"},
+    {2, "Sector crossing message"},
+    {3, "South marker message"},
+    {8, "Activation of blind zone filtering"},
+    {9, "Stop of blind zone filtering"},
+};
+
+inline constexpr StaticField cat002_i002_000_fields[] = {
+    {"MESSAGE_TYPE", FieldType::UINT8, 8, "Message Type", 1, Unit::NONE,
+     cat002_i002_000_message_type_enums, 5, nullptr, nullptr, nullptr, 0},
+};
+
+inline constexpr StaticField cat002_i002_010_fields[] = {
+    {"SAC", FieldType::UINT8, 8, "System Area Code", 1, Unit::NONE,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+    {"SIC", FieldType::UINT8, 8, "System Identification Code", 1, Unit::NONE,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+};
+
+inline constexpr StaticField cat002_i002_020_fields[] = {
+    {"SECTOR", FieldType::UINT8, 8, "Antenna azimuth (8 MSB)", 1.40625, Unit::DEGREES,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+};
+
+inline constexpr StaticField cat002_i002_030_fields[] = {
+    {"ToD", FieldType::UINT24, 24, "Time of Day in seconds", 0.0078125, Unit::SECONDS,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+};
+
+inline constexpr StaticField cat002_i002_041_fields[] = {
+    {"ARP", FieldType::UINT16, 16, "Antenna Rotation Period", 0.0078125, Unit::SECONDS,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+};
+
+inline constexpr StaticField cat002_i002_050_fields[] = {
+    {"FX", FieldType::BOOL, 1, "Field Extension", 1, Unit::NONE,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+};
+
+inline constexpr StaticField cat002_i002_060_fields[] = {
+    {"FX", FieldType::BOOL, 1, "Field Extension", 1, Unit::NONE,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+};
+
+inline constexpr StaticField cat002_i002_070_fields[] = {
+    {"REP", FieldType::UINT8, 8, "Repetition factor", 1, Unit::NONE,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+};
+
+inline constexpr StaticField cat002_i002_080_fx_ext_fields[] = {
+    {"WE_VALUE2", FieldType::UINT7, 7, "Second warning/error condition value", 1, Unit::NONE,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+    {"FX2", FieldType::BOOL, 1, "Field Extension", 1, Unit::NONE,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+};
+
+inline constexpr StaticField cat002_i002_080_fields[] = {
+    {"WE_VALUE", FieldType::UINT7, 7, "Warning/error condition value", 1, Unit::NONE,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+    {"FX", FieldType::BOOL, 1, "Field Extension", 1, Unit::NONE,
+     nullptr, 0, nullptr, "FX==1", cat002_i002_080_fx_ext_fields, 2},
+};
+
+inline constexpr StaticField cat002_i002_090_fields[] = {
+    {"RANGE_ERROR", FieldType::INT8, 8, "Range Error", 0.0078125, Unit::NAUTICAL_MILES,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+    {"AZIMUTH_ERROR", FieldType::INT8, 8, "Azimuth Error", 0.0054931640625, Unit::DEGREES,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+};
+
+inline constexpr StaticField cat002_i002_100_fields[] = {
+    {"RHO_START", FieldType::UINT16, 16, "Start Range", 0.0078125, Unit::NAUTICAL_MILES,
+     nullptr, 0, nullptr, nullptr, nullptr, 0,
+     false, 0, true, 512},
+    {"RHO_END", FieldType::UINT16, 16, "End Range", 0.0078125, Unit::NAUTICAL_MILES,
+     nullptr, 0, nullptr, nullptr, nullptr, 0,
+     false, 0, true, 512},
+    {"THETA_START", FieldType::UINT16, 16, "Start Azimuth", 0.0054931640625, Unit::DEGREES,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+    {"THETA_END", FieldType::UINT16, 16, "End Azimuth", 0.0054931640625, Unit::DEGREES,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+};
+
+inline constexpr StaticField cat002_i002_re_fields[] = {
+    {"N", FieldType::UINT8, 8, "Number of Data Fields following", 1, Unit::NONE,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+    {"rfs_data", FieldType::BYTES, 0, "RFS organized data fields", 1, Unit::NONE,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+};
+
+inline constexpr StaticField cat002_i002_sp_fields[] = {
+    {"data", FieldType::BYTES, 0, "Special purpose data", 1, Unit::NONE,
+     nullptr, 0, nullptr, nullptr, nullptr, 0},
+};
+
+inline constexpr StaticDataItem cat002_items[] = {
+    {"I002/000", "Message Type",
+     "This Data Item allows for a more convenient handling of the messages at the receiver side by further defining the type of transaction",
+     DataFormat::FIXED, 1, cat002_i002_000_fields, 1},
+    {"I002/010", "Data Source Identifier",
+     "Identification of the radar station from which the data are received",
+     DataFormat::FIXED, 2, cat002_i002_010_fields, 2},
+    {"I002/020", "Sector Number",
+     "Eight most significant bits of the antenna azimuth defining a particular azimuth sector",
+     DataFormat::FIXED, 1, cat002_i002_020_fields, 1},
+    {"I002/030", "Time of Day",
+     "Absolute time stamping expressed as UTC time",
+     DataFormat::FIXED, 3, cat002_i002_030_fields, 1},
+    {"I002/041", "Antenna Rotation Period",
+     "Antenna rotation period as measured between two consecutive North crossings or as averaged during a period of time",
+     DataFormat::FIXED, 2, cat002_i002_041_fields, 1},
+    {"I002/050", "Station Configuration Status",
+     "Information concerning the use and status of some vital hardware components of the radar system",
+     DataFormat::VARIABLE, 0, cat002_i002_050_fields, 1},
+    {"I002/060", "Station Processing Mode",
+     "Details concerning the present status with respect to processing parameters and options",
+     DataFormat::VARIABLE, 0, cat002_i002_060_fields, 1},
+    {"I002/070", "Plot Count Values",
+     "Plot count values according to various plot categories, either for the last full antenna scan or for the last sector processed",
+     DataFormat::REPETITIVE, 0, cat002_i002_070_fields, 1},
+    {"I002/080", "Warning/Error Conditions",
+     "Warning/error conditions affecting the functioning of the radar system itself",
+     DataFormat::VARIABLE, 0, cat002_i002_080_fields, 2},
+    {"I002/090", "Collimation Error",
+     "Averaged difference in range and in azimuth for the primary target position with respect to the SSR target position as calculated by the radar station",
+     DataFormat::FIXED, 2, cat002_i002_090_fields, 2},
+    {"I002/100", "Dynamic Window - Type 1",
+     "Signals the activation of a certain selective filtering function and in a polar coordinates system the respective geographical areas",
+     DataFormat::FIXED, 8, cat002_i002_100_fields, 4},
+    {"I002/RE", "Random Field Sequencing",
+     "Random Field Sequencing organized field",
+     DataFormat::EXPLICIT, 0, cat002_i002_re_fields, 2},
+    {"I002/SP", "Special Purpose Field",
+     "Special Purpose Field",
+     DataFormat::EXPLICIT, 0, cat002_i002_sp_fields, 1},
+};
+
+inline constexpr StaticValidationRule cat002_validation_rules[] = {
+    {"I002/010", "mandatory", nullptr},
+    {"I002/000", "mandatory", nullptr},
+    {"I002/020", "conditional", "message_type == 2"},
+    {"I002/100", "conditional", "message_type == 8"},
+    {"I002/030", "optional", nullptr},
+    {"I002/041", "conditional", "message_type == 1 || message_type == 2 && sector == 0"},
+    {"I002/070", "conditional", "message_type == 1 || message_type == 2 && sector == 0"},
+    {"I002/090", "conditional", "message_type == 1 || message_type == 2 && sector == 0"},
+};
+
+inline constexpr StaticCategory kCat002 = {
+    2, "Monoradar Service Messages",
+    "Service messages from monoradar stations (sector crossing, North/South markers, blind zone filtering)",
+    "1.2", "2024-03-15",
+    cat002_uap, 15,
+    cat002_items, 13,
+    cat002_validation_rules, 8
+};
+
+// UAP positions resolved at compile time
+inline constexpr auto kCat002Plan = make_static_plan<15>(kCat002);
+
+} // namespace static_categories
+} // namespace skydecoder
\ No newline at end of file
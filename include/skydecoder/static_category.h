@@ -0,0 +1,144 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Category definitions as constexpr tables. They are compiled into the binary
+// (no XML parsing, no filesystem access) and are either hand-written or
+// produced from an XML definition by generate_static_category_source().
+namespace skydecoder {
+
+struct StaticEnum {
+    uint32_t value;
+    const char* description;
+};
+
+struct StaticField {
+    const char* name;
+    FieldType type;
+    uint8_t bits;
+    const char* description;
+    double lsb;
+    Unit unit;
+    const StaticEnum* enums;
+    size_t enum_count;
+    const char* encoding;               // nullptr if none
+    const char* condition;              // nullptr if no extension
+    const StaticField* extension_fields;
+    size_t extension_count;
+    bool has_min = false;               // Valid range in the field unit
+    double min_value = 0.0;
+    bool has_max = false;
+    double max_value = 0.0;
+};
+
+struct StaticDataItem {
+    const char* id;
+    const char* name;
+    const char* definition;
+    DataFormat format;
+    uint16_t length;                    // 0 if the format has no length
+    const StaticField* fields;
+    size_t field_count;
+};
+
+struct StaticValidationRule {
+    const char* field;
+    const char* type;
+    const char* condition;              // nullptr if none
+};
+
+struct StaticCategory {
+    uint8_t category;
+    const char* name;
+    const char* description;
+    const char* version;
+    const char* date;
+    const char* const* uap;
+    size_t uap_size;
+    const StaticDataItem* items;
+    size_t item_count;
+    const StaticValidationRule* validation_rules;
+    size_t validation_rule_count;
+};
+
+constexpr bool static_name_equal(const char* a, const char* b) noexcept {
+    while (*a && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+// Data item of a static category by id, nullptr if not defined
+constexpr const StaticDataItem* find_static_item(const StaticCategory& category, const char* id) noexcept {
+    for (size_t i = 0; i < category.item_count; ++i) {
+        if (static_name_equal(category.items[i].id, id)) {
+            return &category.items[i];
+        }
+    }
+    return nullptr;
+}
+
+// Bit offset of a field within its data item
+constexpr size_t static_field_offset(const StaticDataItem& item, size_t field_index) noexcept {
+    size_t offset = 0;
+    for (size_t i = 0; i < field_index && i < item.field_count; ++i) {
+        offset += item.fields[i].bits;
+    }
+    return offset;
+}
+
+// Resolved UAP position of a compile-time decode plan
+struct StaticPlanEntry {
+    const StaticDataItem* item = nullptr;   // nullptr for spare or undefined positions
+    uint16_t fixed_length = 0;              // Item length if the format is FIXED, 0 otherwise
+};
+
+// UAP of a static category resolved at compile time, for static_asserts on a
+// definition and for custom decoders that want item lengths as constants.
+// AsterixDecoder does not use it: load_static_category() decodes through the
+// same AsterixCategory as an XML definition.
+template <size_t N>
+struct StaticPlan {
+    StaticPlanEntry entries[N] = {};
+
+    static constexpr size_t size() noexcept { return N; }
+
+    // Length of the items of a record if the FSPEC only selects fixed items, 0 otherwise
+    constexpr size_t fixed_record_length(const uint8_t* fspec, size_t fspec_length) const noexcept {
+        size_t length = 0;
+        bool all_fixed = true;
+        core::for_each_fspec_item(fspec, fspec_length, N, [&](size_t uap_index) {
+            if (entries[uap_index].fixed_length == 0) {
+                all_fixed = false;
+            }
+            length += entries[uap_index].fixed_length;
+        });
+        return all_fixed ? length : 0;
+    }
+};
+
+template <size_t N>
+constexpr StaticPlan<N> make_static_plan(const StaticCategory& category) noexcept {
+    StaticPlan<N> plan;
+    for (size_t i = 0; i < N && i < category.uap_size; ++i) {
+        const StaticDataItem* item = find_static_item(category, category.uap[i]);
+        plan.entries[i].item = item;
+        if (item && item->format == DataFormat::FIXED) {
+            plan.entries[i].fixed_length = item->length;
+        }
+    }
+    return plan;
+}
+
+// Runtime definition equivalent to a static one, built on the heap without XML
+// parsing or file access (used by AsterixDecoder::load_static_category)
+SKYDECODER_API AsterixCategory to_category(const StaticCategory& definition);
+
+// C++ header declaring a category as constexpr tables, e.g. from an XML-loaded definition
+SKYDECODER_API std::string generate_static_category_source(const AsterixCategory& category);
+
+} // namespace skydecoder
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "asterix_types.h"
+#include "sketches.h"
 #include <string>
 #include <vector>
 #include <sstream>
@@ -12,33 +13,39 @@ namespace skydecoder {
 namespace utils {
 
 // Conversion and formatting
-std::string to_hex_string(const std::vector<uint8_t>& data);
-std::string to_hex_string(uint32_t value, size_t width = 0);
-std::vector<uint8_t> from_hex_string(const std::string& hex);
+SKYDECODER_API std::string to_hex_string(const std::vector<uint8_t>& data);
+SKYDECODER_API std::string to_hex_string(uint32_t value, size_t width = 0);
+SKYDECODER_API std::vector<uint8_t> from_hex_string(const std::string& hex);
 
 // Value formatting according to unit
-std::string format_value(const FieldValue& value, Unit unit, double lsb = 1.0);
-std::string format_time_of_day(uint32_t tod_value, double lsb);
-std::string format_coordinates(double latitude, double longitude);
-std::string format_flight_level(uint16_t fl_value, double lsb);
+SKYDECODER_API std::string format_value(const FieldValue& value, Unit unit, double lsb = 1.0);
+SKYDECODER_API std::string format_time_of_day(uint32_t tod_value, double lsb);
+SKYDECODER_API std::string format_coordinates(double latitude, double longitude);
+SKYDECODER_API std::string format_flight_level(uint16_t fl_value, double lsb);
 
 // Data validation
-bool validate_checksum(const std::vector<uint8_t>& data);
-bool is_valid_mode_a_code(uint16_t code);
-bool is_valid_callsign(const std::string& callsign);
+SKYDECODER_API bool validate_checksum(const std::vector<uint8_t>& data);
+SKYDECODER_API bool is_valid_mode_a_code(uint16_t code);
+SKYDECODER_API bool is_valid_callsign(const std::string& callsign);
 
 // Unit conversion
-double nautical_miles_to_meters(double nm);
-double meters_to_nautical_miles(double meters);
-double degrees_to_radians(double degrees);
-double radians_to_degrees(double radians);
-double flight_level_to_feet(double fl);
-double feet_to_flight_level(double feet);
+SKYDECODER_API double nautical_miles_to_meters(double nm);
+SKYDECODER_API double meters_to_nautical_miles(double meters);
+SKYDECODER_API double degrees_to_radians(double degrees);
+SKYDECODER_API double radians_to_degrees(double radians);
+SKYDECODER_API double flight_level_to_feet(double fl);
+SKYDECODER_API double feet_to_flight_level(double feet);
 
 // Bit utilities
-uint32_t extract_bits_from_bytes(const std::vector<uint8_t>& data, size_t start_bit, size_t num_bits);
-void set_bits_in_bytes(std::vector<uint8_t>& data, size_t start_bit, size_t num_bits, uint32_t value);
-std::string bits_to_string(const std::vector<uint8_t>& data);
+SKYDECODER_API uint32_t extract_bits_from_bytes(const std::vector<uint8_t>& data, size_t start_bit, size_t num_bits);
+SKYDECODER_API void set_bits_in_bytes(std::vector<uint8_t>& data, size_t start_bit, size_t num_bits, uint32_t value);
+SKYDECODER_API std::string bits_to_string(const std::vector<uint8_t>& data);
+
+// SIMD kernels of the active ISA (see force_isa)
+// Length of the FSPEC at data, 0 if no byte within size has FX=0
+SKYDECODER_API size_t fspec_length(const uint8_t* data, size_t size);
+// Consecutive 6-bit codes, MSB first (ICAO characters)
+SKYDECODER_API std::vector<uint8_t> unpack_6bit(const std::vector<uint8_t>& data);
 
 // Statistical analysis
 struct MessageStatistics {
@@ -46,21 +53,34 @@ struct MessageStatistics {
     size_t valid_messages = 0;
     size_t invalid_messages = 0;
     std::unordered_map<uint8_t, size_t> category_counts;
-    std::unordered_map<std::string, size_t> data_item_counts;
-    std::vector<std::string> errors;
+    std::unordered_map<std::string, size_t> data_item_counts;     // Bounded by the items of the definitions
+    
+    // Invalid records per error message, for the first kMaxErrorMessages distinct
+    // messages; the records with any other message are counted in other_errors
+    static constexpr size_t kMaxErrorMessages = 64;
+    std::unordered_map<std::string, size_t> error_counts;
+    size_t other_errors = 0;
+    
+    // Fixed-size sketches for long horizons
+    HeavyHitters warning_codes;         // I002/080 WE_VALUE values
+    HeavyHitters fspec_patterns;        // FSPEC bytes packed big-endian, first byte highest
+    HyperLogLog radars;                 // Distinct SAC << 8 | SIC
 };
 
-MessageStatistics analyze_messages(const std::vector<AsterixMessage>& messages);
-void print_statistics(const MessageStatistics& stats);
+SKYDECODER_API MessageStatistics analyze_messages(const std::vector<AsterixMessage>& messages);
+SKYDECODER_API void accumulate_statistics(MessageStatistics& stats, const AsterixMessage& message);
+// Combine statistics of other threads or files
+SKYDECODER_API void merge_statistics(MessageStatistics& stats, const MessageStatistics& other);
+SKYDECODER_API void print_statistics(const MessageStatistics& stats);
 
 // JSON serialization
-std::string to_json(const AsterixMessage& message);
-std::string to_json(const AsterixBlock& block);
-std::string to_json(const ParsedField& field);
-std::string to_json(const ParsedDataItem& item);
+SKYDECODER_API std::string to_json(const AsterixMessage& message);
+SKYDECODER_API std::string to_json(const AsterixBlock& block);
+SKYDECODER_API std::string to_json(const ParsedField& field);
+SKYDECODER_API std::string to_json(const ParsedDataItem& item);
 
 // Performance profiling
-class PerformanceProfiler {
+class SKYDECODER_API PerformanceProfiler {
 public:
     void start_timer(const std::string& name);
     void stop_timer(const std::string& name);
@@ -78,7 +98,7 @@ private:
 };
 
 // Cache for category definitions
-class CategoryCache {
+class SKYDECODER_API CategoryCache {
 public:
     void add_category(uint8_t category, std::unique_ptr<AsterixCategory> definition);
     const AsterixCategory* get_category(uint8_t category) const;
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "skydecoder/asterix_types.h"
+#include "skydecoder/lazy_record.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace skydecoder {
+
+enum class AggregateKind {
+    COUNT,      // Records of the group, or records carrying the field if one is given
+    MIN,
+    MAX,
+    SUM,
+    AVG
+};
+
+// A field of a data item, e.g. {"I002/010", "SAC"}
+struct FieldRef {
+    std::string item_id;
+    std::string field;
+};
+
+struct AggregateSpec {
+    AggregateKind kind = AggregateKind::COUNT;
+    FieldRef source;                            // Empty item id for COUNT of records
+};
+
+struct WindowOptions {
+    double size = 60.0;                         // Window length in seconds
+    double slide = 0.0;                         // Hop between window starts; 0 or size: tumbling
+    double allowed_lateness = 0.0;              // Seconds a window stays open past its end
+    FieldRef time = {"I002/030", "ToD"};
+    std::vector<FieldRef> group_by = {{"I002/010", "SAC"}, {"I002/010", "SIC"}};
+    std::vector<AggregateSpec> aggregates = {{AggregateKind::COUNT, {}}};
+    size_t expected_keys = 256;                 // Groups per window preallocated
+};
+
+// One group of one window. Key values are raw, aggregates of fields are
+// scaled by the field lsb; MIN/MAX/AVG are NaN if no record had the field.
+struct WindowResult {
+    double start = 0.0;                         // Reconstructed time, seconds since the first midnight
+    double end = 0.0;
+    const std::vector<uint64_t>* key = nullptr; // One value per group-by field, 0 if absent
+    const std::vector<double>* values = nullptr;
+    uint64_t records = 0;
+};
+
+struct WindowStats {
+    uint64_t records = 0;
+    uint64_t aggregated = 0;
+    uint64_t late = 0;                          // Only for already emitted windows
+    uint64_t no_time = 0;
+    uint64_t other_category = 0;
+    uint64_t windows_emitted = 0;
+    uint64_t results_emitted = 0;
+};
+
+// Tumbling or sliding (hopping) window aggregation driven by the record
+// time item, grouped by a few raw field values. Each open window owns a
+// preallocated open-addressing table of group states, reused once the window
+// is emitted. A window is emitted, group by group in first-seen order, when
+// the latest record time passes its end by the allowed lateness. Each time of
+// day is placed on the day nearest the latest time, so midnight is crossed
+// once that time itself crosses it. Lazy records
+// only decode the items of the time, group-by and aggregate fields.
+class SKYDECODER_API WindowAggregator {
+public:
+    using ResultHandler = std::function<void(const WindowResult&)>;
+
+    // Throws std::runtime_error if an item or field is not in the category
+    WindowAggregator(const AsterixCategory& category, ResultHandler handler, WindowOptions options = {});
+    ~WindowAggregator();
+
+    WindowAggregator(const WindowAggregator&) = delete;
+    WindowAggregator& operator=(const WindowAggregator&) = delete;
+
+    void add(const AsterixMessage& message);
+    void add(const AsterixBlock& block);
+    void add(LazyRecord& record);
+
+    // Emit all open windows
+    void flush();
+
+    const WindowStats& stats() const { return stats_; }
+
+private:
+    struct Source {
+        std::string item_id;
+        std::string field;
+        double lsb = 1.0;
+        int slot = -1;                          // Index in the record's distinct items
+    };
+
+    struct Accumulator {
+        double min;
+        double max;
+        double sum;
+        uint64_t count;
+    };
+
+    struct Window;
+
+    Source resolve(const AsterixCategory& category, const FieldRef& ref, bool allow_empty);
+
+    // Extracted values of one record
+    void reset_values();
+    void take(const ParsedDataItem& item, int slot);
+    void aggregate();
+
+    Window* window_for(int64_t index);
+    void emit(Window& window);
+    void advance(double time);
+
+    ResultHandler handler_;
+    WindowOptions options_;
+    uint8_t category_ = 0;
+    double slide_ = 0.0;
+
+    Source time_;
+    std::vector<Source> group_by_;
+    std::vector<Source> aggregates_;
+    std::vector<std::string> items_;            // Distinct items to extract, sources point into it
+
+    // Values of the record being added
+    double record_time_ = 0.0;
+    bool has_time_ = false;
+    std::vector<uint64_t> key_;
+    std::vector<double> values_;
+    std::vector<bool> present_;
+
+    double watermark_ = -1.0;
+    int64_t emitted_below_ = INT64_MIN;         // Windows with a lower index are closed
+
+    std::vector<std::unique_ptr<Window>> open_; // Ascending index
+    std::vector<std::unique_ptr<Window>> spare_;
+    std::vector<uint64_t> result_key_;
+    std::vector<double> result_values_;
+
+    WindowStats stats_;
+};
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "skydecoder/export.h"
+#include "skydecoder/numa_buffer.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace skydecoder {
+
+// Fixed set of threads running index ranges in parallel. The calling thread
+// takes part as worker 0. With MemoryOptions::pin_threads the workers are
+// spread over the CPUs of numa_node.
+class SKYDECODER_API WorkerPool {
+public:
+    explicit WorkerPool(size_t threads = 0, const MemoryOptions& options = {});   // 0: one per CPU
+    ~WorkerPool();
+    
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    
+    // Run task(worker, index) for every index in [0, count) and wait for all of
+    // them; indices are handed out in chunks of grain
+    void parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& task);
+    
+    size_t size() const { return threads_.size() + 1; }
+    
+private:
+    void worker_loop(size_t worker, const MemoryOptions& options);
+    void run_chunks(size_t worker);
+    
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable work_done_;
+    
+    // Current job
+    const std::function<void(size_t, size_t)>* task_ = nullptr;
+    size_t count_ = 0;
+    size_t grain_ = 1;
+    std::atomic<size_t> next_{0};
+    size_t generation_ = 0;
+    size_t active_ = 0;             // Workers still running the current job
+    bool stopping_ = false;
+};
+
+} // namespace skydecoder
\ No newline at end of file
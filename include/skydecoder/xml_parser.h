@@ -12,7 +12,7 @@ namespace tinyxml2 {
 
 namespace skydecoder {
 
-class XmlParser {
+class SKYDECODER_API XmlParser {
 public:
     XmlParser();
     ~XmlParser();
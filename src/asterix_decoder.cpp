@@ -1,5 +1,8 @@
 #include "skydecoder/asterix_decoder.h"
 #include "skydecoder/field_parser.h"
+#include "skydecoder/quarantine_sink.h"
+#include "skydecoder/utils.h"
+#include "kernels.h"
 #include <fstream>
 #include <filesystem>
 #include <iostream>
@@ -7,6 +10,19 @@
 
 namespace skydecoder {
 
+const char* to_string(BlockError error) {
+    switch (error) {
+        case BlockError::NONE: return "none";
+        case BlockError::TOO_SHORT: return "too_short";
+        case BlockError::BAD_LENGTH: return "bad_length";
+        case BlockError::UNSUPPORTED_CATEGORY: return "unsupported_category";
+        case BlockError::TRUNCATED: return "truncated";
+        case BlockError::MALFORMED: return "malformed";
+        case BlockError::RECORD_ERROR: return "record_error";
+    }
+    return "unknown";
+}
+
 AsterixDecoder::AsterixDecoder() 
     : xml_parser_(std::make_unique<XmlParser>()) {
 }
@@ -16,8 +32,7 @@ AsterixDecoder::~AsterixDecoder() = default;
 bool AsterixDecoder::load_category_definition(const std::string& xml_file) {
     try {
         auto category = xml_parser_->parse_category(xml_file);
-        uint8_t cat_num = category->header.category;
-        categories_[cat_num] = std::move(category);
+        uint8_t cat_num = install_category(std::move(category));
         
         log_debug("Loaded category " + std::to_string(cat_num) + " from " + xml_file);
         return true;
@@ -30,8 +45,7 @@ bool AsterixDecoder::load_category_definition(const std::string& xml_file) {
 bool AsterixDecoder::load_category_definition_from_string(const std::string& xml_content) {
     try {
         auto category = xml_parser_->parse_category_from_string(xml_content);
-        uint8_t cat_num = category->header.category;
-        categories_[cat_num] = std::move(category);
+        uint8_t cat_num = install_category(std::move(category));
         
         log_debug("Loaded category " + std::to_string(cat_num) + " from string");
         return true;
@@ -61,16 +75,69 @@ bool AsterixDecoder::load_categories_from_directory(const std::string& directory
     }
 }
 
+bool AsterixDecoder::load_static_category(const StaticCategory& definition) {
+    try {
+        auto category = std::make_unique<AsterixCategory>(to_category(definition));
+        uint8_t cat_num = install_category(std::move(category));
+        
+        log_debug("Loaded static category " + std::to_string(cat_num));
+        return true;
+    } catch (const std::exception& e) {
+        log_error(std::string("Failed to load static category: ") + e.what());
+        return false;
+    }
+}
+
+uint8_t AsterixDecoder::install_category(std::unique_ptr<AsterixCategory> category) {
+    uint8_t cat_num = category->header.category;
+    
+    std::vector<LayoutIssue> issues;
+    bool consistent = verify_category_layout(*category, layout_policy_, issues);
+    for (const auto& issue : issues) {
+        std::string message = "Category " + std::to_string(cat_num) + " " + issue.item_id +
+                              (issue.field.empty() ? "" : "/" + issue.field) + ": " + issue.message;
+        if (issue.repaired) {
+            log_debug(message);
+        } else {
+            log_warning(message);
+        }
+    }
+    
+    if (!consistent && layout_policy_ == LayoutPolicy::STRICT) {
+        throw std::runtime_error("Inconsistent item layouts in category " + std::to_string(cat_num) +
+                                 " (" + std::to_string(issues.size()) + " issues)");
+    }
+    layout_issues_[cat_num] = std::move(issues);
+    
+    categories_[cat_num] = std::move(category);
+    
+    // Cached plans and checks point into the previous definition
+    plan_caches_.erase(cat_num);
+    range_checkers_.erase(cat_num);
+    for (auto& caches : worker_plan_caches_) {
+        caches.erase(cat_num);
+    }
+    return cat_num;
+}
+
 AsterixBlock AsterixDecoder::decode_block(const std::vector<uint8_t>& data) {
+    return decode_block(data.data(), data.size());
+}
+
+AsterixBlock AsterixDecoder::decode_block(const uint8_t* data, size_t size, uint64_t offset) {
     AsterixBlock block;
     
-    if (data.size() < 3) {
+    if (size < 3) {
         block.valid = false;
-        log_error("Block too small: " + std::to_string(data.size()) + " bytes");
+        block.error = BlockError::TOO_SHORT;
+        log_error("Block too small: " + std::to_string(size) + " bytes");
+        if (quarantine_) {
+            quarantine_->check(block, data, size, offset);
+        }
         return block;
     }
     
-    ParseContext context(data.data(), data.size(), nullptr);
+    ParseContext context(data, size, nullptr);
     
     try {
         // Read the block header
@@ -83,18 +150,42 @@ AsterixBlock AsterixDecoder::decode_block(const std::vector<uint8_t>& data) {
         // Check that the category is supported
         auto cat_it = categories_.find(block.category);
         if (cat_it == categories_.end()) {
+            block.error = BlockError::UNSUPPORTED_CATEGORY;
             throw std::runtime_error("Unsupported category: " + std::to_string(block.category));
         }
         
         context.category = cat_it->second.get();
+        FspecPlanCache* plan_cache = plan_cache_for(block.category);
         
         // Handle according to category type
-        if (block.category == 2) {
+        if (block.category == 2 && worker_pool_ && block.length >= parallel_min_block_size_) {
+            // Large CAT002 block: locate the records, then decode them in parallel
+            decode_multirecord_block_parallel(context, block, plan_cache);
+        } else if (block.category == 2) {
             // CAT002: multi-record structure
-            decode_multirecord_block(context, block);
+            decode_multirecord_block(context, block, plan_cache);
         } else {
             // Other categories: traditional structure
-            decode_traditional_block(context, block);
+            decode_traditional_block(context, block, plan_cache);
+        }
+        
+        // Field names view the definition, string and byte values the arena
+        for (auto& message : block.messages) {
+            message.definition = cat_it->second;
+            if (!message.arena) {
+                message.arena = context.arena;
+            }
+            if (!message.valid) {
+                block.error = BlockError::RECORD_ERROR;
+            }
+        }
+        
+        if (range_checks_enabled_) {
+            if (RangeChecker* checker = range_checker_for(block.category, *cat_it->second)) {
+                for (const auto& message : block.messages) {
+                    checker->check(message);
+                }
+            }
         }
         
         block.valid = true;
@@ -102,12 +193,61 @@ AsterixBlock AsterixDecoder::decode_block(const std::vector<uint8_t>& data) {
     } catch (const std::exception& e) {
         log_error("Failed to decode block: " + std::string(e.what()));
         block.valid = false;
+        if (block.error != BlockError::UNSUPPORTED_CATEGORY) {
+            block.error = block.length > size ? BlockError::TRUNCATED : BlockError::MALFORMED;
+        }
     }
     
+    if (quarantine_ && block.error != BlockError::NONE) {
+        quarantine_->check(block, data, size, offset);
+    }
     return block;
 }
 
-void AsterixDecoder::decode_multirecord_block(ParseContext& context, AsterixBlock& block) {
+bool AsterixDecoder::decode_block_flat(const uint8_t* data, size_t size, FlatRecordWriter& writer) {
+    AsterixBlock block = decode_block(data, size);
+    if (!block.valid) {
+        return false;
+    }
+    
+    writer.append(block);
+    return true;
+}
+
+bool AsterixDecoder::decode_block_lazy(const uint8_t* data, size_t size, std::vector<LazyRecord>& records) {
+    if (size < 3) {
+        log_error("Block too small: " + std::to_string(size) + " bytes");
+        return false;
+    }
+    
+    uint8_t category = data[0];
+    size_t block_end = std::min<size_t>(core::load_be16(data + 1), size);
+    
+    auto cat_it = categories_.find(category);
+    if (cat_it == categories_.end()) {
+        log_error("Unsupported category: " + std::to_string(category));
+        return false;
+    }
+    
+    FspecPlanCache* plan_cache = plan_cache_for(category);
+    
+    size_t position = 3;
+    while (position < block_end) {
+        LazyRecord record;
+        if (!record.index(data + position, block_end - position, cat_it->second, plan_cache)) {
+            log_error("Failed to index record at offset " + std::to_string(position));
+            return false;
+        }
+        
+        position += record.length();
+        records.push_back(std::move(record));
+    }
+    
+    return true;
+}
+
+void AsterixDecoder::decode_multirecord_block(ParseContext& context, AsterixBlock& block,
+                                              FspecPlanCache* plan_cache) {
     log_debug("Decoding multi-record block for CAT002");
     
     size_t block_end = block.length;
@@ -121,12 +261,13 @@ void AsterixDecoder::decode_multirecord_block(ParseContext& context, AsterixBloc
         
         try {
             // Each record has its own FSPEC + data structure
-            auto record = decode_single_record(context);
+            auto record = decode_single_record(context, plan_cache);
             block.messages.push_back(std::move(record));
             
         } catch (const std::exception& e) {
             log_error("Failed to decode record #" + std::to_string(record_count) + 
                      ": " + std::string(e.what()));
+            block.error = BlockError::RECORD_ERROR;
             
             // In strict mode, stop decoding
             if (strict_validation_) {
@@ -150,59 +291,181 @@ void AsterixDecoder::decode_multirecord_block(ParseContext& context, AsterixBloc
              " records from multi-record block");
 }
 
-AsterixMessage AsterixDecoder::decode_single_record(ParseContext& context) {
-    AsterixMessage record;
-    record.category = context.category->header.category;
+void AsterixDecoder::decode_multirecord_block_parallel(ParseContext& context, AsterixBlock& block,
+                                                       FspecPlanCache* plan_cache) {
+    if (block.length > context.size) {
+        // Truncated block: report it the way the sequential decoder does
+        log_debug("Block runs past the buffer, decoding sequentially");
+        decode_multirecord_block(context, block, plan_cache);
+        return;
+    }
+    size_t block_end = block.length;
     
-    size_t record_start = context.position;
+    std::vector<RecordSpan> records;
+    if (!index_block_records(context.data, context.position, block_end, *context.category, plan_cache, records)) {
+        // Malformed block: the sequential decoder reports and skips the bad records
+        log_debug("Cannot locate record boundaries, decoding sequentially");
+        decode_multirecord_block(context, block, plan_cache);
+        return;
+    }
     
-    // Read the record's FSPEC
-    auto fspec = parse_field_specification(context);
+    block.messages = decode_records(context.data, records);
+    context.position = block_end;
     
-    if (debug_mode_) {
-        std::string fspec_hex;
-        for (uint8_t byte : fspec) {
-            char buf[4];
-            sprintf(buf, "%02X ", byte);
-            fspec_hex += buf;
+    log_debug("Decoded " + std::to_string(block.messages.size()) + 
+             " records from multi-record block on " + std::to_string(worker_pool_->size()) + " threads");
+}
+
+bool AsterixDecoder::index_block_records(const uint8_t* data, size_t begin, size_t end,
+                                         const AsterixCategory& category, FspecPlanCache* plan_cache,
+                                         std::vector<RecordSpan>& records) {
+    size_t position = begin;
+    
+    while (position < end) {
+        size_t fspec_length = core::fx_chain_length(data + position, std::min(end - position, core::kMaxFspecLength));
+        if (fspec_length == 0) {
+            return false;
         }
-        log_debug("Record FSPEC: " + fspec_hex);
+        
+        FspecPlan scratch;
+        const FspecPlan& plan = lookup_fspec_plan(plan_cache, data + position, fspec_length, category, scratch);
+        size_t length = measure_record(plan, data + position, end - position);
+        if (length == 0) {
+            return false;
+        }
+        
+        records.push_back(RecordSpan{static_cast<uint64_t>(position), static_cast<uint16_t>(length),
+                                     category.header.category});
+        position += length;
     }
     
-    // Identify the data items present in this record
-    auto present_items = parse_uap_items(fspec, context.category->uap);
+    return true;
+}
+
+bool AsterixDecoder::index_records(const uint8_t* data, size_t size, std::vector<RecordSpan>& records) {
+    size_t offset = 0;
     
-    log_debug("Record has " + std::to_string(present_items.size()) + " data items");
+    while (offset < size) {
+        if (size - offset < 3) {
+            log_error("Truncated block header at offset " + std::to_string(offset));
+            return false;
+        }
+        
+        uint8_t category = data[offset];
+        size_t length = core::load_be16(data + offset + 1);
+        if (length < 3 || offset + length > size) {
+            log_error("Invalid block length " + std::to_string(length) + " at offset " + std::to_string(offset));
+            return false;
+        }
+        
+        auto cat_it = categories_.find(category);
+        if (cat_it == categories_.end()) {
+            log_error("Unsupported category: " + std::to_string(category));
+            return false;
+        }
+        
+        if (!index_block_records(data, offset + 3, offset + length, *cat_it->second,
+                                 plan_cache_for(category), records)) {
+            log_error("Cannot locate the records of the block at offset " + std::to_string(offset));
+            return false;
+        }
+        
+        offset += length;
+    }
     
-    // Calculate the expected record length
-    size_t expected_length = calculate_record_length(present_items, *context.category);
-    size_t available_data = context.size - context.position;
+    return true;
+}
+
+std::vector<AsterixMessage> AsterixDecoder::decode_records(const uint8_t* data,
+                                                           const std::vector<RecordSpan>& records) {
+    std::vector<AsterixMessage> messages(records.size());
     
-    if (expected_length > available_data) {
-        log_warning("Expected record length (" + std::to_string(expected_length) + 
-                   ") exceeds available data (" + std::to_string(available_data) + ")");
+    size_t workers = worker_pool_ ? worker_pool_->size() : 1;
+    if (worker_plan_caches_.size() < workers) {
+        worker_plan_caches_.resize(workers);
     }
     
-    // Decode each present data item
-    for (const auto& item_id : present_items) {
-        if (item_id == "spare" || item_id.empty()) {
-            continue; // Skip spare and empty fields
-        }
+    // Every record is decoded in its own context, so workers share nothing but
+    // the (read-only) definitions
+    auto decode_one = [&](size_t worker, size_t index) {
+        const RecordSpan& span = records[index];
+        AsterixMessage& message = messages[index];
+        message.category = span.category;
         
-        auto item_it = context.category->data_items.find(item_id);
-        if (item_it == context.category->data_items.end()) {
-            log_warning("Unknown data item: " + item_id);
-            continue;
+        auto cat_it = categories_.find(span.category);
+        if (cat_it == categories_.end()) {
+            message.valid = false;
+            message.error_message = "Unsupported category: " + std::to_string(span.category);
+            return;
         }
         
-        size_t item_start = context.position;
-        auto parsed_item = FieldParser::parse_data_item(item_it->second, context);
-        size_t item_length = context.position - item_start;
-        
-        log_debug("Parsed " + item_id + " (" + std::to_string(item_length) + " bytes)");
-        record.data_items.push_back(std::move(parsed_item));
+        ParseContext context(data + span.offset, span.length, cat_it->second.get());
+        try {
+            message = decode_single_record(context, worker_plan_cache(worker, span.category));
+            message.definition = cat_it->second;
+            message.arena = context.arena;
+        } catch (const std::exception& e) {
+            message.valid = false;
+            message.error_message = e.what();
+        }
+    };
+    
+    if (worker_pool_) {
+        worker_pool_->parallel_for(records.size(), 16, decode_one);
+    } else {
+        for (size_t i = 0; i < records.size(); ++i) {
+            decode_one(0, i);
+        }
     }
     
+    return messages;
+}
+
+FspecPlanCache* AsterixDecoder::worker_plan_cache(size_t worker, uint8_t category) {
+    if (!plan_cache_enabled_) {
+        return nullptr;
+    }
+    
+    auto& cache = worker_plan_caches_[worker][category];
+    if (!cache) {
+        cache = std::make_unique<FspecPlanCache>();
+    }
+    return cache.get();
+}
+
+void AsterixDecoder::set_parallel_decoding(size_t threads, size_t min_block_size) {
+    parallel_min_block_size_ = min_block_size;
+    worker_pool_.reset();
+    if (threads > 1) {
+        worker_pool_ = std::make_unique<WorkerPool>(threads, memory_options_);
+    }
+}
+
+AsterixMessage AsterixDecoder::decode_single_record(ParseContext& context, FspecPlanCache* plan_cache) {
+    AsterixMessage record;
+    record.category = context.category->header.category;
+    
+    size_t record_start = context.position;
+    
+    // Read the record's FSPEC and resolve the items it selects
+    FspecPlan scratch;
+    FspecPlan& plan = resolve_fspec_plan(context, plan_cache, scratch);
+    
+    if (debug_mode_) {
+        log_debug("Record FSPEC: " + utils::to_hex_string(std::vector<uint8_t>(plan.fspec, plan.fspec + plan.fspec_length)));
+        log_debug("Record has " + std::to_string(plan.items.size() + plan.unknown_items.size()) + " data items");
+    }
+    
+    // Check the expected record length
+    size_t available_data = context.size - context.position;
+    if (plan.min_length > available_data) {
+        log_warning("Expected record length (" + std::to_string(plan.min_length) + 
+                   ") exceeds available data (" + std::to_string(available_data) + ")");
+    }
+    
+    // Decode each present data item
+    decode_plan_items(plan, context, record);
+    
     record.length = context.position - record_start;
     record.valid = true;
     
@@ -211,12 +474,13 @@ AsterixMessage AsterixDecoder::decode_single_record(ParseContext& context) {
     return record;
 }
 
-void AsterixDecoder::decode_traditional_block(ParseContext& context, AsterixBlock& block) {
+void AsterixDecoder::decode_traditional_block(ParseContext& context, AsterixBlock& block,
+                                              FspecPlanCache* plan_cache) {
     log_debug("Decoding traditional block");
     
     // Decode the single message in the block
     while (context.position < block.length && context.has_data(1)) {
-        auto message = decode_message_internal(context);
+        auto message = decode_message_internal(context, plan_cache);
         block.messages.push_back(std::move(message));
         
         // For traditional blocks, usually one message only
@@ -226,49 +490,6 @@ void AsterixDecoder::decode_traditional_block(ParseContext& context, AsterixBloc
     }
 }
 
-size_t AsterixDecoder::calculate_record_length(
-    const std::vector<std::string>& present_items, 
-    const AsterixCategory& category) {
-    
-    size_t total_length = 0;
-    
-    for (const auto& item_id : present_items) {
-        if (item_id == "spare" || item_id.empty()) {
-            continue;
-        }
-        
-        auto item_it = category.data_items.find(item_id);
-        if (item_it != category.data_items.end()) {
-            const auto& item = item_it->second;
-            
-            switch (item.format) {
-                case DataFormat::FIXED:
-                    if (item.length.has_value()) {
-                        total_length += item.length.value();
-                    }
-                    break;
-                    
-                case DataFormat::VARIABLE:
-                    // For variable fields, estimate at least 1 byte
-                    total_length += 1;
-                    break;
-                    
-                case DataFormat::EXPLICIT:
-                    // First byte indicates length, so at least 2 bytes
-                    total_length += 2;
-                    break;
-                    
-                case DataFormat::REPETITIVE:
-                    // First byte indicates repetitions, so at least 2 bytes
-                    total_length += 2;
-                    break;
-            }
-        }
-    }
-    
-    return total_length;
-}
-
 RecordStatistics AsterixDecoder::analyze_block_records(const AsterixBlock& block) {
     RecordStatistics stats;
     
@@ -401,7 +622,9 @@ AsterixMessage AsterixDecoder::decode_message(uint8_t category, const std::vecto
     ParseContext context(data.data(), data.size(), cat_it->second.get());
     
     try {
-        message = decode_message_internal(context);
+        message = decode_message_internal(context, plan_cache_for(category));
+        message.definition = cat_it->second;
+        message.arena = context.arena;
     } catch (const std::exception& e) {
         message.valid = false;
         message.error_message = e.what();
@@ -413,41 +636,60 @@ AsterixMessage AsterixDecoder::decode_message(uint8_t category, const std::vecto
 std::vector<AsterixBlock> AsterixDecoder::decode_file(const std::string& filename) {
     std::vector<AsterixBlock> blocks;
     
-    std::ifstream file(filename, std::ios::binary);
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
     if (!file) {
         log_error("Cannot open file: " + filename);
         return blocks;
     }
     
-    // Read the entire file
-    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
-                              std::istreambuf_iterator<char>());
+    // Read the entire file into a buffer placed according to the memory options
+    size_t file_size = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+    
+    NumaBuffer data(file_size, memory_options_);
+    if (file_size > 0 && !file.read(reinterpret_cast<char*>(data.data()), file_size)) {
+        log_error("Failed to read file: " + filename);
+        return blocks;
+    }
     file.close();
     
-    log_debug("Read " + std::to_string(data.size()) + " bytes from " + filename);
+    log_debug("Read " + std::to_string(data.size()) + " bytes from " + filename +
+             (data.huge_pages() ? " (huge pages)" : ""));
     
-    // Decode block by block
+    // Decode block by block, directly from the file buffer
     size_t offset = 0;
     while (offset < data.size()) {
+        // The rest of the file is quarantined when no block can be delimited
+        size_t rest = std::min<size_t>(data.size() - offset, 0xFFFF);
         if (offset + 3 > data.size()) {
             log_warning("Insufficient data for block header at offset " + std::to_string(offset));
+            if (quarantine_) {
+                quarantine_->submit(data.data() + offset, rest, offset, BlockError::TOO_SHORT);
+            }
             break;
         }
         
         // Read the block length
-        uint16_t block_length = (data[offset + 1] << 8) | data[offset + 2];
+        uint16_t block_length = core::load_be16(data.data() + offset + 1);
         
         if (offset + block_length > data.size()) {
             log_warning("Block length exceeds file size at offset " + std::to_string(offset));
+            if (quarantine_) {
+                quarantine_->submit(data.data() + offset, rest, offset, BlockError::TRUNCATED);
+            }
             break;
         }
         
-        // Extract block data
-        std::vector<uint8_t> block_data(data.begin() + offset, 
-                                       data.begin() + offset + block_length);
+        if (block_length < 3) {
+            log_warning("Invalid block length at offset " + std::to_string(offset));
+            if (quarantine_) {
+                quarantine_->submit(data.data() + offset, rest, offset, BlockError::BAD_LENGTH);
+            }
+            break;
+        }
         
         // Decode the block
-        auto block = decode_block(block_data);
+        auto block = decode_block(data.data() + offset, block_length, offset);
         blocks.push_back(std::move(block));
         
         offset += block_length;
@@ -492,34 +734,24 @@ const AsterixCategory* AsterixDecoder::get_category_definition(uint8_t category)
     return (it != categories_.end()) ? it->second.get() : nullptr;
 }
 
-AsterixMessage AsterixDecoder::decode_message_internal(ParseContext& context) {
+std::shared_ptr<const AsterixCategory> AsterixDecoder::share_category_definition(uint8_t category) const {
+    auto it = categories_.find(category);
+    return (it != categories_.end()) ? it->second : nullptr;
+}
+
+AsterixMessage AsterixDecoder::decode_message_internal(ParseContext& context, FspecPlanCache* plan_cache) {
     AsterixMessage message;
     message.category = context.category->header.category;
     
     try {
-        // Read the Field Specification (FSPEC)
-        auto fspec = parse_field_specification(context);
-        
-        // Identify which data items are present
-        auto present_items = parse_uap_items(fspec, context.category->uap);
+        // Read the Field Specification (FSPEC) and resolve the items it selects
+        FspecPlan scratch;
+        FspecPlan& plan = resolve_fspec_plan(context, plan_cache, scratch);
         
-        log_debug("Message has " + std::to_string(present_items.size()) + " data items");
+        log_debug("Message has " + std::to_string(plan.items.size() + plan.unknown_items.size()) + " data items");
         
         // Decode each present data item
-        for (const auto& item_id : present_items) {
-            if (item_id == "spare") {
-                continue; // Skip spare fields
-            }
-            
-            auto item_it = context.category->data_items.find(item_id);
-            if (item_it == context.category->data_items.end()) {
-                log_warning("Unknown data item: " + item_id);
-                continue;
-            }
-            
-            auto parsed_item = FieldParser::parse_data_item(item_it->second, context);
-            message.data_items.push_back(std::move(parsed_item));
-        }
+        decode_plan_items(plan, context, message);
         
         message.valid = true;
         
@@ -532,54 +764,180 @@ AsterixMessage AsterixDecoder::decode_message_internal(ParseContext& context) {
     return message;
 }
 
-std::vector<uint8_t> AsterixDecoder::parse_field_specification(ParseContext& context) {
-    std::vector<uint8_t> fspec;
-    
-    do {
-        if (!context.has_data(1)) {
+size_t AsterixDecoder::read_field_specification(ParseContext& context) {
+    // Safety limit of 16 FSPEC bytes
+    size_t available = std::min<size_t>(context.size - context.position, core::kMaxFspecLength);
+    size_t fspec_length = kernels::active().fspec_length(context.data + context.position, available);
+    
+    // If the FX bit (bit 0) is 0, this is the last byte
+    if (fspec_length == 0) {
+        if (available < core::kMaxFspecLength) {
             throw std::runtime_error("Insufficient data for FSPEC");
         }
-        
-        uint8_t fspec_byte = context.read_uint8();
-        fspec.push_back(fspec_byte);
-        
-        // If the FX bit (bit 0) is 0, this is the last byte
-        if ((fspec_byte & 0x01) == 0) {
-            break;
+        fspec_length = available;
+    }
+    
+    context.skip(fspec_length);
+    return fspec_length;
+}
+
+FspecPlan& AsterixDecoder::resolve_fspec_plan(ParseContext& context, FspecPlanCache* plan_cache,
+                                              FspecPlan& scratch) {
+    const uint8_t* fspec = context.current();
+    size_t fspec_length = read_field_specification(context);
+    
+    if (plan_cache) {
+        if (FspecPlan* cached = plan_cache->find(fspec, fspec_length)) {
+            if (++cached->uses >= specialization_threshold_ && !cached->specialization_attempted &&
+                specialization_enabled_[context.category->header.category]) {
+                cached->specialization_attempted = true;
+                cached->specialized = SpecializedDecoder::build(*cached);
+                log_debug(std::string(cached->specialized ? "Specialised" : "Cannot specialise") +
+                         " FSPEC plan with " + std::to_string(cached->items.size()) + " items");
+            }
+            return *cached;
         }
-        
-    } while (fspec.size() < 16); // Safety limit
+    }
+    
+    scratch = build_fspec_plan(fspec, fspec_length, *context.category);
     
-    return fspec;
+    if (plan_cache) {
+        if (FspecPlan* stored = plan_cache->insert(scratch)) {
+            return *stored;
+        }
+    }
+    return scratch;
 }
 
-std::vector<std::string> AsterixDecoder::parse_uap_items(
-    const std::vector<uint8_t>& fspec, 
-    const UserApplicationProfile& uap) {
+void AsterixDecoder::decode_plan_items(FspecPlan& plan, ParseContext& context, AsterixMessage& message) {
+    for (const auto& item_id : plan.unknown_items) {
+        log_warning("Unknown data item: " + item_id);
+    }
     
-    std::vector<std::string> present_items;
+    message.data_items.reserve(plan.items.size());
     
-    size_t bit_index = 0;
-    for (size_t byte_idx = 0; byte_idx < fspec.size(); ++byte_idx) {
-        uint8_t fspec_byte = fspec[byte_idx];
-        
-        // Examine each bit (except the FX bit for extension bytes)
-        int bits_to_check = (byte_idx == fspec.size() - 1) ? 8 : 7; // The last byte uses all bits
-        
-        for (int bit = 7; bit >= 8 - bits_to_check; --bit) {
-            if (bit_index >= uap.items.size()) {
-                break; // No more items in the UAP
+    auto keep_bytes = [&](ParsedDataItem& item, const uint8_t* data, size_t size) {
+        if (keep_item_bytes_ && size > 0) {
+            if (!context.arena) {
+                context.arena = std::make_shared<ValueArena>();
             }
-            
-            if (fspec_byte & (1 << bit)) {
-                present_items.push_back(uap.items[bit_index]);
+            item.raw = FieldValue::bytes_view(context.arena->store(data, size), size);
+        }
+    };
+    
+    // All items FIXED: one length check, then every item at its precomputed offset
+    if (plan.all_fixed && context.has_data(plan.fixed_length)) {
+        const uint8_t* items_data = context.current();
+        size_t first = message.data_items.size();
+        
+        if (plan.specialized) {
+            plan.specialized->decode(items_data, message.data_items);
+            plan.specialized_records++;
+        } else {
+            for (size_t i = 0; i < plan.items.size(); ++i) {
+                message.data_items.push_back(
+                    FieldParser::parse_fixed_item(*plan.items[i], items_data + plan.item_offsets[i], context.arena));
+                message.data_items.back().frn = plan.item_frns[i];
             }
-            
-            bit_index++;
+        }
+        for (size_t i = 0; keep_item_bytes_ && i < plan.items.size(); ++i) {
+            keep_bytes(message.data_items[first + i], items_data + plan.item_offsets[i],
+                       plan.items[i]->length.value_or(0));
+        }
+        context.position += plan.fixed_length;
+        return;
+    }
+    
+    for (size_t i = 0; i < plan.items.size(); ++i) {
+        const DataItem* item = plan.items[i];
+        size_t item_start = context.position;
+        auto parsed_item = FieldParser::parse_data_item(*item, context);
+        parsed_item.frn = plan.item_frns[i];
+        keep_bytes(parsed_item, context.data + item_start, context.position - item_start);
+        
+        if (debug_mode_) {
+            log_debug("Parsed " + item->id + " (" + std::to_string(context.position - item_start) + " bytes)");
+        }
+        message.data_items.push_back(std::move(parsed_item));
+    }
+}
+
+FspecPlanCache* AsterixDecoder::plan_cache_for(uint8_t category) {
+    if (!plan_cache_enabled_) {
+        return nullptr;
+    }
+    
+    auto& cache = plan_caches_[category];
+    if (!cache) {
+        cache = std::make_unique<FspecPlanCache>();
+    }
+    return cache.get();
+}
+
+RangeChecker* AsterixDecoder::range_checker_for(uint8_t category, const AsterixCategory& definition) {
+    auto& checker = range_checkers_[category];
+    if (!checker) {
+        checker = std::make_unique<RangeChecker>(definition);
+    }
+    return checker->empty() ? nullptr : checker.get();
+}
+
+std::vector<FieldCheck> AsterixDecoder::get_range_check_stats(uint8_t category) const {
+    auto it = range_checkers_.find(category);
+    return (it != range_checkers_.end()) ? it->second->checks() : std::vector<FieldCheck>{};
+}
+
+std::vector<LayoutIssue> AsterixDecoder::get_layout_issues(uint8_t category) const {
+    auto it = layout_issues_.find(category);
+    return (it != layout_issues_.end()) ? it->second : std::vector<LayoutIssue>{};
+}
+
+PlanCacheStats AsterixDecoder::get_plan_cache_stats(uint8_t category) const {
+    PlanCacheStats result;
+    
+    auto add = [&](const PlanCacheStats& stats) {
+        result.hits += stats.hits;
+        result.misses += stats.misses;
+        result.entries += stats.entries;
+        result.specialized_plans += stats.specialized_plans;
+        result.specialized_records += stats.specialized_records;
+    };
+    
+    auto it = plan_caches_.find(category);
+    if (it != plan_caches_.end()) {
+        add(it->second->stats());
+    }
+    for (const auto& caches : worker_plan_caches_) {
+        auto worker_it = caches.find(category);
+        if (worker_it != caches.end()) {
+            add(worker_it->second->stats());
         }
     }
     
-    return present_items;
+    return result;
+}
+
+void AsterixDecoder::set_specialization(uint8_t category, bool enabled) {
+    specialization_enabled_[category] = enabled;
+    
+    auto it = plan_caches_.find(category);
+    if (it != plan_caches_.end()) {
+        it->second->reset_specializations();
+    }
+    for (auto& caches : worker_plan_caches_) {
+        auto worker_it = caches.find(category);
+        if (worker_it != caches.end()) {
+            worker_it->second->reset_specializations();
+        }
+    }
+}
+
+void AsterixDecoder::set_plan_cache_enabled(bool enabled) {
+    plan_cache_enabled_ = enabled;
+    if (!enabled) {
+        plan_caches_.clear();
+        worker_plan_caches_.clear();
+    }
 }
 
 bool AsterixDecoder::validate_mandatory_fields(const AsterixMessage& message, const AsterixCategory& category) {
@@ -0,0 +1,298 @@
+#include "skydecoder/async_file_writer.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace skydecoder {
+
+namespace {
+
+constexpr size_t kAlignment = 4096;
+
+uint64_t nanoseconds_since(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+} // namespace
+
+AsyncFileWriter::AsyncFileWriter(AsyncWriterOptions options) : options_(std::move(options)) {
+    options_.buffer_size = std::max<size_t>((options_.buffer_size + kAlignment - 1) / kAlignment * kAlignment, kAlignment);
+    options_.buffer_count = std::max<size_t>(options_.buffer_count, 2);
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    if (open_) {
+        close();
+    }
+}
+
+bool AsyncFileWriter::open(const std::string& path) {
+    if (open_) {
+        close();
+    }
+
+    stats_ = AsyncWriterStats();
+    error_.clear();
+    failed_.store(false);
+    stopping_ = false;
+    submitted_ = 0;
+    base_offset_ = 0;
+    direct_ = false;
+
+#ifndef _WIN32
+    int flags = O_WRONLY | O_CREAT | (options_.append ? 0 : O_TRUNC);
+#ifdef O_DIRECT
+    if (options_.direct_io) {
+        fd_ = ::open(path.c_str(), flags | O_DIRECT, 0644);
+        direct_ = fd_ >= 0;
+    }
+#endif
+    if (fd_ < 0) {
+        fd_ = ::open(path.c_str(), flags, 0644);
+    }
+    if (fd_ < 0) {
+        error_ = "Cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    off_t end = ::lseek(fd_, 0, SEEK_END);
+    base_offset_ = end > 0 ? static_cast<uint64_t>(end) : 0;
+#ifdef O_DIRECT
+    if (direct_ && base_offset_ % kAlignment != 0) {
+        // Appending at an unaligned length cannot bypass the page cache
+        ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL) & ~O_DIRECT);
+        direct_ = false;
+    }
+#endif
+#else
+    file_ = std::fopen(path.c_str(), options_.append ? "ab" : "wb");
+    if (!file_) {
+        error_ = "Cannot open " + path;
+        return false;
+    }
+    std::setvbuf(file_, nullptr, _IONBF, 0);
+    std::fseek(file_, 0, SEEK_END);
+    long end = std::ftell(file_);
+    base_offset_ = end > 0 ? static_cast<uint64_t>(end) : 0;
+#endif
+    stats_.direct_io = direct_;
+
+    // Aligned for O_DIRECT either way, it costs nothing
+    buffers_.resize(options_.buffer_count);
+    for (auto& buffer : buffers_) {
+        buffer.data = static_cast<uint8_t*>(::operator new(options_.buffer_size, std::align_val_t(kAlignment)));
+        buffer.size = 0;
+    }
+    current_ = &buffers_[0];
+    full_.clear();
+    free_.clear();
+    for (size_t i = 1; i < buffers_.size(); ++i) {
+        free_.push_back(&buffers_[i]);
+    }
+
+    open_ = true;
+    thread_ = std::thread(&AsyncFileWriter::io_loop, this);
+    return true;
+}
+
+bool AsyncFileWriter::write(const void* data, size_t size) {
+    if (!open_ || failed_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        size_t count = std::min(options_.buffer_size - current_->size, size);
+        std::memcpy(current_->data + current_->size, bytes, count);
+        current_->size += count;
+        submitted_ += count;
+        bytes += count;
+        size -= count;
+
+        // A full buffer goes to the I/O thread right away
+        if (current_->size == options_.buffer_size) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            submit_current(lock);
+            take_free_buffer(lock);
+        }
+    }
+    return !failed_.load(std::memory_order_relaxed);
+}
+
+void AsyncFileWriter::submit_current(std::unique_lock<std::mutex>&) {
+    full_.push_back(current_);
+    current_ = nullptr;
+    work_ready_.notify_one();
+}
+
+void AsyncFileWriter::take_free_buffer(std::unique_lock<std::mutex>& lock) {
+    if (free_.empty()) {
+        stats_.producer_waits++;
+        auto start = std::chrono::steady_clock::now();
+        buffer_ready_.wait(lock, [&] { return !free_.empty(); });
+        stats_.wait_ns += nanoseconds_since(start);
+    }
+    current_ = free_.front();
+    free_.pop_front();
+    current_->size = 0;
+}
+
+bool AsyncFileWriter::wait_idle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (current_->size > 0) {
+        submit_current(lock);
+        take_free_buffer(lock);
+    }
+    if (!full_.empty() || busy_) {
+        auto start = std::chrono::steady_clock::now();
+        buffer_ready_.wait(lock, [&] { return full_.empty() && !busy_; });
+        stats_.wait_ns += nanoseconds_since(start);
+    }
+    return !failed_.load();
+}
+
+bool AsyncFileWriter::flush() {
+    return open_ && wait_idle();
+}
+
+bool AsyncFileWriter::sync() {
+    if (!flush()) {
+        return false;
+    }
+    // The I/O thread is idle until the next write
+#ifndef _WIN32
+    return fsync(fd_) == 0;
+#else
+    return std::fflush(file_) == 0;
+#endif
+}
+
+bool AsyncFileWriter::close() {
+    if (!open_) {
+        return false;
+    }
+
+    bool ok = options_.sync_on_close ? sync() : flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_one();
+    thread_.join();
+
+#ifndef _WIN32
+    ok = ::close(fd_) == 0 && ok;
+    fd_ = -1;
+#else
+    ok = std::fclose(file_) == 0 && ok;
+    file_ = nullptr;
+#endif
+    release_buffers();
+    open_ = false;
+    return ok && !failed_.load();
+}
+
+void AsyncFileWriter::release_buffers() {
+    for (auto& buffer : buffers_) {
+        ::operator delete(buffer.data, std::align_val_t(kAlignment));
+    }
+    buffers_.clear();
+    full_.clear();
+    free_.clear();
+    current_ = nullptr;
+}
+
+AsyncWriterStats AsyncFileWriter::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    AsyncWriterStats stats = stats_;
+    stats.bytes_submitted = submitted_;
+    return stats;
+}
+
+std::string AsyncFileWriter::error() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+}
+
+void AsyncFileWriter::io_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        work_ready_.wait(lock, [&] { return stopping_ || !full_.empty(); });
+        if (full_.empty()) {
+            break;
+        }
+
+        Buffer* buffer = full_.front();
+        full_.pop_front();
+        busy_ = true;
+        lock.unlock();
+
+        // After a failure the buffers are only recycled so the producer never blocks
+        auto start = std::chrono::steady_clock::now();
+        bool ok = !failed_.load() && write_buffer(*buffer);
+        int error = ok ? 0 : errno;
+        uint64_t elapsed = nanoseconds_since(start);
+
+        lock.lock();
+        busy_ = false;
+        if (ok) {
+            stats_.bytes_written += buffer->size;
+            stats_.buffers_written++;
+            stats_.max_write_ns = std::max(stats_.max_write_ns, elapsed);
+        } else if (!failed_.load()) {
+            stats_.errors++;
+            error_ = std::strerror(error);
+            failed_.store(true);
+        }
+        stats_.direct_io = direct_;
+        buffer->size = 0;
+        free_.push_back(buffer);
+        buffer_ready_.notify_all();
+    }
+}
+
+bool AsyncFileWriter::write_buffer(const Buffer& buffer) {
+    const uint8_t* data = buffer.data;
+    size_t size = buffer.size;
+
+#ifndef _WIN32
+#ifdef O_DIRECT
+    if (direct_ && size % kAlignment != 0) {
+        // A partial buffer leaves the file unaligned, the rest goes through the page cache
+        ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL) & ~O_DIRECT);
+        direct_ = false;
+    }
+#endif
+    while (size > 0) {
+        ssize_t result = ::write(fd_, data, size);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+#ifdef O_DIRECT
+        if (result < 0 && errno == EINVAL && direct_) {
+            // The file system accepted O_DIRECT at open but not the write
+            ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL) & ~O_DIRECT);
+            direct_ = false;
+            continue;
+        }
+#endif
+        if (result <= 0) {
+            return false;
+        }
+        data += result;
+        size -= static_cast<size_t>(result);
+    }
+    return true;
+#else
+    return std::fwrite(data, 1, size, file_) == size;
+#endif
+}
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,374 @@
+#include "skydecoder/binary_serializer.h"
+#include <cstdint>
+#include <cstring>
+
+namespace skydecoder {
+
+namespace {
+
+// CBOR major types
+constexpr uint8_t kUnsigned = 0;
+constexpr uint8_t kNegative = 1;
+constexpr uint8_t kByteString = 2;
+constexpr uint8_t kTextString = 3;
+constexpr uint8_t kArray = 4;
+constexpr uint8_t kMap = 5;
+
+// Record keys in INTEGER mode
+constexpr uint64_t kKeyCategory = 0;
+constexpr uint64_t kKeyItems = 1;
+constexpr uint64_t kKeyError = 2;
+
+const char* unit_name(Unit unit) {
+    switch (unit) {
+        case Unit::SECONDS: return "seconds";
+        case Unit::NAUTICAL_MILES: return "NM";
+        case Unit::DEGREES: return "degrees";
+        case Unit::FLIGHT_LEVEL: return "FL";
+        case Unit::FEET: return "feet";
+        case Unit::KNOTS: return "knots";
+        case Unit::METERS_PER_SECOND: return "m/s";
+        default: return "none";
+    }
+}
+
+void flatten_fields(const std::vector<Field>& fields, std::vector<const Field*>& out) {
+    for (const auto& field : fields) {
+        if (field.name == "spare") {
+            continue;
+        }
+        out.push_back(&field);
+        flatten_fields(field.extension_fields, out);
+    }
+}
+
+} // namespace
+
+BinarySerializer::BinarySerializer(BinaryFormat format, KeyMode keys)
+    : format_(format), keys_(keys) {
+    buffer_.reserve(4096);
+}
+
+void BinarySerializer::reset() {
+    buffer_.clear();
+    dictionaries_.clear();
+    header_written_.reset();
+}
+
+void BinarySerializer::build_dictionary(const AsterixCategory& category, Dictionary& dictionary) {
+    dictionary.items.clear();
+
+    const auto& uap = category.uap.items;
+    for (size_t i = 0; i < uap.size(); ++i) {
+        auto item_it = category.data_items.find(uap[i]);
+        if (item_it == category.data_items.end()) {
+            continue;
+        }
+
+        ItemEntry entry;
+        entry.frn = static_cast<uint32_t>(i + 1);
+        entry.item = &item_it->second;
+        flatten_fields(item_it->second.fields, entry.fields);
+
+        dictionary.items.push_back(std::move(entry));
+    }
+}
+
+BinarySerializer::Dictionary& BinarySerializer::dictionary_for(const std::shared_ptr<const AsterixCategory>& category) {
+    uint8_t cat = category->header.category;
+    Dictionary& dictionary = dictionaries_[cat];
+    if (dictionary.category != category) {
+        // New or reloaded definition: its header goes out again
+        build_dictionary(*category, dictionary);
+        dictionary.category = category;
+        header_written_.reset(cat);
+    }
+    return dictionary;
+}
+
+void BinarySerializer::write_header(std::shared_ptr<const AsterixCategory> category) {
+    if (category) {
+        emit_header(dictionary_for(category));
+    }
+}
+
+void BinarySerializer::emit_header(const Dictionary& dictionary) {
+    uint8_t cat = dictionary.category->header.category;
+    write_map(2);
+    write_text("schema");
+    write_uint(cat);
+    write_text("items");
+    write_array(dictionary.items.size());
+    for (const ItemEntry& entry : dictionary.items) {
+        write_array(4);
+        write_uint(entry.frn);
+        write_text(entry.item->id);
+        write_text(entry.item->name);
+        write_array(entry.fields.size());
+        for (const Field* field : entry.fields) {
+            write_array(3);
+            write_text(field->name);
+            write_double(field->lsb);
+            write_text(unit_name(field->unit));
+        }
+    }
+
+    header_written_.set(cat);
+}
+
+void BinarySerializer::write(const AsterixBlock& block) {
+    for (const auto& message : block.messages) {
+        write(message);
+    }
+}
+
+void BinarySerializer::write(const AsterixMessage& message) {
+    const Dictionary* dictionary = nullptr;
+    if (keys_ == KeyMode::INTEGER) {
+        if (message.definition) {
+            dictionary = &dictionary_for(message.definition);
+            if (!header_written_.test(message.category)) {
+                emit_header(*dictionary);
+            }
+        }
+    }
+
+    bool with_error = !message.valid;
+    write_map(with_error ? 3 : 2);
+
+    if (keys_ == KeyMode::INTEGER) write_uint(kKeyCategory); else write_text("category");
+    write_uint(message.category);
+
+    if (keys_ == KeyMode::INTEGER) write_uint(kKeyItems); else write_text("items");
+    write_map(message.data_items.size());
+    size_t cursor = 0;
+    for (const auto& item : message.data_items) {
+        // Items come in FRN order: scan forward from the previous match
+        const ItemEntry* entry = nullptr;
+        if (dictionary) {
+            size_t count = dictionary->items.size();
+            for (size_t n = 0; n < count; ++n) {
+                size_t index = cursor + n < count ? cursor + n : cursor + n - count;
+                if (dictionary->items[index].item->id == item.id) {
+                    entry = &dictionary->items[index];
+                    cursor = index + 1;
+                    break;
+                }
+            }
+        }
+
+        // Items missing from the dictionary keep their id as key
+        if (entry) {
+            write_uint(entry->frn);
+        } else {
+            write_text(item.id);
+        }
+        write_fields(item, entry);
+    }
+
+    if (with_error) {
+        if (keys_ == KeyMode::INTEGER) write_uint(kKeyError); else write_text("error");
+        write_text(message.error_message);
+    }
+}
+
+void BinarySerializer::write_fields(const ParsedDataItem& item, const ItemEntry* entry) {
+    write_map(item.fields.size());
+
+    // Fields come in definition order, so the match is normally the next entry
+    size_t cursor = 0;
+    for (const auto& field : item.fields) {
+        bool found = false;
+        if (entry) {
+            size_t count = entry->fields.size();
+            for (size_t n = 0; n < count; ++n) {
+                size_t index = cursor + n < count ? cursor + n : cursor + n - count;
+                if (entry->fields[index]->name == field.name) {
+                    write_uint(index);
+                    cursor = index + 1;
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if (!found) {
+            write_text(field.name);
+        }
+
+        write_value(field.value);
+    }
+}
+
+void BinarySerializer::write_value(const FieldValue& value) {
+    switch (value.kind()) {
+        case FieldValue::Kind::UNSIGNED: write_uint(value.as_unsigned()); break;
+        case FieldValue::Kind::SIGNED: write_int(value.as_signed()); break;
+        case FieldValue::Kind::REAL: write_double(value.as_double()); break;
+        case FieldValue::Kind::BOOL: write_bool(value.as_bool()); break;
+        case FieldValue::Kind::STRING: write_text(value.as_string()); break;
+        case FieldValue::Kind::BYTES: write_bytes(value.data(), value.size()); break;
+        case FieldValue::Kind::NONE: write_null(); break;
+    }
+}
+
+void BinarySerializer::put_be(uint64_t value, size_t bytes) {
+    size_t position = buffer_.size();
+    buffer_.resize(position + bytes);
+    for (size_t i = 0; i < bytes; ++i) {
+        buffer_[position + i] = static_cast<uint8_t>(value >> (8 * (bytes - 1 - i)));
+    }
+}
+
+void BinarySerializer::put_data(const uint8_t* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    size_t position = buffer_.size();
+    buffer_.resize(position + size);
+    std::memcpy(buffer_.data() + position, data, size);
+}
+
+void BinarySerializer::put_head(uint8_t major, uint64_t value) {
+    uint8_t type = static_cast<uint8_t>(major << 5);
+    if (value < 24) {
+        put_byte(static_cast<uint8_t>(type | value));
+    } else if (value <= 0xFF) {
+        put_byte(type | 24);
+        put_byte(static_cast<uint8_t>(value));
+    } else if (value <= 0xFFFF) {
+        put_byte(type | 25);
+        put_be(value, 2);
+    } else if (value <= 0xFFFFFFFFull) {
+        put_byte(type | 26);
+        put_be(value, 4);
+    } else {
+        put_byte(type | 27);
+        put_be(value, 8);
+    }
+}
+
+void BinarySerializer::write_uint(uint64_t value) {
+    if (format_ == BinaryFormat::CBOR) {
+        put_head(kUnsigned, value);
+    } else if (value < 0x80) {
+        put_byte(static_cast<uint8_t>(value));
+    } else if (value <= 0xFF) {
+        put_byte(0xCC);
+        put_byte(static_cast<uint8_t>(value));
+    } else if (value <= 0xFFFF) {
+        put_byte(0xCD);
+        put_be(value, 2);
+    } else if (value <= 0xFFFFFFFFull) {
+        put_byte(0xCE);
+        put_be(value, 4);
+    } else {
+        put_byte(0xCF);
+        put_be(value, 8);
+    }
+}
+
+void BinarySerializer::write_int(int64_t value) {
+    if (value >= 0) {
+        write_uint(static_cast<uint64_t>(value));
+    } else if (format_ == BinaryFormat::CBOR) {
+        put_head(kNegative, static_cast<uint64_t>(-1 - value));
+    } else if (value >= -32) {
+        put_byte(static_cast<uint8_t>(value));
+    } else if (value >= INT8_MIN) {
+        put_byte(0xD0);
+        put_byte(static_cast<uint8_t>(value));
+    } else if (value >= INT16_MIN) {
+        put_byte(0xD1);
+        put_be(static_cast<uint64_t>(value), 2);
+    } else if (value >= INT32_MIN) {
+        put_byte(0xD2);
+        put_be(static_cast<uint64_t>(value), 4);
+    } else {
+        put_byte(0xD3);
+        put_be(static_cast<uint64_t>(value), 8);
+    }
+}
+
+void BinarySerializer::write_double(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put_byte(format_ == BinaryFormat::CBOR ? 0xFB : 0xCB);
+    put_be(bits, 8);
+}
+
+void BinarySerializer::write_bool(bool value) {
+    if (format_ == BinaryFormat::CBOR) {
+        put_byte(value ? 0xF5 : 0xF4);
+    } else {
+        put_byte(value ? 0xC3 : 0xC2);
+    }
+}
+
+void BinarySerializer::write_null() {
+    put_byte(format_ == BinaryFormat::CBOR ? 0xF6 : 0xC0);
+}
+
+void BinarySerializer::write_text(std::string_view text) {
+    size_t size = text.size();
+    if (format_ == BinaryFormat::CBOR) {
+        put_head(kTextString, size);
+    } else if (size < 32) {
+        put_byte(static_cast<uint8_t>(0xA0 | size));
+    } else if (size <= 0xFF) {
+        put_byte(0xD9);
+        put_byte(static_cast<uint8_t>(size));
+    } else if (size <= 0xFFFF) {
+        put_byte(0xDA);
+        put_be(size, 2);
+    } else {
+        put_byte(0xDB);
+        put_be(size, 4);
+    }
+    put_data(reinterpret_cast<const uint8_t*>(text.data()), size);
+}
+
+void BinarySerializer::write_bytes(const uint8_t* data, size_t size) {
+    if (format_ == BinaryFormat::CBOR) {
+        put_head(kByteString, size);
+    } else if (size <= 0xFF) {
+        put_byte(0xC4);
+        put_byte(static_cast<uint8_t>(size));
+    } else if (size <= 0xFFFF) {
+        put_byte(0xC5);
+        put_be(size, 2);
+    } else {
+        put_byte(0xC6);
+        put_be(size, 4);
+    }
+    put_data(data, size);
+}
+
+void BinarySerializer::write_array(size_t count) {
+    if (format_ == BinaryFormat::CBOR) {
+        put_head(kArray, count);
+    } else if (count < 16) {
+        put_byte(static_cast<uint8_t>(0x90 | count));
+    } else if (count <= 0xFFFF) {
+        put_byte(0xDC);
+        put_be(count, 2);
+    } else {
+        put_byte(0xDD);
+        put_be(count, 4);
+    }
+}
+
+void BinarySerializer::write_map(size_t count) {
+    if (format_ == BinaryFormat::CBOR) {
+        put_head(kMap, count);
+    } else if (count < 16) {
+        put_byte(static_cast<uint8_t>(0x80 | count));
+    } else if (count <= 0xFFFF) {
+        put_byte(0xDE);
+        put_be(count, 2);
+    } else {
+        put_byte(0xDF);
+        put_be(count, 4);
+    }
+}
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+// Internal little-endian encoding of saved state (sketches, session
+// checkpoints). Readers check every length against the end of the input.
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace skydecoder {
+namespace byte_io {
+
+inline void put_u64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+inline void put_f64(std::vector<uint8_t>& out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put_u64(out, bits);
+}
+
+inline void put_bytes(std::vector<uint8_t>& out, const uint8_t* data, size_t size) {
+    put_u64(out, size);
+    out.insert(out.end(), data, data + size);
+}
+
+inline void put_string(std::vector<uint8_t>& out, const std::string& value) {
+    put_bytes(out, reinterpret_cast<const uint8_t*>(value.data()), value.size());
+}
+
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : cursor_(data), end_(data + size) {}
+
+    bool ok() const { return ok_; }
+    bool at_end() const { return cursor_ == end_; }
+
+    uint64_t u64() {
+        if (!need(8)) {
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<uint64_t>(cursor_[i]) << (8 * i);
+        }
+        cursor_ += 8;
+        return value;
+    }
+
+    double f64() {
+        uint64_t bits = u64();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Pointer to size bytes in the input, nullptr if they are not all there
+    const uint8_t* bytes(size_t& size) {
+        size = static_cast<size_t>(u64());
+        if (!need(size)) {
+            size = 0;
+            return nullptr;
+        }
+        const uint8_t* data = cursor_;
+        cursor_ += size;
+        return data;
+    }
+
+    std::string string() {
+        size_t size;
+        const uint8_t* data = bytes(size);
+        return data ? std::string(reinterpret_cast<const char*>(data), size) : std::string();
+    }
+
+private:
+    bool need(size_t size) {
+        if (!ok_ || static_cast<size_t>(end_ - cursor_) < size) {
+            ok_ = false;
+            return false;
+        }
+        return true;
+    }
+
+    const uint8_t* cursor_;
+    const uint8_t* end_;
+    bool ok_ = true;
+};
+
+} // namespace byte_io
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "skydecoder/cpu_features.h"
+#include "kernels.h"
+#include <atomic>
+#include <stdexcept>
+
+namespace skydecoder {
+
+namespace {
+
+bool is_supported(const CpuFeatures& features, IsaLevel level) {
+    switch (level) {
+        case IsaLevel::SCALAR: return true;
+        case IsaLevel::SSE42: return features.sse42;
+        case IsaLevel::AVX2: return features.avx2 && features.bmi2;
+        case IsaLevel::AVX512: return features.avx512f && features.avx512bw && features.avx2 && features.bmi2;
+    }
+    return false;
+}
+
+const kernels::KernelTable* table_for(IsaLevel level) {
+    switch (level) {
+        case IsaLevel::SCALAR: return &kernels::scalar_table();
+#ifdef SKYDECODER_HAVE_ISA_VARIANTS
+        case IsaLevel::SSE42: return &kernels::sse42_table();
+        case IsaLevel::AVX2: return &kernels::avx2_table();
+        case IsaLevel::AVX512: return &kernels::avx512_table();
+#endif
+        default: return nullptr;
+    }
+}
+
+IsaLevel best_isa() {
+    auto levels = supported_isa_levels();
+    return levels.back();
+}
+
+struct Dispatch {
+    std::atomic<const kernels::KernelTable*> table;
+    std::atomic<IsaLevel> level;
+    
+    Dispatch() {
+        IsaLevel best = best_isa();
+        table.store(table_for(best));
+        level.store(best);
+    }
+};
+
+Dispatch& dispatch() {
+    static Dispatch instance;
+    return instance;
+}
+
+} // namespace
+
+const CpuFeatures& cpu_features() {
+    static const CpuFeatures features = [] {
+        CpuFeatures detected;
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+        detected.sse42 = __builtin_cpu_supports("sse4.2");
+        detected.avx2 = __builtin_cpu_supports("avx2");
+        detected.bmi2 = __builtin_cpu_supports("bmi2");
+        detected.avx512f = __builtin_cpu_supports("avx512f");
+        detected.avx512bw = __builtin_cpu_supports("avx512bw");
+#endif
+        return detected;
+    }();
+    return features;
+}
+
+std::vector<IsaLevel> compiled_isa_levels() {
+    std::vector<IsaLevel> levels = {IsaLevel::SCALAR};
+#ifdef SKYDECODER_HAVE_ISA_VARIANTS
+    levels.push_back(IsaLevel::SSE42);
+    levels.push_back(IsaLevel::AVX2);
+    levels.push_back(IsaLevel::AVX512);
+#endif
+    return levels;
+}
+
+std::vector<IsaLevel> supported_isa_levels() {
+    std::vector<IsaLevel> levels;
+    for (IsaLevel level : compiled_isa_levels()) {
+        if (is_supported(cpu_features(), level)) {
+            levels.push_back(level);
+        }
+    }
+    return levels;
+}
+
+IsaLevel active_isa() {
+    return dispatch().level.load(std::memory_order_relaxed);
+}
+
+bool force_isa(IsaLevel level) {
+    const kernels::KernelTable* table = table_for(level);
+    if (!table || !is_supported(cpu_features(), level)) {
+        return false;
+    }
+    
+    dispatch().table.store(table, std::memory_order_release);
+    dispatch().level.store(level, std::memory_order_relaxed);
+    return true;
+}
+
+void reset_isa() {
+    force_isa(best_isa());
+}
+
+std::string to_string(IsaLevel level) {
+    switch (level) {
+        case IsaLevel::SCALAR: return "scalar";
+        case IsaLevel::SSE42: return "sse4.2";
+        case IsaLevel::AVX2: return "avx2";
+        case IsaLevel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+IsaLevel isa_from_string(const std::string& level) {
+    if (level == "scalar") return IsaLevel::SCALAR;
+    if (level == "sse4.2" || level == "sse42") return IsaLevel::SSE42;
+    if (level == "avx2") return IsaLevel::AVX2;
+    if (level == "avx512" || level == "avx-512") return IsaLevel::AVX512;
+    
+    throw std::runtime_error("Unknown ISA level: " + level);
+}
+
+namespace kernels {
+
+const KernelTable& active() {
+    return *dispatch().table.load(std::memory_order_acquire);
+}
+
+} // namespace kernels
+
+} // namespace skydecoder
\ No newline at end of file
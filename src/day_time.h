@@ -0,0 +1,31 @@
+#pragma once
+
+// Internal reconstruction of absolute times from ASTERIX times of day
+// (seconds since midnight, wrapping every 24 h).
+#include <cmath>
+
+namespace skydecoder {
+namespace day_time {
+
+constexpr double kSecondsPerDay = 86400.0;
+
+// Time of day on the day that puts it nearest the watermark (a time
+// reconstructed earlier, < 0 if none): a record more than 12 h ahead of it
+// belongs to the day before, more than 12 h behind to the day after. The
+// day follows the watermark alone, so it only moves on when the watermark
+// crosses midnight, never for a single late or early record.
+inline double resolve(double time_of_day, double watermark) {
+    if (watermark < 0.0) {
+        return time_of_day;
+    }
+    double time = std::floor(watermark / kSecondsPerDay) * kSecondsPerDay + time_of_day;
+    if (time - watermark > kSecondsPerDay / 2) {
+        time -= kSecondsPerDay;
+    } else if (watermark - time > kSecondsPerDay / 2) {
+        time += kSecondsPerDay;
+    }
+    return time;
+}
+
+} // namespace day_time
+} // namespace skydecoder
\ No newline at end of file
@@ -1,7 +1,23 @@
 #include <skydecoder/asterix_decoder.h>
 #include <skydecoder/utils.h>
+#include <skydecoder/binary_serializer.h>
+#include <skydecoder/parquet_writer.h>
+#include <skydecoder/delta_filter.h>
+#include <skydecoder/file_follower.h>
+#include <skydecoder/decode_session.h>
+#include <skydecoder/partition_sink.h>
+#include <skydecoder/async_file_writer.h>
+#include <skydecoder/quarantine_sink.h>
+#include <skydecoder/cpu_features.h>
+#include <skydecoder/static_cat002.h>
 #include <iostream>
 #include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <bitset>
+#include <csignal>
+#include <cstdio>
+#include <filesystem>
 
 using namespace skydecoder;
 
@@ -30,18 +46,20 @@ void print_message(const AsterixMessage& message) {
             }
             
             // Format value according to type
-            std::visit([&](const auto& value) {
-                using T = std::decay_t<decltype(value)>;
-                if constexpr (std::is_same_v<T, bool>) {
-                    std::cout << (value ? "true" : "false");
-                } else if constexpr (std::is_same_v<T, std::string>) {
-                    std::cout << "\"" << value << "\"";
-                } else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
-                    std::cout << utils::to_hex_string(value);
-                } else {
+            switch (field.value.kind()) {
+                case FieldValue::Kind::BOOL:
+                    std::cout << (field.value.as_bool() ? "true" : "false");
+                    break;
+                case FieldValue::Kind::STRING:
+                    std::cout << "\"" << field.value.as_string() << "\"";
+                    break;
+                case FieldValue::Kind::BYTES:
+                    std::cout << utils::to_hex_string(field.value.to_bytes());
+                    break;
+                default:
                     std::cout << utils::format_value(field.value, field.unit);
-                }
-            }, field.value);
+                    break;
+            }
             
             if (!field.description.empty()) {
                 std::cout << " (" << field.description << ")";
@@ -58,26 +76,331 @@ void print_block_summary(const AsterixBlock& block) {
               << " - Messages: " << block.messages.size() << std::endl;
 }
 
+FileFollower* active_follower = nullptr;
+DecodeSession* active_session = nullptr;
+
+void stop_active_job(int) {
+    if (active_follower) {
+        active_follower->stop();
+    }
+    if (active_session) {
+        active_session->stop();
+    }
+}
+
+// Decode the file as it grows, until interrupted or idle
+int follow_file(AsterixDecoder& decoder, const std::string& path, int idle_seconds) {
+    FollowOptions options;
+    options.idle_timeout_ms = idle_seconds >= 0 ? idle_seconds * 1000 : -1;
+    FileFollower follower(options);
+    if (!follower.open(path)) {
+        std::cerr << follower.error() << std::endl;
+        return 1;
+    }
+    
+    active_follower = &follower;
+    std::signal(SIGINT, stop_active_job);
+    std::signal(SIGTERM, stop_active_job);
+    std::cout << "Following " << path << (follower.using_inotify() ? " (inotify)" : " (polling)") << std::endl;
+    
+    utils::MessageStatistics stats;
+    FollowStatus status = follower.run([&](const uint8_t* data, size_t size, uint64_t offset) {
+        AsterixBlock block = decoder.decode_block(data, size, offset);
+        std::cout << "@" << offset << " ";
+        print_block_summary(block);
+        for (const auto& message : block.messages) {
+            utils::accumulate_statistics(stats, message);
+        }
+        return true;
+    });
+    
+    active_follower = nullptr;
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    
+    const FollowStats& follow_stats = follower.stats();
+    std::cout << "\nFollowed " << follow_stats.blocks << " blocks (" << follow_stats.bytes << " bytes), "
+              << follow_stats.truncations << " truncations, " << follow_stats.rotations << " rotations; next offset "
+              << follower.offset() << std::endl;
+    std::cout << "\n=== DECODING STATISTICS ===" << std::endl;
+    utils::print_statistics(stats);
+    
+    if (status == FollowStatus::FAILED) {
+        std::cerr << follower.error() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Checkpointed decode: resumes where the previous run of the same file
+// stopped, binary output is appended and cut back to the checkpoint
+int run_session(AsterixDecoder& decoder, const std::string& path, const std::string& checkpoint_path,
+                const std::string& binary_output) {
+    SessionOptions options;
+    options.checkpoint_path = checkpoint_path;
+    DecodeSession session(decoder, options);
+    
+    std::string binary_file = binary_output.empty() ? std::string() : "output." + binary_output;
+    AsyncWriterOptions writer_options;
+    writer_options.append = true;
+    AsyncFileWriter out(writer_options);
+    BinarySerializer serializer(binary_output == "msgpack" ? BinaryFormat::MSGPACK : BinaryFormat::CBOR);
+    
+    std::bitset<256> categories_written;    // Their dictionary header is in the output
+    
+    session.set_state_hooks(
+        [&](std::vector<uint8_t>& state) {
+            // Output length and categories at the checkpoint
+            uint64_t length = 0;
+            bool written = true;
+            if (out.is_open()) {
+                written = out.sync();
+                length = out.position();
+            }
+            for (int i = 0; i < 8; ++i) {
+                state.push_back(static_cast<uint8_t>(length >> (8 * i)));
+            }
+            for (size_t category = 0; category < 256; ++category) {
+                if (categories_written.test(category)) {
+                    state.push_back(static_cast<uint8_t>(category));
+                }
+            }
+            return written;
+        },
+        [&](const std::vector<uint8_t>& state) {
+            if (binary_file.empty()) {
+                return true;
+            }
+            uint64_t length = 0;
+            for (size_t i = 0; i < state.size() && i < 8; ++i) {
+                length |= static_cast<uint64_t>(state[i]) << (8 * i);
+            }
+            
+            // Headers already in the kept part of the output are not repeated
+            for (size_t i = 8; i < state.size(); ++i) {
+                if (auto category = decoder.share_category_definition(state[i])) {
+                    serializer.write_header(category);
+                    categories_written.set(state[i]);
+                }
+            }
+            serializer.clear();
+            
+            std::error_code error;
+            if (length == 0 || !std::filesystem::exists(binary_file)) {
+                std::ofstream(binary_file, std::ios::binary | std::ios::trunc);
+            }
+            std::filesystem::resize_file(binary_file, length, error);
+            return !error && out.open(binary_file);
+        });
+    
+    if (!session.open(path)) {
+        std::cerr << session.error() << std::endl;
+        return 1;
+    }
+    std::cout << (session.resumed() ? "Resuming at offset " : "Starting at offset ") << session.offset() << std::endl;
+    
+    active_session = &session;
+    std::signal(SIGINT, stop_active_job);
+    std::signal(SIGTERM, stop_active_job);
+    
+    uint64_t records = 0;
+    bool completed = session.run([&](const AsterixBlock& block, uint64_t) {
+        if (out.is_open()) {
+            serializer.clear();
+            serializer.write(block);
+            categories_written.set(block.category);
+            out.write(serializer.buffer());
+        }
+        records += block.messages.size();
+        return true;
+    });
+    
+    active_session = nullptr;
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    if (out.is_open() && !out.close()) {
+        std::cerr << "Cannot write " << binary_file << ": " << out.error() << std::endl;
+        completed = false;
+    }
+    
+    std::cout << "Decoded " << records << " records in this run, up to offset " << session.offset() << " ("
+              << session.blocks() << " blocks in total, " << session.checkpoints_written() << " checkpoints)" << std::endl;
+    if (!binary_file.empty()) {
+        std::cout << "Records appended to " << binary_file << std::endl;
+    }
+    std::cout << "\n=== DECODING STATISTICS ===" << std::endl;
+    utils::print_statistics(session.statistics());
+    
+    if (!completed) {
+        std::cerr << session.error() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Close the quarantine file and report what went into it
+int finish_quarantine(QuarantineSink& sink, const std::string& path, int status) {
+    if (!sink.is_open()) {
+        return status;
+    }
+    bool written = sink.close();
+    QuarantineStats stats = sink.stats();
+    std::cout << "\n" << stats.written << " blocks quarantined to " << path;
+    for (size_t code = 1; code < 8; ++code) {
+        if (stats.by_error[code] > 0) {
+            std::cout << " " << to_string(static_cast<BlockError>(code)) << "=" << stats.by_error[code];
+        }
+    }
+    std::cout << std::endl;
+    if (stats.dropped_queue_full + stats.dropped_file_limit > 0) {
+        std::cerr << stats.dropped_queue_full + stats.dropped_file_limit << " blocks not quarantined (queue full or size limit)"
+                  << std::endl;
+    }
+    if (!written) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return 1;
+    }
+    return status;
+}
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options] <asterix_file> [category_definitions_dir]" << std::endl;
+    std::cout << "Example: " << program << " data.ast data/asterix_categories/" << std::endl;
+    std::cout << "\nOptions:" << std::endl;
+    std::cout << "  --huge-pages=<none|transparent|explicit>  Huge page policy for file buffers" << std::endl;
+    std::cout << "  --numa-node=<N>                           Allocate buffers and run on NUMA node N" << std::endl;
+    std::cout << "  --force-isa=<scalar|sse4.2|avx2|avx512>   Override the SIMD kernel selection" << std::endl;
+    std::cout << "  --threads=<N>                             Decode large CAT002 blocks on N threads" << std::endl;
+    std::cout << "  --layout=<off|repair|strict>              Verification of the item layouts (default: repair)" << std::endl;
+    std::cout << "  --binary-output=<cbor|msgpack>            Also write every record to output.cbor / output.msgpack" << std::endl;
+    std::cout << "  --parquet=<prefix>                        Also write one Parquet table per category (<prefix>_catNNN.parquet)" << std::endl;
+    std::cout << "  --partition=<directory>                   Also write CBOR files per SAC/SIC and hour of day" << std::endl;
+    std::cout << "  --quarantine=<file>                       Copy blocks that fail to decode to a replayable side file" << std::endl;
+    std::cout << "  --delta-status                            Export I002/050 and I002/060 only when they change" << std::endl;
+    std::cout << "  --range-checks                            Count values outside the field ranges and enum sets" << std::endl;
+    std::cout << "  --follow[=<seconds>]                      Keep decoding as the file grows (until Ctrl-C or idle that long)" << std::endl;
+    std::cout << "  --checkpoint=<file>                       Resumable decode: checkpoint progress, resume from it when present" << std::endl;
+    std::cout << "  --static-categories                       Use the definitions compiled into the binary" << std::endl;
+    std::cout << "  --generate-static=<category.xml>          Print the constexpr tables of a definition and exit" << std::endl;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::cout << "Usage: " << argv[0] << " <asterix_file> [category_definitions_dir]" << std::endl;
-        std::cout << "Example: " << argv[0] << " data.ast data/asterix_categories/" << std::endl;
+    std::vector<std::string> positional;
+    MemoryOptions memory_options;
+    bool use_static_categories = false;
+    size_t threads = 1;
+    LayoutPolicy layout_policy = LayoutPolicy::REPAIR;
+    bool range_checks = false;
+    std::string binary_output;
+    std::string parquet_prefix;
+    bool delta_status = false;
+    int follow_idle_seconds = -2;       // -2: off, -1: until interrupted
+    std::string checkpoint_path;
+    std::string partition_directory;
+    std::string quarantine_path;
+    
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            
+            if (arg.rfind("--huge-pages=", 0) == 0) {
+                memory_options.huge_pages = numa::huge_page_mode_from_string(arg.substr(13));
+            } else if (arg.rfind("--numa-node=", 0) == 0) {
+                memory_options.numa_node = std::stoi(arg.substr(12));
+                memory_options.pin_threads = true;
+            } else if (arg.rfind("--force-isa=", 0) == 0) {
+                IsaLevel level = isa_from_string(arg.substr(12));
+                if (!force_isa(level)) {
+                    std::cerr << "ISA " << to_string(level) << " is not available on this build/CPU" << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--threads=", 0) == 0) {
+                threads = std::stoul(arg.substr(10));
+            } else if (arg.rfind("--layout=", 0) == 0) {
+                layout_policy = layout_policy_from_string(arg.substr(9));
+            } else if (arg.rfind("--binary-output=", 0) == 0) {
+                binary_output = arg.substr(16);
+                if (binary_output != "cbor" && binary_output != "msgpack") {
+                    throw std::invalid_argument("unknown binary format: " + binary_output);
+                }
+            } else if (arg.rfind("--parquet=", 0) == 0) {
+                parquet_prefix = arg.substr(10);
+            } else if (arg.rfind("--partition=", 0) == 0) {
+                partition_directory = arg.substr(12);
+            } else if (arg.rfind("--quarantine=", 0) == 0) {
+                quarantine_path = arg.substr(13);
+            } else if (arg == "--delta-status") {
+                delta_status = true;
+            } else if (arg == "--range-checks") {
+                range_checks = true;
+            } else if (arg == "--follow") {
+                follow_idle_seconds = -1;
+            } else if (arg.rfind("--follow=", 0) == 0) {
+                follow_idle_seconds = std::stoi(arg.substr(9));
+            } else if (arg.rfind("--checkpoint=", 0) == 0) {
+                checkpoint_path = arg.substr(13);
+            } else if (arg == "--static-categories") {
+                use_static_categories = true;
+            } else if (arg.rfind("--generate-static=", 0) == 0) {
+                XmlParser parser;
+                auto category = parser.parse_category(arg.substr(18));
+                std::cout << generate_static_category_source(*category);
+                return 0;
+            } else if (arg == "--help" || arg == "-h") {
+                print_usage(argv[0]);
+                return 0;
+            } else {
+                positional.push_back(arg);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid option: " << e.what() << std::endl;
         return 1;
     }
     
-    std::string asterix_file = argv[1];
-    std::string categories_dir = (argc > 2) ? argv[2] : "data/asterix_categories/";
+    if (positional.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    std::string asterix_file = positional[0];
+    std::string categories_dir = (positional.size() > 1) ? positional[1] : "data/asterix_categories/";
     
     try {
+        // Keep reading, decoding and output on the requested node
+        if (memory_options.pin_threads && !numa::pin_current_thread_to_node(memory_options.numa_node)) {
+            std::cerr << "Warning: cannot pin to NUMA node " << memory_options.numa_node << std::endl;
+        }
+        numa::AccessStats numa_before = numa::read_access_stats(std::max(memory_options.numa_node, 0));
+        
         // Create the decoder
         AsterixDecoder decoder;
         decoder.set_debug_mode(true);
+        decoder.set_memory_options(memory_options);
+        decoder.set_parallel_decoding(threads);
+        decoder.set_layout_policy(layout_policy);
+        decoder.set_range_checks(range_checks);
+        decoder.set_keep_item_bytes(delta_status);     // The delta filter compares item bytes
+        
+        QuarantineSink quarantine;
+        if (!quarantine_path.empty()) {
+            if (!quarantine.open(quarantine_path)) {
+                std::cerr << "Cannot create " << quarantine_path << std::endl;
+                return 1;
+            }
+            decoder.set_quarantine(&quarantine);
+        }
         
         // Load category definitions
-        std::cout << "Loading category definitions from: " << categories_dir << std::endl;
-        if (!decoder.load_categories_from_directory(categories_dir)) {
-            std::cerr << "Failed to load category definitions!" << std::endl;
-            return 1;
+        if (use_static_categories) {
+            std::cout << "Loading built-in category definitions" << std::endl;
+            decoder.load_static_category(static_categories::kCat002);
+        } else {
+            std::cout << "Loading category definitions from: " << categories_dir << std::endl;
+            if (!decoder.load_categories_from_directory(categories_dir)) {
+                std::cerr << "Failed to load category definitions!" << std::endl;
+                return 1;
+            }
         }
         
         // Display supported categories
@@ -87,6 +410,17 @@ int main(int argc, char* argv[]) {
             std::cout << static_cast<int>(cat) << " ";
         }
         std::cout << std::endl;
+        std::cout << "SIMD kernels: " << to_string(active_isa()) << std::endl;
+        
+        if (follow_idle_seconds != -2) {
+            decoder.set_debug_mode(false);
+            return finish_quarantine(quarantine, quarantine_path, follow_file(decoder, asterix_file, follow_idle_seconds));
+        }
+        if (!checkpoint_path.empty()) {
+            decoder.set_debug_mode(false);
+            return finish_quarantine(quarantine, quarantine_path,
+                                     run_session(decoder, asterix_file, checkpoint_path, binary_output));
+        }
         
         // Decode the ASTERIX file
         std::cout << "\nDecoding file: " << asterix_file << std::endl;
@@ -116,6 +450,7 @@ int main(int argc, char* argv[]) {
                 print_message(message);
                 
                 all_messages.push_back(message);
+                utils::accumulate_statistics(stats, message);
                 
                 // Validation
                 if (decoder.validate_message(message)) {
@@ -128,21 +463,119 @@ int main(int argc, char* argv[]) {
         
         // Display final statistics
         std::cout << "\n=== DECODING STATISTICS ===" << std::endl;
-        stats = utils::analyze_messages(all_messages);
         utils::print_statistics(stats);
         
+        if (range_checks) {
+            std::cout << "\n=== RANGE CHECKS ===" << std::endl;
+            for (uint8_t category : decoder.get_supported_categories()) {
+                for (const auto& check : decoder.get_range_check_stats(category)) {
+                    std::cout << check.item_id << "/" << check.field << ": " << check.checked << " checked, "
+                              << check.range_violations << " out of range, "
+                              << check.enum_violations << " not in enum" << std::endl;
+                }
+            }
+        }
+        
+        numa::AccessStats numa_after = numa::read_access_stats(std::max(memory_options.numa_node, 0));
+        auto numa_stats = numa::delta(numa_before, numa_after);
+        if (numa_stats.available && numa::node_count() > 1) {
+            std::cout << "\nNUMA node " << std::max(memory_options.numa_node, 0)
+                      << ": remote access ratio " << std::fixed << std::setprecision(1)
+                      << numa_stats.remote_ratio() * 100.0 << "%" << std::endl;
+        }
+        
+        // Change-only status items in the exports
+        if (delta_status) {
+            DeltaFilter delta;
+            for (auto& message : all_messages) {
+                delta.filter(message);
+            }
+            const DeltaStats& delta_stats = delta.stats();
+            std::cout << "\nDelta filter: " << delta_stats.items_suppressed << " of " << delta_stats.items_seen
+                      << " status items suppressed (" << delta_stats.items_changed << " changes, "
+                      << delta_stats.keyframes << " keyframes)" << std::endl;
+        }
+        
         // Export to JSON (optional)
         if (all_messages.size() > 0) {
             std::cout << "\nExporting first message to JSON..." << std::endl;
             std::string json = utils::to_json(all_messages[0]);
             
-            std::ofstream json_file("output.json");
-            if (json_file) {
-                json_file << json;
+            AsyncFileWriter json_file;
+            if (json_file.open("output.json") && json_file.write(json) && json_file.close()) {
                 std::cout << "JSON exported to output.json" << std::endl;
             }
         }
         
+        if (!binary_output.empty()) {
+            BinarySerializer serializer(binary_output == "cbor" ? BinaryFormat::CBOR : BinaryFormat::MSGPACK);
+            std::string binary_file = "output." + binary_output;
+            AsyncFileWriter out;
+            if (out.open(binary_file)) {
+                // Encoded record by record, the I/O thread writes while the next ones are encoded
+                for (const auto& message : all_messages) {
+                    serializer.write(message);
+                    out.write(serializer.buffer());
+                    serializer.clear();
+                }
+                uint64_t bytes = out.position();
+                AsyncWriterStats writer_stats = out.stats();
+                if (!out.close()) {
+                    std::cerr << "Cannot write " << binary_file << ": " << out.error() << std::endl;
+                    return 1;
+                }
+                std::cout << all_messages.size() << " records exported to " << binary_file << " (" << bytes
+                          << " bytes, " << writer_stats.producer_waits << " writer waits)" << std::endl;
+            }
+        }
+        
+        if (!parquet_prefix.empty()) {
+            std::unordered_map<uint8_t, std::unique_ptr<ParquetWriter>> writers;
+            for (const auto& message : all_messages) {
+                auto& writer = writers[message.category];
+                if (!writer && message.definition) {
+                    char suffix[16];
+                    std::snprintf(suffix, sizeof(suffix), "_cat%03u.parquet", static_cast<unsigned>(message.category));
+                    writer = std::make_unique<ParquetWriter>(message.definition);
+                    if (!writer->open(parquet_prefix + suffix)) {
+                        std::cerr << "Cannot create " << parquet_prefix + suffix << std::endl;
+                        return 1;
+                    }
+                }
+                if (writer) {
+                    writer->write(message);
+                }
+            }
+            for (auto& entry : writers) {
+                if (entry.second && entry.second->close()) {
+                    std::cout << entry.second->rows_written() << " category " << static_cast<int>(entry.first)
+                              << " records exported to Parquet (" << entry.second->row_groups_written()
+                              << " row groups)" << std::endl;
+                }
+            }
+        }
+        
+        if (!partition_directory.empty()) {
+            PartitionOptions options;
+            options.directory = partition_directory;
+            PartitionSink sink(options);
+            for (const auto& message : all_messages) {
+                sink.write(message);
+            }
+            bool written = sink.close();
+            PartitionStats partition_stats = sink.stats();
+            std::cout << partition_stats.records << " records partitioned into " << partition_stats.partitions_completed
+                      << " files in " << partition_directory << std::endl;
+            if (!written) {
+                std::cerr << partition_stats.errors << " partition writes failed" << std::endl;
+                return 1;
+            }
+        }
+        
+        if (finish_quarantine(quarantine, quarantine_path, 0) != 0) {
+            return 1;
+        }
+        
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
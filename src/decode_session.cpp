@@ -0,0 +1,325 @@
+#include "skydecoder/decode_session.h"
+#include "byte_io.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace skydecoder {
+
+namespace {
+
+constexpr uint64_t kCheckpointMagic = 0x43594B53;   // "SKYC"
+constexpr uint64_t kCheckpointVersion = 2;
+
+uint64_t fnv1a(const uint8_t* data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+void put_sketch(std::vector<uint8_t>& out, const std::vector<uint8_t>& sketch) {
+    byte_io::put_bytes(out, sketch.data(), sketch.size());
+}
+
+void put_statistics(std::vector<uint8_t>& out, const utils::MessageStatistics& stats) {
+    byte_io::put_u64(out, stats.total_messages);
+    byte_io::put_u64(out, stats.valid_messages);
+    byte_io::put_u64(out, stats.invalid_messages);
+
+    byte_io::put_u64(out, stats.category_counts.size());
+    for (const auto& pair : stats.category_counts) {
+        byte_io::put_u64(out, pair.first);
+        byte_io::put_u64(out, pair.second);
+    }
+    byte_io::put_u64(out, stats.data_item_counts.size());
+    for (const auto& pair : stats.data_item_counts) {
+        byte_io::put_string(out, pair.first);
+        byte_io::put_u64(out, pair.second);
+    }
+    byte_io::put_u64(out, stats.error_counts.size());
+    for (const auto& pair : stats.error_counts) {
+        byte_io::put_string(out, pair.first);
+        byte_io::put_u64(out, pair.second);
+    }
+    byte_io::put_u64(out, stats.other_errors);
+
+    put_sketch(out, stats.warning_codes.serialize());
+    put_sketch(out, stats.fspec_patterns.serialize());
+    put_sketch(out, stats.radars.serialize());
+}
+
+bool read_statistics(byte_io::Reader& reader, utils::MessageStatistics& stats) {
+    stats.total_messages = reader.u64();
+    stats.valid_messages = reader.u64();
+    stats.invalid_messages = reader.u64();
+
+    for (uint64_t count = reader.u64(); reader.ok() && count > 0; --count) {
+        uint8_t category = static_cast<uint8_t>(reader.u64());
+        stats.category_counts[category] = reader.u64();
+    }
+    for (uint64_t count = reader.u64(); reader.ok() && count > 0; --count) {
+        std::string item = reader.string();
+        stats.data_item_counts[item] = reader.u64();
+    }
+    uint64_t messages = reader.u64();
+    if (messages > utils::MessageStatistics::kMaxErrorMessages) {
+        return false;
+    }
+    for (; reader.ok() && messages > 0; --messages) {
+        std::string error = reader.string();
+        stats.error_counts[error] = reader.u64();
+    }
+    stats.other_errors = reader.u64();
+
+    size_t size;
+    const uint8_t* data = reader.bytes(size);
+    if (!reader.ok() || !stats.warning_codes.deserialize(data, size)) {
+        return false;
+    }
+    data = reader.bytes(size);
+    if (!reader.ok() || !stats.fspec_patterns.deserialize(data, size)) {
+        return false;
+    }
+    data = reader.bytes(size);
+    return reader.ok() && stats.radars.deserialize(data, size);
+}
+
+bool file_size(const std::string& path, uint64_t& size) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+    size = static_cast<uint64_t>(info.st_size);
+    return true;
+}
+
+} // namespace
+
+DecodeSession::DecodeSession(AsterixDecoder& decoder, SessionOptions options)
+    : decoder_(decoder), options_(std::move(options)), reader_([&] {
+          FollowOptions follow;
+          follow.buffer_size = options_.buffer_size;
+          follow.use_inotify = false;
+          return follow;
+      }()) {}
+
+void DecodeSession::set_state_hooks(SaveHook save, RestoreHook restore) {
+    save_hook_ = std::move(save);
+    restore_hook_ = std::move(restore);
+}
+
+bool DecodeSession::open(const std::string& path) {
+    path_ = path;
+    resumed_ = false;
+    offset_ = 0;
+    blocks_ = 0;
+    statistics_ = utils::MessageStatistics();
+    error_.clear();
+    stop_requested_.store(false);
+
+    struct stat info;
+    if (!options_.checkpoint_path.empty() && stat(options_.checkpoint_path.c_str(), &info) == 0) {
+        SessionCheckpoint checkpoint;
+        if (!read_checkpoint(options_.checkpoint_path, checkpoint)) {
+            error_ = "Unreadable checkpoint " + options_.checkpoint_path;
+            return false;
+        }
+        if (checkpoint.file != path) {
+            error_ = "Checkpoint " + options_.checkpoint_path + " belongs to " + checkpoint.file;
+            return false;
+        }
+
+        uint64_t size = 0;
+        // A file may only have grown since; a shorter one was replaced or truncated
+        if (!file_size(path, size) || size < checkpoint.offset || size < checkpoint.file_size) {
+            error_ = "File " + path + " is shorter than at the checkpoint";
+            return false;
+        }
+        if (restore_hook_ && !restore_hook_(checkpoint.user_state)) {
+            error_ = "Cannot restore the state of checkpoint " + options_.checkpoint_path;
+            return false;
+        }
+
+        offset_ = checkpoint.offset;
+        blocks_ = checkpoint.blocks;
+        statistics_ = std::move(checkpoint.statistics);
+        resumed_ = true;
+    } else if (restore_hook_ && !restore_hook_(std::vector<uint8_t>())) {
+        error_ = "Cannot reset the output state";
+        return false;
+    }
+
+    if (!reader_.open(path, offset_)) {
+        error_ = reader_.error();
+        return false;
+    }
+    return true;
+}
+
+bool DecodeSession::run(const BlockHandler& handler) {
+    if (!error_.empty()) {
+        return false;
+    }
+
+    last_checkpoint_ = std::chrono::steady_clock::now();
+    blocks_since_checkpoint_ = 0;
+
+    reader_.read_available([&](const uint8_t* data, size_t size, uint64_t offset) {
+        AsterixBlock block = decoder_.decode_block(data, size, offset);
+        for (const auto& message : block.messages) {
+            utils::accumulate_statistics(statistics_, message);
+        }
+        bool more = handler(block, offset);
+
+        offset_ = offset + size;
+        blocks_++;
+        blocks_since_checkpoint_++;
+
+        bool due = options_.checkpoint_blocks > 0 && blocks_since_checkpoint_ >= options_.checkpoint_blocks;
+        if (!due && options_.checkpoint_interval_ms > 0 && (blocks_since_checkpoint_ & 63) == 0) {
+            due = std::chrono::steady_clock::now() - last_checkpoint_ >=
+                  std::chrono::milliseconds(options_.checkpoint_interval_ms);
+        }
+        if (due) {
+            checkpoint();
+        }
+        return more && !stop_requested_.load();
+    });
+
+    if (!reader_.error().empty()) {
+        error_ = reader_.error();
+        return false;
+    }
+    return checkpoint();
+}
+
+bool DecodeSession::checkpoint() {
+    last_checkpoint_ = std::chrono::steady_clock::now();
+    blocks_since_checkpoint_ = 0;
+    if (options_.checkpoint_path.empty()) {
+        return true;
+    }
+
+    SessionCheckpoint checkpoint;
+    checkpoint.file = path_;
+    file_size(path_, checkpoint.file_size);
+    checkpoint.offset = offset_;
+    checkpoint.blocks = blocks_;
+    checkpoint.statistics = statistics_;
+    if (save_hook_ && !save_hook_(checkpoint.user_state)) {
+        error_ = "Save hook failed, output not synced";
+        return false;
+    }
+
+    if (!write_checkpoint(options_.checkpoint_path, checkpoint)) {
+        error_ = "Cannot write checkpoint " + options_.checkpoint_path;
+        return false;
+    }
+    checkpoints_written_++;
+    return true;
+}
+
+bool DecodeSession::read_checkpoint(const std::string& path, SessionCheckpoint& checkpoint) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < 8) {
+        return false;
+    }
+
+    byte_io::Reader trailer(data.data() + data.size() - 8, 8);
+    if (trailer.u64() != fnv1a(data.data(), data.size() - 8)) {
+        return false;
+    }
+
+    byte_io::Reader reader(data.data(), data.size() - 8);
+    if (reader.u64() != kCheckpointMagic || reader.u64() != kCheckpointVersion) {
+        return false;
+    }
+    checkpoint.file = reader.string();
+    checkpoint.file_size = reader.u64();
+    checkpoint.offset = reader.u64();
+    checkpoint.blocks = reader.u64();
+    if (!read_statistics(reader, checkpoint.statistics)) {
+        return false;
+    }
+
+    size_t size;
+    const uint8_t* state = reader.bytes(size);
+    if (!reader.ok() || !reader.at_end()) {
+        return false;
+    }
+    checkpoint.user_state.assign(state, state + size);
+    return true;
+}
+
+bool DecodeSession::write_checkpoint(const std::string& path, const SessionCheckpoint& checkpoint) {
+    std::vector<uint8_t> data;
+    byte_io::put_u64(data, kCheckpointMagic);
+    byte_io::put_u64(data, kCheckpointVersion);
+    byte_io::put_string(data, checkpoint.file);
+    byte_io::put_u64(data, checkpoint.file_size);
+    byte_io::put_u64(data, checkpoint.offset);
+    byte_io::put_u64(data, checkpoint.blocks);
+    put_statistics(data, checkpoint.statistics);
+    byte_io::put_bytes(data, checkpoint.user_state.data(), checkpoint.user_state.size());
+    byte_io::put_u64(data, fnv1a(data.data(), data.size()));
+
+    // Write aside, then replace: a crash leaves the previous checkpoint whole
+    std::string temporary = path + ".tmp";
+#ifndef _WIN32
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t result = ::write(fd, data.data() + written, data.size() - written);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            ::close(fd);
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    bool synced = fsync(fd) == 0;
+    ::close(fd);
+    if (!synced || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        return false;
+    }
+
+    // Make the rename itself durable
+    size_t slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int directory_fd = ::open(directory.c_str(), O_RDONLY);
+    if (directory_fd >= 0) {
+        fsync(directory_fd);
+        ::close(directory_fd);
+    }
+    return true;
+#else
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+            return false;
+        }
+    }
+    std::remove(path.c_str());
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+#endif
+}
+
+} // namespace skydecoder
\ No newline at end of file
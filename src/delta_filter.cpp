@@ -0,0 +1,158 @@
+#include "skydecoder/delta_filter.h"
+#include <cstring>
+
+namespace skydecoder {
+
+namespace {
+
+// Data Source Identifier: I<cat>/010 in every category
+bool is_source_identifier(const std::string& item_id) {
+    return item_id.size() >= 4 && item_id.compare(item_id.size() - 4, 4, "/010") == 0;
+}
+
+uint16_t radar_of(const AsterixMessage& message) {
+    for (const auto& item : message.data_items) {
+        if (!is_source_identifier(item.id)) {
+            continue;
+        }
+        uint16_t sac = 0;
+        uint16_t sic = 0;
+        for (const auto& field : item.fields) {
+            if (field.name == "SAC") {
+                sac = static_cast<uint16_t>(field.value.as_unsigned());
+            } else if (field.name == "SIC") {
+                sic = static_cast<uint16_t>(field.value.as_unsigned());
+            }
+        }
+        return static_cast<uint16_t>((sac << 8) | (sic & 0xFF));
+    }
+    return 0;
+}
+
+} // namespace
+
+DeltaFilter::DeltaFilter(DeltaOptions options)
+    : options_(std::move(options)) {}
+
+void DeltaFilter::reset() {
+    states_.clear();
+}
+
+int DeltaFilter::tracked_index(const std::string& item_id) const {
+    for (size_t i = 0; i < options_.items.size(); ++i) {
+        if (options_.items[i] == item_id) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool DeltaFilter::observe(uint16_t radar, int tracked, const uint8_t* value, size_t size) {
+    State& state = states_[(static_cast<uint64_t>(radar) << 32) | static_cast<uint32_t>(tracked)];
+    stats_.items_seen++;
+
+    bool same = state.seen && state.last.size() == size &&
+                (size == 0 || std::memcmp(state.last.data(), value, size) == 0);
+    if (!same) {
+        state.last.assign(value, value + size);
+        state.seen = true;
+        state.since_keyframe = 0;
+        stats_.items_changed++;
+        return true;
+    }
+
+    if (options_.keyframe_interval != 0 && ++state.since_keyframe >= options_.keyframe_interval) {
+        state.since_keyframe = 0;
+        stats_.keyframes++;
+        return true;
+    }
+
+    stats_.items_suppressed++;
+    return false;
+}
+
+bool DeltaFilter::filter(AsterixMessage& message) {
+    stats_.records_in++;
+    uint16_t radar = radar_of(message);
+
+    bool tracked_seen = false;
+    bool any_passed = false;
+    std::vector<bool> unchanged(message.data_items.size(), false);
+
+    for (size_t i = 0; i < message.data_items.size(); ++i) {
+        const ParsedDataItem& item = message.data_items[i];
+        int tracked = tracked_index(item.id);
+        if (tracked < 0) {
+            continue;
+        }
+        tracked_seen = true;
+
+        if (item.raw.empty()) {
+            stats_.items_seen++;
+            stats_.items_without_bytes++;
+            any_passed = true;
+            continue;
+        }
+        if (observe(radar, tracked, item.raw.data(), item.raw.size())) {
+            any_passed = true;
+        } else {
+            unchanged[i] = true;
+        }
+    }
+
+    if (options_.mode == DeltaMode::RECORDS) {
+        bool keep = !tracked_seen || any_passed;
+        if (keep) {
+            stats_.records_out++;
+        }
+        return keep;
+    }
+
+    // Strip the unchanged tracked items, keeping the order of the others
+    size_t kept = 0;
+    for (size_t i = 0; i < message.data_items.size(); ++i) {
+        if (!unchanged[i]) {
+            if (kept != i) {
+                message.data_items[kept] = std::move(message.data_items[i]);
+            }
+            ++kept;
+        }
+    }
+    message.data_items.erase(message.data_items.begin() + kept, message.data_items.end());
+
+    stats_.records_out++;
+    return true;
+}
+
+bool DeltaFilter::filter(const LazyRecord& record) {
+    stats_.records_in++;
+
+    uint16_t radar = 0;
+    for (size_t i = 0; i < record.item_count(); ++i) {
+        if (is_source_identifier(record.item_id(i)) && record.item_size(i) >= 2) {
+            radar = static_cast<uint16_t>((record.item_data(i)[0] << 8) | record.item_data(i)[1]);
+            break;
+        }
+    }
+
+    bool tracked_seen = false;
+    bool any_passed = false;
+    for (size_t i = 0; i < record.item_count(); ++i) {
+        int tracked = tracked_index(record.item_id(i));
+        if (tracked < 0) {
+            continue;
+        }
+        tracked_seen = true;
+        if (observe(radar, tracked, record.item_data(i), record.item_size(i))) {
+            any_passed = true;
+        }
+    }
+
+    bool keep = !tracked_seen || any_passed;
+    if (keep) {
+        stats_.records_out++;
+    }
+    return keep;
+}
+
+} // namespace skydecoder
\ No newline at end of file
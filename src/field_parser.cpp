@@ -1,31 +1,68 @@
 #include "skydecoder/field_parser.h"
+#include "kernels.h"
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
-#include <bitset>
 
 namespace skydecoder {
 
 ParsedField FieldParser::parse_field(const Field& field_def, ParseContext& context) {
+    // Fields read through a context are byte aligned
+    ParsedField result = parse_field_at(field_def, context.current(), context.size - context.position, 0,
+                                        context.arena, true);
+    
+    if (result.valid) {
+        context.position += (field_def.bits + 7) / 8;
+    }
+    
+    return result;
+}
+
+ValueArena& FieldParser::arena_for(std::shared_ptr<ValueArena>& arena) {
+    if (!arena) {
+        arena = std::make_shared<ValueArena>();
+    }
+    return *arena;
+}
+
+ParsedField FieldParser::parse_field_at(const Field& field_def, const uint8_t* data, size_t size,
+                                        size_t bit_offset, std::shared_ptr<ValueArena>& arena,
+                                        bool check_bounds) {
     ParsedField result;
     result.name = field_def.name;
     result.description = field_def.description;
     result.unit = field_def.unit;
     
-    try {
-        // Read the necessary bytes for this field
-        auto field_bytes = read_field_bytes(field_def, context);
-        
+    // Check that the bits of this field are available
+    if (check_bounds && (bit_offset + field_def.bits + 7) / 8 > size) {
+        result.valid = false;
+        result.error_message = "Insufficient data";
+        return result;
+    }
+    
+    const uint8_t* field_data = data + bit_offset / 8;
+    size_t field_bytes = (field_def.bits + 7) / 8;
+    
+    // A BYTES field without bits takes the rest of the item
+    if (field_def.type == FieldType::BYTES && field_def.bits == 0) {
+        field_bytes = size - std::min(size, bit_offset / 8);
+    }
+    
+    if (field_def.type == FieldType::BYTES) {
+        result.value = make_bytes_value(arena_for(arena), field_data, field_bytes);
+    } else if (field_def.type == FieldType::STRING && field_def.encoding.has_value() &&
+               field_def.encoding.value() == "6bit_ascii") {
+        result.value = make_string_value(arena_for(arena),
+            decode_6bit_ascii(std::vector<uint8_t>(field_data, field_data + field_bytes)));
+    } else if (field_def.bits > 32) {
+        result.valid = false;
+        result.error_message = "Cannot extract more than 32 bits";
+    } else {
         // Extract the raw value according to the number of bits
-        uint32_t raw_value = extract_bits(field_bytes, 0, field_def.bits);
+        uint32_t raw_value = core::extract_bits(data, bit_offset, field_def.bits);
         
         // Convert to typed value
-        result.value = convert_raw_value(raw_value, field_def);
-        
-        result.valid = true;
-    } catch (const std::exception& e) {
-        result.valid = false;
-        result.error_message = e.what();
+        result.value = convert_raw_value(raw_value, field_def, arena);
     }
     
     return result;
@@ -51,11 +88,14 @@ ParsedDataItem FieldParser::parse_data_item(const DataItem& item_def, ParseConte
                 break;
                 
             case DataFormat::EXPLICIT:
-                // The first byte indicates the length
+                // The first byte indicates the length, itself included
                 if (!context.has_data(1)) {
                     throw std::runtime_error("Insufficient data for explicit length");
                 }
                 bytes_to_read = context.read_uint8();
+                if (bytes_to_read == 0) {
+                    throw std::runtime_error("Invalid explicit length");
+                }
                 break;
                 
             case DataFormat::REPETITIVE:
@@ -66,7 +106,8 @@ ParsedDataItem FieldParser::parse_data_item(const DataItem& item_def, ParseConte
                 {
                     uint8_t rep_count = context.read_uint8();
                     if (item_def.length.has_value()) {
-                        bytes_to_read = rep_count * item_def.length.value();
+                        // The repetition factor octet is part of the item
+                        bytes_to_read = 1 + rep_count * item_def.length.value();
                     } else {
                         throw std::runtime_error("Repetitive format requires length specification");
                     }
@@ -91,39 +132,13 @@ ParsedDataItem FieldParser::parse_data_item(const DataItem& item_def, ParseConte
                 break;
         }
         
-        // Create a temporary context for the data of this item
-        ParseContext item_context(context.data + start_position, bytes_to_read, context.category);
-        
-        // Parse all fields
-        size_t bit_offset = 0;
-        for (const auto& field_def : item_def.fields) {
-            if (field_def.name == "spare") {
-                // Ignore spare fields
-                bit_offset += field_def.bits;
-                continue;
-            }
-            
-            // Create a context for this specific field
-            ParseContext field_context = item_context;
-            field_context.position = bit_offset / 8;
-            
-            auto parsed_field = parse_field(field_def, field_context);
-            result.fields.push_back(parsed_field);
-            
-            // Check if there are extension fields
-            if (field_def.condition.has_value() && !field_def.extension_fields.empty()) {
-                if (evaluate_condition(field_def.condition.value(), result.fields)) {
-                    auto extension_fields = parse_extension_fields(
-                        field_def.extension_fields, item_context, result.fields
-                    );
-                    result.fields.insert(result.fields.end(), 
-                                       extension_fields.begin(), extension_fields.end());
-                }
-            }
-            
-            bit_offset += field_def.bits;
+        // Sizes are counted from the start of the item
+        if (start_position + bytes_to_read > context.size) {
+            throw std::runtime_error("Insufficient data for data item");
         }
         
+        parse_item_fields(item_def, context.data + start_position, bytes_to_read, context.arena, result);
+        
         // Advance the main context
         context.position = start_position + bytes_to_read;
         result.valid = true;
@@ -136,56 +151,108 @@ ParsedDataItem FieldParser::parse_data_item(const DataItem& item_def, ParseConte
     return result;
 }
 
-std::vector<ParsedField> FieldParser::parse_extension_fields(
-    const std::vector<Field>& extension_fields,
-    ParseContext& context,
-    const std::vector<ParsedField>& parsed_fields) {
-    
-    std::vector<ParsedField> result;
+ParsedDataItem FieldParser::parse_fixed_item(const DataItem& item_def, const uint8_t* data,
+                                             std::shared_ptr<ValueArena>& arena) {
+    ParsedDataItem result;
+    result.id = item_def.id;
+    result.name = item_def.name;
     
-    for (const auto& field_def : extension_fields) {
-        if (field_def.name == "spare") {
-            continue; // Ignore spare fields
-        }
-        
-        auto parsed_field = parse_field(field_def, context);
-        result.push_back(parsed_field);
+    try {
+        parse_item_fields(item_def, data, item_def.length.value_or(0), arena, result);
+        result.valid = true;
+    } catch (const std::exception& e) {
+        result.valid = false;
+        result.error_message = e.what();
     }
     
     return result;
 }
 
-uint32_t FieldParser::extract_bits(const std::vector<uint8_t>& data, size_t start_bit, size_t num_bits) {
-    if (num_bits > 32) {
-        throw std::runtime_error("Cannot extract more than 32 bits");
-    }
+size_t FieldParser::measure_data_item(const DataItem& item_def, const uint8_t* data, size_t size) {
+    size_t item_size = 0;
     
-    uint32_t result = 0;
-    size_t byte_offset = start_bit / 8;
-    size_t bit_offset = start_bit % 8;
+    switch (item_def.format) {
+        case DataFormat::FIXED:
+            item_size = item_def.length.value_or(0);
+            break;
+            
+        case DataFormat::EXPLICIT:
+            // The length octet counts itself
+            if (size < 1) {
+                return 0;
+            }
+            item_size = data[0];
+            break;
+            
+        case DataFormat::REPETITIVE:
+            // Repetition count followed by fixed-length repetitions
+            if (size < 1 || !item_def.length.has_value()) {
+                return 0;
+            }
+            item_size = 1 + static_cast<size_t>(data[0]) * item_def.length.value();
+            break;
+            
+        case DataFormat::VARIABLE:
+            item_size = core::fx_chain_length(data, size);
+            break;
+    }
     
-    for (size_t i = 0; i < num_bits; ++i) {
-        size_t current_byte = byte_offset + (bit_offset + i) / 8;
-        size_t current_bit = 7 - ((bit_offset + i) % 8); // MSB first
+    return item_size <= size ? item_size : 0;
+}
+
+void FieldParser::parse_item_fields(const DataItem& item_def, const uint8_t* data, size_t size,
+                                    std::shared_ptr<ValueArena>& arena, ParsedDataItem& result) {
+    // Fields are located at their bit offsets within the item
+    size_t bit_offset = 0;
+    result.fields.reserve(item_def.fields.size());
+    for (const auto& field_def : item_def.fields) {
+        if (field_def.name == "spare") {
+            // Ignore spare fields
+            bit_offset += field_def.bits;
+            continue;
+        }
+        
+        result.fields.push_back(parse_field_at(field_def, data, size, bit_offset, arena, !item_def.verified));
         
-        if (current_byte >= data.size()) {
-            throw std::runtime_error("Bit extraction exceeds data size");
+        // Check if there are extension fields
+        if (field_def.condition.has_value() && !field_def.extension_fields.empty()) {
+            if (evaluate_condition(field_def.condition.value(), result.fields)) {
+                // Extension fields follow the field carrying the condition
+                size_t extension_offset = bit_offset + field_def.bits;
+                for (const auto& extension_def : field_def.extension_fields) {
+                    if (extension_def.name != "spare") {
+                        result.fields.push_back(
+                            parse_field_at(extension_def, data, size, extension_offset, arena, true));
+                    }
+                    extension_offset += extension_def.bits;
+                }
+            }
         }
         
-        if (data[current_byte] & (1 << current_bit)) {
-            result |= (1 << (num_bits - 1 - i));
+        bit_offset += field_def.bits;
+    }
+}
+
+std::vector<ParsedField> FieldParser::parse_extension_fields(
+    const std::vector<Field>& extension_fields,
+    ParseContext& context,
+    const std::vector<ParsedField>& parsed_fields) {
+    
+    std::vector<ParsedField> result;
+    
+    for (const auto& field_def : extension_fields) {
+        if (field_def.name == "spare") {
+            continue; // Ignore spare fields
         }
+        
+        result.push_back(parse_field(field_def, context));
     }
     
     return result;
 }
 
-std::vector<uint8_t> FieldParser::read_field_bytes(const Field& field, ParseContext& context) {
-    size_t bytes_needed = (field.bits + 7) / 8; // Round up
-    return context.read_bytes(bytes_needed);
-}
-
-FieldValue FieldParser::convert_raw_value(uint32_t raw_value, const Field& field) {
+FieldValue FieldParser::convert_raw_value(uint32_t raw_value, const Field& field,
+                                          std::shared_ptr<ValueArena>& arena) {
     switch (field.type) {
         // Small unsigned integers (fit in uint8_t)
         case FieldType::UINT8:
@@ -196,55 +263,35 @@ FieldValue FieldParser::convert_raw_value(uint32_t raw_value, const Field& field
         case FieldType::UINT5:
         case FieldType::UINT6:
         case FieldType::UINT7:
-            return static_cast<uint8_t>(raw_value);
+            return FieldValue::from_unsigned(static_cast<uint8_t>(raw_value), 1);
             
         // Medium unsigned integers (fit in uint16_t)
         case FieldType::UINT16:
         case FieldType::UINT12:
         case FieldType::UINT14:
-            return static_cast<uint16_t>(raw_value);
+            return FieldValue::from_unsigned(static_cast<uint16_t>(raw_value), 2);
             
         // Large unsigned integers
         case FieldType::UINT24:
         case FieldType::UINT32:
-            return raw_value;
+            return FieldValue::from_unsigned(raw_value, 4);
             
-        // Signed integers - need to handle two's complement conversion
+        // Signed integers - two's complement conversion
         case FieldType::INT8:
-            {
-                // Convert to signed 8-bit
-                if (raw_value & 0x80) {
-                    return static_cast<int8_t>(raw_value | 0xFFFFFF00);
-                } else {
-                    return static_cast<int8_t>(raw_value);
-                }
-            }
+            return FieldValue::from_signed(static_cast<int8_t>(core::sign_extend(raw_value, 8)), 1);
             
         case FieldType::INT16:
-            {
-                // Convert to signed 16-bit
-                if (raw_value & 0x8000) {
-                    return static_cast<int16_t>(raw_value | 0xFFFF0000);
-                } else {
-                    return static_cast<int16_t>(raw_value);
-                }
-            }
+            return FieldValue::from_signed(static_cast<int16_t>(core::sign_extend(raw_value, 16)), 2);
             
         case FieldType::INT24:
-            {
-                // Convert to signed 24-bit (stored in int32_t)
-                if (raw_value & 0x800000) {
-                    return static_cast<int32_t>(raw_value | 0xFF000000);
-                } else {
-                    return static_cast<int32_t>(raw_value);
-                }
-            }
+            // Stored in int32_t
+            return FieldValue::from_signed(core::sign_extend(raw_value, 24), 4);
             
         case FieldType::INT32:
-            return static_cast<int32_t>(raw_value);
+            return FieldValue::from_signed(static_cast<int32_t>(raw_value), 4);
             
         case FieldType::BOOL:
-            return raw_value != 0;
+            return FieldValue::from_bool(raw_value != 0);
             
         case FieldType::STRING:
             if (field.encoding.has_value() && field.encoding.value() == "6bit_ascii") {
@@ -253,9 +300,9 @@ FieldValue FieldParser::convert_raw_value(uint32_t raw_value, const Field& field
                 for (size_t i = 0; i < num_bytes; ++i) {
                     bytes.push_back((raw_value >> (8 * (num_bytes - 1 - i))) & 0xFF);
                 }
-                return decode_6bit_ascii(bytes);
+                return make_string_value(arena_for(arena), decode_6bit_ascii(bytes));
             } else {
-                return std::to_string(raw_value);
+                return make_string_value(arena_for(arena), std::to_string(raw_value));
             }
             
         case FieldType::BYTES:
@@ -265,11 +312,11 @@ FieldValue FieldParser::convert_raw_value(uint32_t raw_value, const Field& field
                 for (size_t i = 0; i < num_bytes; ++i) {
                     bytes.push_back((raw_value >> (8 * (num_bytes - 1 - i))) & 0xFF);
                 }
-                return bytes;
+                return make_bytes_value(arena_for(arena), bytes.data(), bytes.size());
             }
     }
     
-    return raw_value;
+    return FieldValue::from_unsigned(raw_value, 4);
 }
 
 std::string FieldParser::decode_6bit_ascii(const std::vector<uint8_t>& data) {
@@ -279,19 +326,11 @@ std::string FieldParser::decode_6bit_ascii(const std::vector<uint8_t>& data) {
     const char icao_alphabet[] = " ABCDEFGHIJKLMNOPQRSTUVWXYZ     0123456789      ";
     
     // Extract characters 6 bits at a time
-    size_t total_bits = data.size() * 8;
-    for (size_t bit_pos = 0; bit_pos < total_bits; bit_pos += 6) {
-        if (bit_pos + 6 > total_bits) break;
-        
-        uint8_t char_code = 0;
-        for (int i = 0; i < 6; ++i) {
-            size_t byte_idx = (bit_pos + i) / 8;
-            size_t bit_idx = 7 - ((bit_pos + i) % 8);
-            
-            if (data[byte_idx] & (1 << bit_idx)) {
-                char_code |= (1 << (5 - i));
-            }
-        }
+    std::vector<uint8_t> codes(data.size() * 8 / 6 + 1);
+    size_t count = kernels::active().unpack_6bit(data.data(), data.size(), codes.data());
+    
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t char_code = codes[i];
         
         if (char_code < sizeof(icao_alphabet)) {
             char c = icao_alphabet[char_code];
@@ -324,12 +363,11 @@ bool FieldParser::evaluate_condition(const std::string& condition, const std::ve
         for (const auto& field : fields) {
             if (field.name == field_name) {
                 // Check the value
-                if (std::holds_alternative<bool>(field.value)) {
-                    bool field_val = std::get<bool>(field.value);
+                if (field.value.kind() == FieldValue::Kind::BOOL) {
+                    bool field_val = field.value.as_bool();
                     return (expected_value == "1" && field_val) || (expected_value == "0" && !field_val);
-                } else if (std::holds_alternative<uint8_t>(field.value)) {
-                    uint8_t field_val = std::get<uint8_t>(field.value);
-                    return field_val == std::stoi(expected_value);
+                } else if (field.value.kind() == FieldValue::Kind::UNSIGNED && field.value.width() == 1) {
+                    return field.value.as_unsigned() == static_cast<uint64_t>(std::stoi(expected_value));
                 }
             }
         }
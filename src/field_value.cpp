@@ -0,0 +1,32 @@
+#include "skydecoder/field_value.h"
+#include <cstring>
+
+namespace skydecoder {
+
+const uint8_t* ValueArena::store(const uint8_t* data, size_t size) {
+    if (size == 0) {
+        return nullptr;
+    }
+    
+    if (size > kChunkSize) {
+        // Oversized payloads get a chunk of their own
+        chunks_.push_back(std::make_unique<uint8_t[]>(size));
+        chunk_used_ = kChunkSize;
+        used_ += size;
+        std::memcpy(chunks_.back().get(), data, size);
+        return chunks_.back().get();
+    }
+    
+    if (chunk_used_ + size > kChunkSize) {
+        chunks_.push_back(std::make_unique<uint8_t[]>(kChunkSize));
+        chunk_used_ = 0;
+    }
+    
+    uint8_t* out = chunks_.back().get() + chunk_used_;
+    std::memcpy(out, data, size);
+    chunk_used_ += size;
+    used_ += size;
+    return out;
+}
+
+} // namespace skydecoder
\ No newline at end of file
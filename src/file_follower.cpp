@@ -0,0 +1,274 @@
+#include "skydecoder/file_follower.h"
+#include "skydecoder/decode_core.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+namespace skydecoder {
+
+namespace {
+
+constexpr size_t kMaxBlockSize = 65535;
+
+} // namespace
+
+FileFollower::FileFollower(FollowOptions options) : options_(options) {
+    buffer_.resize(std::max(options_.buffer_size, kMaxBlockSize + 1));
+    options_.poll_interval_ms = std::max(options_.poll_interval_ms, 1);
+}
+
+FileFollower::~FileFollower() {
+    close();
+}
+
+void FileFollower::reset_buffer(uint64_t offset) {
+    stats_.discarded_bytes += end_ - begin_;
+    begin_ = 0;
+    end_ = 0;
+    offset_ = offset;
+    read_position_ = offset;
+}
+
+#ifndef _WIN32
+
+bool FileFollower::open(const std::string& path, uint64_t offset) {
+    close();
+    path_ = path;
+    error_.clear();
+    handler_stopped_ = false;
+    stop_requested_.store(false);
+
+    if (!reopen()) {
+        return false;
+    }
+    reset_buffer(offset);
+    stats_.discarded_bytes = 0;
+    setup_watch();
+    return true;
+}
+
+bool FileFollower::reopen() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = ::open(path_.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        error_ = "Cannot open " + path_ + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd_, &info) != 0) {
+        error_ = "Cannot stat " + path_ + ": " + std::strerror(errno);
+        return false;
+    }
+    inode_ = static_cast<uint64_t>(info.st_ino);
+    device_ = static_cast<uint64_t>(info.st_dev);
+    return true;
+}
+
+void FileFollower::setup_watch() {
+#ifdef __linux__
+    if (!options_.use_inotify) {
+        return;
+    }
+    watch_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch_fd_ < 0) {
+        return;
+    }
+
+    // Watch the directory: growth of the file and its replacement by a new one
+    size_t slash = path_.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path_.substr(0, slash));
+    watch_name_ = slash == std::string::npos ? path_ : path_.substr(slash + 1);
+
+    uint32_t mask = IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_ATTRIB;
+    if (inotify_add_watch(watch_fd_, directory.c_str(), mask) < 0) {
+        ::close(watch_fd_);
+        watch_fd_ = -1;
+    }
+#endif
+}
+
+void FileFollower::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    if (watch_fd_ >= 0) {
+        ::close(watch_fd_);
+        watch_fd_ = -1;
+    }
+}
+
+bool FileFollower::check_replaced() {
+    struct stat info;
+    if (fstat(fd_, &info) == 0 && static_cast<uint64_t>(info.st_size) < read_position_) {
+        stats_.truncations++;
+        reset_buffer(0);
+        return true;
+    }
+
+    // A missing path is a rotation in progress: keep the old file until the new one appears
+    if (stat(path_.c_str(), &info) == 0 &&
+        (static_cast<uint64_t>(info.st_ino) != inode_ || static_cast<uint64_t>(info.st_dev) != device_)) {
+        if (!reopen()) {
+            return false;
+        }
+        stats_.rotations++;
+        reset_buffer(0);
+        return true;
+    }
+    return false;
+}
+
+size_t FileFollower::read_available(const BlockHandler& handler) {
+    size_t handed = 0;
+    if (fd_ < 0 || !error_.empty()) {
+        return handed;
+    }
+
+    for (;;) {
+        while (end_ - begin_ >= 3) {
+            size_t length = core::load_be16(buffer_.data() + begin_ + 1);
+            if (length < 3) {
+                error_ = "Invalid block length at offset " + std::to_string(offset_);
+                return handed;
+            }
+            if (length > end_ - begin_) {
+                break;
+            }
+
+            stats_.blocks++;
+            stats_.bytes += length;
+            bool more = handler(buffer_.data() + begin_, length, offset_);
+            begin_ += length;
+            offset_ += length;
+            handed++;
+            if (!more) {
+                handler_stopped_ = true;
+                return handed;
+            }
+        }
+
+        // Keep the partial block at the front and fill the rest
+        if (begin_ > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+        }
+
+        ssize_t got = pread(fd_, buffer_.data() + end_, buffer_.size() - end_, static_cast<off_t>(read_position_));
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error_ = "Read failed on " + path_ + ": " + std::strerror(errno);
+            return handed;
+        }
+        if (got == 0) {
+            // At the end: go on only if the file was truncated or replaced
+            if (check_replaced()) {
+                continue;
+            }
+            return handed;
+        }
+        end_ += static_cast<size_t>(got);
+        read_position_ += static_cast<uint64_t>(got);
+    }
+}
+
+bool FileFollower::wait(int timeout_ms) {
+#ifdef __linux__
+    if (watch_fd_ >= 0) {
+        pollfd descriptor{watch_fd_, POLLIN, 0};
+        if (poll(&descriptor, 1, timeout_ms) <= 0) {
+            return false;
+        }
+
+        // Drain the queue; only events of the followed name count
+        alignas(inotify_event) char events[4096];
+        bool relevant = false;
+        ssize_t got;
+        while ((got = ::read(watch_fd_, events, sizeof(events))) > 0) {
+            for (char* cursor = events; cursor < events + got;) {
+                auto* event = reinterpret_cast<inotify_event*>(cursor);
+                if (event->len == 0 || watch_name_ == event->name || (event->mask & IN_Q_OVERFLOW)) {
+                    relevant = true;
+                }
+                cursor += sizeof(inotify_event) + event->len;
+            }
+        }
+        if (relevant) {
+            stats_.wakeups++;
+        }
+        return relevant;
+    }
+#endif
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+    return false;
+}
+
+#else
+
+bool FileFollower::open(const std::string& path, uint64_t) {
+    path_ = path;
+    error_ = "Following files is not supported on this platform";
+    return false;
+}
+
+bool FileFollower::reopen() { return false; }
+void FileFollower::setup_watch() {}
+void FileFollower::close() {}
+bool FileFollower::check_replaced() { return false; }
+size_t FileFollower::read_available(const BlockHandler&) { return 0; }
+
+bool FileFollower::wait(int timeout_ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+    return false;
+}
+
+#endif
+
+FollowStatus FileFollower::run(const BlockHandler& handler) {
+    auto last_block = std::chrono::steady_clock::now();
+
+    while (!stop_requested_.load()) {
+        if (read_available(handler) > 0) {
+            last_block = std::chrono::steady_clock::now();
+        }
+        if (!error_.empty()) {
+            return FollowStatus::FAILED;
+        }
+        if (handler_stopped_) {
+            return FollowStatus::STOPPED;
+        }
+
+        int timeout = options_.poll_interval_ms;
+        if (options_.idle_timeout_ms >= 0) {
+            auto idle = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - last_block).count();
+            if (idle >= options_.idle_timeout_ms) {
+                return FollowStatus::IDLE;
+            }
+            timeout = static_cast<int>(std::min<int64_t>(timeout, options_.idle_timeout_ms - idle));
+        }
+        wait(std::max(timeout, 1));
+    }
+    return FollowStatus::STOPPED;
+}
+
+} // namespace skydecoder
\ No newline at end of file
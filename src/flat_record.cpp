@@ -0,0 +1,305 @@
+#include "skydecoder/flat_record.h"
+#include "skydecoder/lazy_record.h"
+
+namespace skydecoder {
+
+namespace {
+
+constexpr size_t kAlignment = 8;
+
+size_t align_up(size_t value) {
+    return (value + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+// NUL-terminated string starting within the record
+bool valid_string(const uint8_t* record, size_t size, uint32_t offset) {
+    return offset < size && std::memchr(record + offset, 0, size - offset) != nullptr;
+}
+
+void flatten_fields(const std::vector<Field>& fields, std::vector<const Field*>& out) {
+    for (const auto& field : fields) {
+        if (field.name == "spare") {
+            continue;
+        }
+        out.push_back(&field);
+        flatten_fields(field.extension_fields, out);
+    }
+}
+
+} // namespace
+
+FieldValue FlatFieldView::value() const {
+    uint32_t offset = static_cast<uint32_t>(entry_.value);
+    uint32_t size = static_cast<uint32_t>(entry_.value >> 32);
+
+    switch (kind()) {
+        case FieldValue::Kind::UNSIGNED: return FieldValue::from_unsigned(entry_.value, entry_.width);
+        case FieldValue::Kind::SIGNED: return FieldValue::from_signed(static_cast<int64_t>(entry_.value), entry_.width);
+        case FieldValue::Kind::BOOL: return FieldValue::from_bool(entry_.value != 0);
+        case FieldValue::Kind::REAL: {
+            double real;
+            std::memcpy(&real, &entry_.value, sizeof(real));
+            return FieldValue::from_double(real);
+        }
+        case FieldValue::Kind::STRING:
+            return FieldValue::string_view(reinterpret_cast<const char*>(record_ + offset), size);
+        case FieldValue::Kind::BYTES: return FieldValue::bytes_view(record_ + offset, size);
+        case FieldValue::Kind::NONE: break;
+    }
+    return FieldValue();
+}
+
+bool FlatItemView::find_field(std::string_view name, FlatFieldView& out) const {
+    for (size_t i = 0; i < field_count(); ++i) {
+        FlatFieldView candidate = field(i);
+        if (candidate.name() == name) {
+            out = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FlatRecordView::find_item(std::string_view id, FlatItemView& out) const {
+    for (size_t i = 0; i < item_count(); ++i) {
+        FlatItemView candidate = item(i);
+        if (candidate.id() == id) {
+            out = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FlatRecordView::verify(const uint8_t* data, size_t size) {
+    if (size < sizeof(flat::RecordHeader)) {
+        return false;
+    }
+
+    auto header = flat::load<flat::RecordHeader>(data, 0);
+    if (header.magic != flat::kMagic || header.version != flat::kVersion ||
+        header.size < sizeof(flat::RecordHeader) || header.size > size || header.size % kAlignment != 0) {
+        return false;
+    }
+
+    size_t record_size = header.size;
+    size_t items_end = sizeof(flat::RecordHeader) + header.item_count * sizeof(flat::ItemEntry);
+    if (items_end > record_size) {
+        return false;
+    }
+    if (header.error != 0 && !valid_string(data, record_size, header.error)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < header.item_count; ++i) {
+        auto item = flat::load<flat::ItemEntry>(data, sizeof(flat::RecordHeader) + i * sizeof(flat::ItemEntry));
+        if (item.fields < items_end ||
+            item.fields + static_cast<size_t>(item.field_count) * sizeof(flat::FieldEntry) > record_size ||
+            !valid_string(data, record_size, item.id) || !valid_string(data, record_size, item.name)) {
+            return false;
+        }
+
+        for (size_t f = 0; f < item.field_count; ++f) {
+            auto field = flat::load<flat::FieldEntry>(data, item.fields + f * sizeof(flat::FieldEntry));
+            if (field.kind > static_cast<uint8_t>(FieldValue::Kind::BYTES) ||
+                !valid_string(data, record_size, field.name)) {
+                return false;
+            }
+            if (field.kind == static_cast<uint8_t>(FieldValue::Kind::STRING) ||
+                field.kind == static_cast<uint8_t>(FieldValue::Kind::BYTES)) {
+                uint64_t offset = static_cast<uint32_t>(field.value);
+                uint64_t length = field.value >> 32;
+                if (offset + length > record_size) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+void FlatRecordWriter::update_definitions(const AsterixCategory* category) {
+    if (category == category_) {
+        return;
+    }
+
+    category_ = category;
+    definitions_.clear();
+    if (!category) {
+        return;
+    }
+
+    const auto& uap = category->uap.items;
+    for (size_t i = 0; i < uap.size(); ++i) {
+        auto it = category->data_items.find(uap[i]);
+        if (it == category->data_items.end()) {
+            continue;
+        }
+        ItemDefinition definition;
+        definition.frn = static_cast<uint16_t>(i + 1);
+        definition.item = &it->second;
+        flatten_fields(it->second.fields, definition.fields);
+        definitions_.push_back(std::move(definition));
+    }
+}
+
+void FlatRecordWriter::append(const AsterixBlock& block) {
+    for (const auto& message : block.messages) {
+        append(message);
+    }
+}
+
+size_t FlatRecordWriter::append(const AsterixMessage& message) {
+    return append_record(message.definition.get(), message.category, message.length, message.valid,
+                         message.error_message, message.data_items.size(),
+                         [&](size_t index) -> const ParsedDataItem& { return message.data_items[index]; });
+}
+
+size_t FlatRecordWriter::append(LazyRecord& record) {
+    // Items are decoded into the record's own cache and written from there
+    return append_record(record.definition(), record.category(), static_cast<uint16_t>(record.length()),
+                         record.valid(), record.valid() ? std::string_view() : "Record is not indexed",
+                         record.valid() ? record.item_count() : 0,
+                         [&](size_t index) -> const ParsedDataItem& { return record.item_at(index); });
+}
+
+template <typename ItemAt>
+size_t FlatRecordWriter::append_record(const AsterixCategory* category, uint8_t category_number, uint16_t length,
+                                       bool valid, std::string_view error, size_t item_count, ItemAt&& item_at) {
+    update_definitions(category);
+
+    size_t field_total = 0;
+    for (size_t i = 0; i < item_count; ++i) {
+        field_total += item_at(i).fields.size();
+    }
+
+    const size_t start = buffer_.size();
+    const size_t items_offset = sizeof(flat::RecordHeader);
+    const size_t fields_offset = items_offset + item_count * sizeof(flat::ItemEntry);
+    const size_t strings_offset = fields_offset + field_total * sizeof(flat::FieldEntry);
+
+    buffer_.resize(start + strings_offset);
+    strings_.clear();
+
+    auto add_string = [&](const void* data, size_t size, bool terminate) {
+        uint32_t offset = static_cast<uint32_t>(strings_offset + strings_.size());
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        strings_.insert(strings_.end(), bytes, bytes + size);
+        if (terminate) {
+            strings_.push_back(0);
+        }
+        return offset;
+    };
+    auto add_text = [&](std::string_view text) { return add_string(text.data(), text.size(), true); };
+
+    size_t field_index = 0;
+    size_t item_cursor = 0;
+    for (size_t i = 0; i < item_count; ++i) {
+        const ParsedDataItem& item = item_at(i);
+
+        // Items come in UAP order: scan forward from the previous match
+        const ItemDefinition* definition = nullptr;
+        for (size_t n = 0; n < definitions_.size(); ++n) {
+            size_t index = item_cursor + n < definitions_.size() ? item_cursor + n : item_cursor + n - definitions_.size();
+            if (definitions_[index].item->id == item.id) {
+                definition = &definitions_[index];
+                item_cursor = index + 1;
+                break;
+            }
+        }
+
+        flat::ItemEntry item_entry;
+        item_entry.fields = static_cast<uint32_t>(fields_offset + field_index * sizeof(flat::FieldEntry));
+        item_entry.id = add_text(item.id);
+        item_entry.name = add_text(item.name);
+        item_entry.field_count = static_cast<uint16_t>(item.fields.size());
+        item_entry.frn = definition ? definition->frn : 0;
+        std::memcpy(buffer_.data() + start + items_offset + i * sizeof(flat::ItemEntry), &item_entry, sizeof(item_entry));
+
+        size_t field_cursor = 0;
+        for (const auto& field : item.fields) {
+            flat::FieldEntry entry;
+            entry.name = add_text(field.name);
+            entry.kind = static_cast<uint8_t>(field.value.kind());
+            entry.width = field.value.width();
+            entry.unit = static_cast<uint8_t>(field.unit);
+            entry.flags = field.valid ? 1 : 0;
+            entry.lsb = 1.0;
+
+            if (definition) {
+                size_t count = definition->fields.size();
+                for (size_t n = 0; n < count; ++n) {
+                    size_t index = field_cursor + n < count ? field_cursor + n : field_cursor + n - count;
+                    if (definition->fields[index]->name == field.name) {
+                        entry.lsb = definition->fields[index]->lsb;
+                        field_cursor = index + 1;
+                        break;
+                    }
+                }
+            }
+
+            switch (field.value.kind()) {
+                case FieldValue::Kind::SIGNED:
+                    entry.value = static_cast<uint64_t>(field.value.as_signed());
+                    break;
+                case FieldValue::Kind::REAL: {
+                    double real = field.value.as_double();
+                    std::memcpy(&entry.value, &real, sizeof(real));
+                    break;
+                }
+                case FieldValue::Kind::STRING:
+                case FieldValue::Kind::BYTES:
+                    entry.value = add_string(field.value.data(), field.value.size(), false) |
+                                  (static_cast<uint64_t>(field.value.size()) << 32);
+                    break;
+                default:
+                    entry.value = field.value.as_unsigned();
+                    break;
+            }
+
+            std::memcpy(buffer_.data() + start + fields_offset + field_index * sizeof(flat::FieldEntry),
+                        &entry, sizeof(entry));
+            ++field_index;
+        }
+    }
+
+    flat::RecordHeader header;
+    header.magic = flat::kMagic;
+    header.version = flat::kVersion;
+    header.category = category_number;
+    header.flags = valid ? 1 : 0;
+    header.length = length;
+    header.item_count = static_cast<uint16_t>(item_count);
+    header.error = valid ? 0 : add_text(error);
+    header.reserved = 0;
+
+    size_t size = align_up(strings_offset + strings_.size());
+    header.size = static_cast<uint32_t>(size);
+
+    buffer_.insert(buffer_.end(), strings_.begin(), strings_.end());
+    buffer_.resize(start + size, 0);
+    std::memcpy(buffer_.data() + start, &header, sizeof(header));
+
+    offsets_.push_back(start);
+    return start;
+}
+
+size_t FlatRecordWriter::append(const FlatRecordView& record) {
+    size_t start = buffer_.size();
+    buffer_.insert(buffer_.end(), record.data(), record.data() + record.size());
+    offsets_.push_back(start);
+    return start;
+}
+
+void FlatRecordWriter::reserve(size_t bytes, size_t records) {
+    buffer_.reserve(bytes);
+    offsets_.reserve(records);
+}
+
+void FlatRecordWriter::clear() {
+    buffer_.clear();
+    offsets_.clear();
+}
+
+} // namespace skydecoder
\ No newline at end of file
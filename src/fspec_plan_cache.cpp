@@ -0,0 +1,215 @@
+#include "skydecoder/fspec_plan_cache.h"
+#include "skydecoder/field_parser.h"
+#include <algorithm>
+#include <cstring>
+
+namespace skydecoder {
+
+FspecPlan build_fspec_plan(const uint8_t* fspec, size_t fspec_length, const AsterixCategory& category) {
+    FspecPlan plan;
+    plan.fspec_length = static_cast<uint8_t>(std::min(fspec_length, core::kMaxFspecLength));
+    std::memcpy(plan.fspec, fspec, plan.fspec_length);
+
+    plan.all_fixed = true;
+
+    core::for_each_fspec_item(fspec, plan.fspec_length, category.uap.items.size(), [&](size_t uap_index) {
+        const std::string& item_id = category.uap.items[uap_index];
+        if (item_id == "spare" || item_id.empty()) {
+            return; // Skip spare and empty fields
+        }
+
+        auto item_it = category.data_items.find(item_id);
+        if (item_it == category.data_items.end()) {
+            plan.unknown_items.push_back(item_id);
+            plan.all_fixed = false;
+            return;
+        }
+
+        const DataItem& item = item_it->second;
+        plan.items.push_back(&item);
+        plan.item_frns.push_back(static_cast<uint16_t>(uap_index + 1));
+
+        switch (item.format) {
+            case DataFormat::FIXED:
+                if (item.length.has_value()) {
+                    plan.item_offsets.push_back(static_cast<uint32_t>(plan.fixed_length));
+                    plan.fixed_length += item.length.value();
+                    plan.min_length += item.length.value();
+                } else {
+                    plan.all_fixed = false;
+                }
+                break;
+
+            case DataFormat::VARIABLE:
+                // For variable fields, estimate at least 1 byte
+                plan.min_length += 1;
+                plan.all_fixed = false;
+                break;
+
+            case DataFormat::EXPLICIT:
+            case DataFormat::REPETITIVE:
+                // First byte indicates length or repetitions, so at least 2 bytes
+                plan.min_length += 2;
+                plan.all_fixed = false;
+                break;
+        }
+    });
+
+    if (!plan.all_fixed) {
+        plan.fixed_length = 0;
+        plan.item_offsets.clear();
+    }
+
+    return plan;
+}
+
+const FspecPlan& lookup_fspec_plan(FspecPlanCache* cache, const uint8_t* fspec, size_t fspec_length,
+                                   const AsterixCategory& category, FspecPlan& scratch) {
+    if (cache) {
+        if (const FspecPlan* cached = cache->find(fspec, fspec_length)) {
+            return *cached;
+        }
+    }
+    
+    scratch = build_fspec_plan(fspec, fspec_length, category);
+    
+    if (cache) {
+        if (const FspecPlan* stored = cache->insert(scratch)) {
+            return *stored;
+        }
+    }
+    return scratch;
+}
+
+size_t measure_record(const FspecPlan& plan, const uint8_t* data, size_t size) {
+    size_t position = plan.fspec_length;
+    if (position > size) {
+        return 0;
+    }
+    
+    if (plan.all_fixed) {
+        return size - position >= plan.fixed_length ? position + plan.fixed_length : 0;
+    }
+    
+    // Undefined items take no bytes, as in the decoder
+    for (const DataItem* item : plan.items) {
+        size_t item_size = FieldParser::measure_data_item(*item, data + position, size - position);
+        if (item_size == 0) {
+            return 0;
+        }
+        position += item_size;
+    }
+    
+    return position;
+}
+
+FspecPlanCache::FspecPlanCache(size_t max_entries)
+    : slots_(16), max_entries_(max_entries) {}
+
+uint64_t FspecPlanCache::hash(const uint8_t* fspec, size_t fspec_length) {
+    // FNV-1a
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < fspec_length; ++i) {
+        h = (h ^ fspec[i]) * 1099511628211ull;
+    }
+    return h;
+}
+
+FspecPlan* FspecPlanCache::find(const uint8_t* fspec, size_t fspec_length) {
+    uint64_t h = hash(fspec, fspec_length);
+    size_t mask = slots_.size() - 1;
+
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+        const Slot& slot = slots_[i];
+        if (slot.index < 0) {
+            misses_++;
+            return nullptr;
+        }
+
+        FspecPlan& plan = *plans_[slot.index];
+        if (slot.hash == h && plan.fspec_length == fspec_length &&
+            std::memcmp(plan.fspec, fspec, fspec_length) == 0) {
+            hits_++;
+            return &plan;
+        }
+    }
+}
+
+FspecPlan* FspecPlanCache::insert(const FspecPlan& plan) {
+    if (plans_.size() >= max_entries_) {
+        return nullptr;
+    }
+
+    if ((plans_.size() + 1) * 2 > slots_.size()) {
+        grow();
+    }
+
+    uint64_t h = hash(plan.fspec, plan.fspec_length);
+    size_t mask = slots_.size() - 1;
+    size_t i = h & mask;
+
+    while (slots_[i].index >= 0) {
+        FspecPlan& existing = *plans_[slots_[i].index];
+        if (slots_[i].hash == h && existing.fspec_length == plan.fspec_length &&
+            std::memcmp(existing.fspec, plan.fspec, plan.fspec_length) == 0) {
+            return &existing;
+        }
+        i = (i + 1) & mask;
+    }
+
+    plans_.push_back(std::make_unique<FspecPlan>(plan));
+    slots_[i].hash = h;
+    slots_[i].index = static_cast<int32_t>(plans_.size() - 1);
+
+    return plans_.back().get();
+}
+
+void FspecPlanCache::grow() {
+    std::vector<Slot> slots(slots_.size() * 2);
+    size_t mask = slots.size() - 1;
+
+    for (const Slot& slot : slots_) {
+        if (slot.index < 0) {
+            continue;
+        }
+        size_t i = slot.hash & mask;
+        while (slots[i].index >= 0) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = slot;
+    }
+
+    slots_.swap(slots);
+}
+
+void FspecPlanCache::reset_specializations() {
+    for (auto& plan : plans_) {
+        plan->uses = 0;
+        plan->specialization_attempted = false;
+        plan->specialized.reset();
+        plan->specialized_records = 0;
+    }
+}
+
+void FspecPlanCache::clear() {
+    slots_.assign(16, Slot{});
+    plans_.clear();
+    hits_ = 0;
+    misses_ = 0;
+}
+
+PlanCacheStats FspecPlanCache::stats() const {
+    PlanCacheStats result;
+    result.hits = hits_;
+    result.misses = misses_;
+    result.entries = plans_.size();
+    for (const auto& plan : plans_) {
+        if (plan->specialized) {
+            result.specialized_plans++;
+        }
+        result.specialized_records += plan->specialized_records;
+    }
+    return result;
+}
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+// Internal kernel dispatch table. This header is included by the ISA specific
+// translation units, so it must not pull in anything with inline code that
+// could be instantiated with wider instructions than the CPU supports.
+#include <cstddef>
+#include <cstdint>
+
+namespace skydecoder {
+namespace kernels {
+
+struct KernelTable {
+    // Length of the FSPEC starting at data (last byte has FX=0), 0 if not terminated within size
+    size_t (*fspec_length)(const uint8_t* data, size_t size);
+    
+    // Lowercase hexadecimal encoding, writes 2*size characters to out
+    void (*hex_encode)(const uint8_t* data, size_t size, char* out);
+    
+    // Split data into consecutive 6-bit codes (MSB first), returns the number of codes written
+    size_t (*unpack_6bit)(const uint8_t* data, size_t size, uint8_t* codes);
+};
+
+// Table of the active variant
+const KernelTable& active();
+
+// Per-ISA tables, defined in kernels_<isa>.cpp
+const KernelTable& scalar_table();
+const KernelTable& sse42_table();
+const KernelTable& avx2_table();
+const KernelTable& avx512_table();
+
+} // namespace kernels
+} // namespace skydecoder
\ No newline at end of file
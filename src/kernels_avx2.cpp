@@ -0,0 +1,6 @@
+// Built with -mavx2 -mbmi2 when SKYDECODER_ISA_VARIANTS is enabled
+#include "kernels.h"
+
+#define SKYDECODER_KERNEL_NS avx2
+#define SKYDECODER_KERNEL_TABLE avx2_table
+#include "kernels_impl.inc"
\ No newline at end of file
@@ -0,0 +1,6 @@
+// Built with -mavx512f -mavx512bw -mavx2 -mbmi2 when SKYDECODER_ISA_VARIANTS is enabled
+#include "kernels.h"
+
+#define SKYDECODER_KERNEL_NS avx512
+#define SKYDECODER_KERNEL_TABLE avx512_table
+#include "kernels_impl.inc"
\ No newline at end of file
@@ -0,0 +1,5 @@
+#include "kernels.h"
+
+#define SKYDECODER_KERNEL_NS scalar
+#define SKYDECODER_KERNEL_TABLE scalar_table
+#include "kernels_impl.inc"
\ No newline at end of file
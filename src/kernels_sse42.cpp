@@ -0,0 +1,6 @@
+// Built with -msse4.2 when SKYDECODER_ISA_VARIANTS is enabled
+#include "kernels.h"
+
+#define SKYDECODER_KERNEL_NS sse42
+#define SKYDECODER_KERNEL_TABLE sse42_table
+#include "kernels_impl.inc"
\ No newline at end of file
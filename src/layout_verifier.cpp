@@ -0,0 +1,249 @@
+#include "skydecoder/layout_verifier.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace skydecoder {
+
+namespace {
+
+// Widest value a field type holds, 0 for STRING and BYTES
+unsigned type_width(FieldType type) {
+    switch (type) {
+        case FieldType::UINT1: return 1;
+        case FieldType::UINT2: return 2;
+        case FieldType::UINT3: return 3;
+        case FieldType::UINT4: return 4;
+        case FieldType::UINT5: return 5;
+        case FieldType::UINT6: return 6;
+        case FieldType::UINT7: return 7;
+        case FieldType::UINT8:
+        case FieldType::INT8: return 8;
+        case FieldType::UINT12: return 12;
+        case FieldType::UINT14: return 14;
+        case FieldType::UINT16:
+        case FieldType::INT16: return 16;
+        case FieldType::UINT24:
+        case FieldType::INT24: return 24;
+        case FieldType::UINT32:
+        case FieldType::INT32:
+        case FieldType::BOOL: return 32;
+        case FieldType::STRING:
+        case FieldType::BYTES: return 0;
+    }
+    return 0;
+}
+
+bool is_signed(FieldType type) {
+    return type == FieldType::INT8 || type == FieldType::INT16 ||
+           type == FieldType::INT24 || type == FieldType::INT32;
+}
+
+size_t total_bits(const std::vector<Field>& fields) {
+    size_t bits = 0;
+    for (const auto& field : fields) {
+        bits += field.bits;
+    }
+    return bits;
+}
+
+// Spare padding, split so that each piece fits Field::bits
+void insert_spares(std::vector<Field>& fields, size_t position, size_t bits) {
+    while (bits > 0) {
+        Field spare;
+        spare.name = "spare";
+        spare.type = FieldType::BYTES;
+        spare.bits = static_cast<uint8_t>(std::min<size_t>(bits, 128));
+        spare.description = "Padding added by layout verification";
+        bits -= spare.bits;
+        fields.insert(fields.begin() + position++, std::move(spare));
+    }
+}
+
+class LayoutVerifier {
+public:
+    LayoutVerifier(LayoutPolicy policy, std::vector<LayoutIssue>& issues)
+        : repair_(policy == LayoutPolicy::REPAIR), issues_(issues) {}
+    
+    // Returns true if the item is left without unrepaired issues
+    bool verify_item(DataItem& item) {
+        item_ok_ = true;
+        verify_fields(item, item.fields, true);
+        
+        switch (item.format) {
+            case DataFormat::FIXED:
+                verify_fixed(item);
+                break;
+            case DataFormat::VARIABLE:
+                verify_octets(item, item.fields);
+                break;
+            case DataFormat::EXPLICIT:
+                verify_explicit(item);
+                break;
+            case DataFormat::REPETITIVE:
+                if (!item.length.has_value()) {
+                    report(item, "", "Repetitive format requires length specification", false);
+                }
+                break;
+        }
+        
+        return item_ok_;
+    }
+    
+private:
+    void report(const DataItem& item, const std::string& field, const std::string& message, bool repaired) {
+        issues_.push_back(LayoutIssue{item.id, field, message, repaired});
+        if (!repaired) {
+            item_ok_ = false;
+        }
+    }
+    
+    void verify_fields(DataItem& item, std::vector<Field>& fields, bool top_level) {
+        for (size_t i = 0; i < fields.size(); ++i) {
+            Field& field = fields[i];
+            unsigned width = type_width(field.type);
+            
+            if (field.type == FieldType::BYTES) {
+                // A BYTES field without bits is the tail of an explicit item
+                bool tail = top_level && item.format == DataFormat::EXPLICIT && i + 1 == fields.size();
+                if (field.bits == 0 && !tail) {
+                    report(item, field.name, "BYTES field without bits", false);
+                }
+            } else if (field.bits == 0) {
+                unsigned implied = field.type == FieldType::BOOL ? 1 : width;
+                if (repair_ && implied > 0) {
+                    field.bits = static_cast<uint8_t>(implied);
+                    report(item, field.name, "Missing bits, taken from the type", true);
+                } else {
+                    report(item, field.name, "Missing bits", false);
+                }
+            } else if (field.bits > 32 && field.type != FieldType::STRING) {
+                report(item, field.name, "Field wider than 32 bits", false);
+            } else if (width > 0 && field.bits > width) {
+                if (repair_) {
+                    field.type = is_signed(field.type) ? FieldType::INT32 : FieldType::UINT32;
+                    report(item, field.name, "Type narrower than " + std::to_string(field.bits) +
+                           " bits, widened to 32 bits", true);
+                } else {
+                    report(item, field.name, "Type narrower than " + std::to_string(field.bits) + " bits", false);
+                }
+            }
+            
+            if (!field.extension_fields.empty()) {
+                verify_fields(item, field.extension_fields, false);
+                if (item.format == DataFormat::VARIABLE) {
+                    verify_octets(item, field.extension_fields);
+                }
+            }
+        }
+    }
+    
+    void verify_fixed(DataItem& item) {
+        if (!item.length.has_value()) {
+            report(item, "", "Fixed format requires length specification", false);
+            return;
+        }
+        
+        size_t expected = static_cast<size_t>(item.length.value()) * 8;
+        size_t bits = total_bits(item.fields);
+        
+        if (bits < expected) {
+            std::string message = "Fields cover " + std::to_string(bits) + " of " +
+                                  std::to_string(expected) + " bits";
+            if (repair_) {
+                insert_spares(item.fields, item.fields.size(), expected - bits);
+                report(item, "", message + ", padded with spare bits", true);
+            } else {
+                report(item, "", message, false);
+            }
+        } else if (bits > expected) {
+            report(item, "", "Fields take " + std::to_string(bits) + " bits, more than the " +
+                   std::to_string(expected) + " bits of the item", false);
+        }
+    }
+    
+    // Each octet of a variable item ends with its FX bit
+    void verify_octets(DataItem& item, std::vector<Field>& fields) {
+        size_t bits = total_bits(fields);
+        if (fields.empty() || bits % 8 == 0) {
+            return;
+        }
+        
+        std::string last_name = fields.back().name;
+        bool ends_with_fx = fields.back().bits == 1 && last_name.rfind("FX", 0) == 0;
+        
+        if (repair_ && ends_with_fx) {
+            insert_spares(fields, fields.size() - 1, 8 - bits % 8);
+            report(item, last_name, "FX not in bit 1 of the octet, spare bits inserted before it", true);
+        } else {
+            report(item, "", "Fields take " + std::to_string(bits) + " bits, not whole octets", false);
+        }
+    }
+    
+    // The length octet comes first
+    void verify_explicit(DataItem& item) {
+        if (item.fields.empty()) {
+            return;
+        }
+        
+        std::string first_name = item.fields.front().name;
+        if (item.fields.front().type == FieldType::BYTES && item.fields.front().bits == 0) {
+            if (repair_) {
+                insert_spares(item.fields, 0, 8);
+                report(item, first_name, "Length octet missing from the layout, spare octet inserted", true);
+            } else {
+                report(item, first_name, "Length octet missing from the layout", false);
+            }
+        }
+    }
+    
+    bool repair_;
+    std::vector<LayoutIssue>& issues_;
+    bool item_ok_ = true;
+};
+
+} // namespace
+
+bool verify_category_layout(AsterixCategory& category, LayoutPolicy policy, std::vector<LayoutIssue>& issues) {
+    if (policy == LayoutPolicy::OFF) {
+        return true;
+    }
+    
+    LayoutVerifier verifier(policy, issues);
+    size_t first_issue = issues.size();
+    bool all_ok = true;
+    
+    for (auto& pair : category.data_items) {
+        DataItem& item = pair.second;
+        bool ok = verifier.verify_item(item);
+        
+        // FIXED items bound their top-level fields, VARIABLE ones only if all of them
+        // sit in the first octet: a record may stop the FX chain right there
+        item.verified = ok && (item.format == DataFormat::FIXED ||
+                               (item.format == DataFormat::VARIABLE && total_bits(item.fields) <= 8));
+        all_ok = all_ok && ok;
+    }
+    
+    if (policy == LayoutPolicy::STRICT) {
+        return issues.size() == first_issue;
+    }
+    return all_ok;
+}
+
+std::string to_string(LayoutPolicy policy) {
+    switch (policy) {
+        case LayoutPolicy::OFF: return "off";
+        case LayoutPolicy::REPAIR: return "repair";
+        case LayoutPolicy::STRICT: return "strict";
+    }
+    return "unknown";
+}
+
+LayoutPolicy layout_policy_from_string(const std::string& policy) {
+    if (policy == "off") return LayoutPolicy::OFF;
+    if (policy == "repair") return LayoutPolicy::REPAIR;
+    if (policy == "strict") return LayoutPolicy::STRICT;
+    
+    throw std::runtime_error("Unknown layout policy: " + policy);
+}
+
+} // namespace skydecoder
\ No newline at end of file
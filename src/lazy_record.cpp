@@ -0,0 +1,114 @@
+#include "skydecoder/lazy_record.h"
+#include "skydecoder/field_parser.h"
+#include <algorithm>
+
+namespace skydecoder {
+
+bool LazyRecord::index(const uint8_t* data, size_t size, std::shared_ptr<const AsterixCategory> category,
+                       FspecPlanCache* plan_cache) {
+    data_ = data;
+    length_ = 0;
+    valid_ = false;
+    category_ = std::move(category);
+    items_.clear();
+    arena_.reset();
+    
+    if (!category_) {
+        return false;
+    }
+    
+    size_t fspec_length = core::fx_chain_length(data, std::min(size, core::kMaxFspecLength));
+    if (fspec_length == 0) {
+        return false;
+    }
+    
+    FspecPlan scratch;
+    const FspecPlan& plan = lookup_fspec_plan(plan_cache, data, fspec_length, *category_, scratch);
+    
+    // Undefined items take no bytes, as in the decoder
+    size_t position = fspec_length;
+    items_.reserve(plan.items.size());
+    
+    if (plan.all_fixed) {
+        if (size - position < plan.fixed_length) {
+            return false;
+        }
+        for (size_t i = 0; i < plan.items.size(); ++i) {
+            items_.push_back(Entry{plan.items[i], static_cast<uint32_t>(position + plan.item_offsets[i]),
+                                   plan.items[i]->length.value_or(0), plan.item_frns[i], nullptr});
+        }
+        position += plan.fixed_length;
+    } else {
+        for (size_t i = 0; i < plan.items.size(); ++i) {
+            const DataItem* item = plan.items[i];
+            size_t item_size = FieldParser::measure_data_item(*item, data + position, size - position);
+            if (item_size == 0) {
+                items_.clear();
+                return false;
+            }
+            items_.push_back(Entry{item, static_cast<uint32_t>(position), static_cast<uint32_t>(item_size),
+                                   plan.item_frns[i], nullptr});
+            position += item_size;
+        }
+    }
+    
+    length_ = position;
+    valid_ = true;
+    return true;
+}
+
+int LazyRecord::find(const std::string& id) const {
+    for (size_t i = 0; i < items_.size(); ++i) {
+        if (items_[i].definition->id == id) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+const ParsedDataItem* LazyRecord::item(const std::string& id) {
+    int index = find(id);
+    return index >= 0 ? &item_at(static_cast<size_t>(index)) : nullptr;
+}
+
+const ParsedDataItem& LazyRecord::item_at(size_t index) {
+    Entry& entry = items_[index];
+    
+    if (!entry.decoded) {
+        ParseContext context(data_ + entry.offset, entry.size, category_.get());
+        context.arena = arena_;
+        entry.decoded = std::make_unique<ParsedDataItem>(FieldParser::parse_data_item(*entry.definition, context));
+        entry.decoded->frn = entry.frn;
+        arena_ = context.arena;
+    }
+    
+    return *entry.decoded;
+}
+
+AsterixMessage LazyRecord::materialize() {
+    AsterixMessage message;
+    message.category = category();
+    message.length = static_cast<uint16_t>(length_);
+    message.valid = valid_;
+    
+    if (!valid_) {
+        message.error_message = "Record is not indexed";
+        return message;
+    }
+    
+    message.data_items.reserve(items_.size());
+    for (size_t i = 0; i < items_.size(); ++i) {
+        message.data_items.push_back(item_at(i));
+    }
+    
+    message.definition = category_;
+    message.arena = arena_;
+    return message;
+}
+
+size_t LazyRecord::decoded_item_count() const {
+    return std::count_if(items_.begin(), items_.end(),
+                         [](const Entry& entry) { return entry.decoded != nullptr; });
+}
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,291 @@
+#include "skydecoder/numa_buffer.h"
+#include <algorithm>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace skydecoder {
+
+namespace {
+
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+size_t round_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+#ifdef __linux__
+
+// mbind() policy from <linux/mempolicy.h>; avoids a libnuma dependency
+constexpr int kMpolPreferred = 1;
+
+void bind_to_node(void* addr, size_t length, int node) {
+    if (node < 0 || node >= 64) {
+        return;
+    }
+    unsigned long nodemask = 1UL << node;
+    // Best effort: an unknown node or a kernel without NUMA leaves first-touch placement
+    syscall(SYS_mbind, addr, length, kMpolPreferred, &nodemask, sizeof(nodemask) * 8, 0);
+}
+
+void* map_anonymous(size_t length, int extra_flags) {
+    void* ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+// Map a 2 MiB aligned region so that transparent huge pages can back it entirely
+void* map_aligned_for_thp(size_t length) {
+    size_t padded = length + kHugePageSize;
+    auto* raw = static_cast<uint8_t*>(map_anonymous(padded, 0));
+    if (!raw) {
+        return nullptr;
+    }
+
+    auto address = reinterpret_cast<uintptr_t>(raw);
+    auto aligned = reinterpret_cast<uint8_t*>(round_up(address, kHugePageSize));
+    size_t head = aligned - raw;
+    size_t tail = padded - head - length;
+
+    if (head > 0) munmap(raw, head);
+    if (tail > 0) munmap(aligned + length, tail);
+
+    madvise(aligned, length, MADV_HUGEPAGE);
+    return aligned;
+}
+
+#endif
+
+} // namespace
+
+NumaBuffer::NumaBuffer(size_t size, const MemoryOptions& options) : size_(size) {
+    if (size == 0) {
+        return;
+    }
+
+#ifdef __linux__
+    void* ptr = nullptr;
+
+    if (options.huge_pages == HugePageMode::EXPLICIT) {
+        mapped_size_ = round_up(size, kHugePageSize);
+        ptr = map_anonymous(mapped_size_, MAP_HUGETLB);
+        huge_ = ptr != nullptr;
+    }
+
+    if (!ptr && options.huge_pages != HugePageMode::NONE) {
+        mapped_size_ = round_up(size, kHugePageSize);
+        ptr = map_aligned_for_thp(mapped_size_);
+        huge_ = ptr != nullptr;
+    }
+
+    if (!ptr) {
+        mapped_size_ = round_up(size, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+        ptr = map_anonymous(mapped_size_, 0);
+    }
+
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+
+    bind_to_node(ptr, mapped_size_, options.numa_node);
+    data_ = static_cast<uint8_t*>(ptr);
+#else
+    (void)options;
+    mapped_size_ = size;
+    data_ = static_cast<uint8_t*>(::operator new(size));
+#endif
+}
+
+NumaBuffer::~NumaBuffer() {
+    release();
+}
+
+NumaBuffer::NumaBuffer(NumaBuffer&& other) noexcept
+    : data_(other.data_), size_(other.size_), mapped_size_(other.mapped_size_), huge_(other.huge_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.mapped_size_ = 0;
+    other.huge_ = false;
+}
+
+NumaBuffer& NumaBuffer::operator=(NumaBuffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = other.data_;
+        size_ = other.size_;
+        mapped_size_ = other.mapped_size_;
+        huge_ = other.huge_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.mapped_size_ = 0;
+        other.huge_ = false;
+    }
+    return *this;
+}
+
+void NumaBuffer::release() {
+    if (!data_) {
+        return;
+    }
+#ifdef __linux__
+    munmap(data_, mapped_size_);
+#else
+    ::operator delete(data_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_size_ = 0;
+}
+
+namespace numa {
+
+namespace {
+
+// Parse a sysfs CPU list such as "0-3,8-11"
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) continue;
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+
+    return cpus;
+}
+
+} // namespace
+
+int node_count() {
+#ifdef __linux__
+    std::ifstream file("/sys/devices/system/node/online");
+    std::string list;
+    if (file && std::getline(file, list)) {
+        auto nodes = parse_cpu_list(list);
+        if (!nodes.empty()) {
+            return *std::max_element(nodes.begin(), nodes.end()) + 1;
+        }
+    }
+#endif
+    return 1;
+}
+
+int current_node() {
+#ifdef __linux__
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return static_cast<int>(node);
+    }
+#endif
+    return 0;
+}
+
+std::vector<int> node_cpus(int node) {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    if (!file || !std::getline(file, list)) {
+        return {};
+    }
+    return parse_cpu_list(list);
+}
+
+bool pin_current_thread_to_node(int node) {
+#ifdef __linux__
+    auto cpus = node_cpus(node);
+    if (cpus.empty()) {
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+bool pin_current_thread_to_cpu(int cpu) {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+AccessStats read_access_stats(int node) {
+    AccessStats stats;
+
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/numastat");
+    if (!file) {
+        return stats;
+    }
+
+    std::string key;
+    uint64_t value = 0;
+    while (file >> key >> value) {
+        if (key == "numa_hit") stats.numa_hit = value;
+        else if (key == "numa_miss") stats.numa_miss = value;
+        else if (key == "local_node") stats.local_node = value;
+        else if (key == "other_node") stats.other_node = value;
+    }
+
+    stats.available = true;
+    return stats;
+}
+
+AccessStats delta(const AccessStats& before, const AccessStats& after) {
+    AccessStats result;
+    result.available = before.available && after.available;
+    result.numa_hit = after.numa_hit - before.numa_hit;
+    result.numa_miss = after.numa_miss - before.numa_miss;
+    result.local_node = after.local_node - before.local_node;
+    result.other_node = after.other_node - before.other_node;
+    return result;
+}
+
+std::string to_string(HugePageMode mode) {
+    switch (mode) {
+        case HugePageMode::TRANSPARENT: return "transparent";
+        case HugePageMode::EXPLICIT: return "explicit";
+        default: return "none";
+    }
+}
+
+HugePageMode huge_page_mode_from_string(const std::string& mode) {
+    if (mode == "none") return HugePageMode::NONE;
+    if (mode == "transparent" || mode == "thp") return HugePageMode::TRANSPARENT;
+    if (mode == "explicit" || mode == "hugetlb") return HugePageMode::EXPLICIT;
+
+    throw std::runtime_error("Unknown huge page mode: " + mode);
+}
+
+} // namespace numa
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,630 @@
+#include "skydecoder/parquet_writer.h"
+#include <algorithm>
+#include <cstdio>
+#include <unordered_map>
+
+namespace skydecoder {
+
+namespace {
+
+// parquet.thrift enumerations
+namespace type {
+constexpr int32_t BOOLEAN = 0;
+constexpr int32_t INT32 = 1;
+constexpr int32_t INT64 = 2;
+constexpr int32_t BYTE_ARRAY = 6;
+}
+
+namespace converted {
+constexpr int32_t NONE = -1;
+constexpr int32_t UTF8 = 0;
+constexpr int32_t UINT_8 = 11;
+constexpr int32_t UINT_16 = 12;
+constexpr int32_t UINT_32 = 13;
+constexpr int32_t INT_8 = 15;
+constexpr int32_t INT_16 = 16;
+}
+
+namespace encoding {
+constexpr int32_t PLAIN = 0;
+constexpr int32_t RLE = 3;
+constexpr int32_t RLE_DICTIONARY = 8;
+}
+
+constexpr int32_t kOptional = 1;
+constexpr int32_t kUncompressed = 0;
+constexpr int32_t kDataPage = 0;
+constexpr int32_t kDictionaryPage = 2;
+
+const char kMagic[4] = {'P', 'A', 'R', '1'};
+
+// Thrift compact protocol, just what the Parquet footer and page headers need
+class CompactWriter {
+public:
+    explicit CompactWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    void field_i32(int16_t id, int32_t value) {
+        field_header(id, kI32);
+        varint(zigzag(value));
+    }
+
+    void field_i64(int16_t id, int64_t value) {
+        field_header(id, kI64);
+        varint(zigzag(value));
+    }
+
+    void field_binary(int16_t id, const void* data, size_t size) {
+        field_header(id, kBinary);
+        binary(data, size);
+    }
+
+    void field_string(int16_t id, const std::string& value) {
+        field_binary(id, value.data(), value.size());
+    }
+
+    void begin_struct_field(int16_t id) {
+        field_header(id, kStruct);
+        begin_struct();
+    }
+
+    void begin_list_field(int16_t id, uint8_t element_type, size_t size) {
+        field_header(id, kList);
+        if (size < 15) {
+            out_.push_back(static_cast<uint8_t>((size << 4) | element_type));
+        } else {
+            out_.push_back(static_cast<uint8_t>(0xF0 | element_type));
+            varint(size);
+        }
+    }
+
+    // List elements
+    void element_i32(int32_t value) { varint(zigzag(value)); }
+    void element_string(const std::string& value) { binary(value.data(), value.size()); }
+
+    // Structs: top level, list element or field (after begin_struct_field)
+    void begin_struct() {
+        stack_.push_back(last_id_);
+        last_id_ = 0;
+    }
+
+    void end_struct() {
+        out_.push_back(0);
+        last_id_ = stack_.back();
+        stack_.pop_back();
+    }
+
+    static constexpr uint8_t kI32 = 5;
+    static constexpr uint8_t kI64 = 6;
+    static constexpr uint8_t kBinary = 8;
+    static constexpr uint8_t kList = 9;
+    static constexpr uint8_t kStruct = 12;
+
+private:
+    static uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            out_.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out_.push_back(static_cast<uint8_t>(value));
+    }
+
+    void binary(const void* data, size_t size) {
+        varint(size);
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        out_.insert(out_.end(), bytes, bytes + size);
+    }
+
+    void field_header(int16_t id, uint8_t field_type) {
+        int delta = id - last_id_;
+        if (delta > 0 && delta <= 15) {
+            out_.push_back(static_cast<uint8_t>((delta << 4) | field_type));
+        } else {
+            out_.push_back(field_type);
+            varint(zigzag(id));
+        }
+        last_id_ = id;
+    }
+
+    std::vector<uint8_t>& out_;
+    std::vector<int16_t> stack_;
+    int16_t last_id_ = 0;
+};
+
+void put_le(std::vector<uint8_t>& out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void put_uleb128(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+unsigned bit_width(uint64_t max_value) {
+    unsigned width = 0;
+    while (max_value >> width) {
+        ++width;
+    }
+    return width;
+}
+
+// RLE / bit-packed hybrid: runs of 8 or more equal values become RLE runs,
+// the rest is bit-packed in groups of 8 (padded with zeros at the end only)
+void encode_hybrid(const uint32_t* values, size_t count, unsigned width, std::vector<uint8_t>& out) {
+    size_t value_bytes = (width + 7) / 8;
+
+    auto run_length = [&](size_t i) {
+        size_t j = i + 1;
+        while (j < count && values[j] == values[i]) {
+            ++j;
+        }
+        return j - i;
+    };
+
+    size_t i = 0;
+    while (i < count) {
+        size_t run = run_length(i);
+        if (run >= 8) {
+            put_uleb128(out, static_cast<uint64_t>(run) << 1);
+            put_le(out, values[i], value_bytes);
+            i += run;
+            continue;
+        }
+
+        size_t start = i;
+        size_t groups = 0;
+        do {
+            i += 8;
+            ++groups;
+        } while (i < count && groups < 63 && run_length(i) < 8);
+
+        put_uleb128(out, (static_cast<uint64_t>(groups) << 1) | 1);
+        uint64_t accumulator = 0;
+        unsigned bits = 0;
+        for (size_t k = start; k < start + groups * 8; ++k) {
+            uint64_t value = k < count ? values[k] : 0;
+            accumulator |= value << bits;
+            bits += width;
+            while (bits >= 8) {
+                out.push_back(static_cast<uint8_t>(accumulator));
+                accumulator >>= 8;
+                bits -= 8;
+            }
+        }
+        if (bits > 0) {
+            out.push_back(static_cast<uint8_t>(accumulator));
+        }
+    }
+}
+
+void plain_value(std::vector<uint8_t>& out, int32_t physical_type, int64_t value) {
+    switch (physical_type) {
+        case type::INT32: put_le(out, static_cast<uint32_t>(value), 4); break;
+        case type::INT64: put_le(out, static_cast<uint64_t>(value), 8); break;
+        case type::BOOLEAN: out.push_back(value ? 1 : 0); break;
+        default: break;
+    }
+}
+
+void column_type(const Field& field, int32_t& physical_type, int32_t& converted_type) {
+    physical_type = type::INT32;
+    converted_type = converted::NONE;
+
+    switch (field.type) {
+        case FieldType::UINT1:
+        case FieldType::UINT2:
+        case FieldType::UINT3:
+        case FieldType::UINT4:
+        case FieldType::UINT5:
+        case FieldType::UINT6:
+        case FieldType::UINT7:
+        case FieldType::UINT8: converted_type = converted::UINT_8; break;
+        case FieldType::UINT12:
+        case FieldType::UINT14:
+        case FieldType::UINT16: converted_type = converted::UINT_16; break;
+        case FieldType::UINT24: converted_type = converted::UINT_32; break;
+        case FieldType::UINT32: physical_type = type::INT64; break;
+        case FieldType::INT8: converted_type = converted::INT_8; break;
+        case FieldType::INT16: converted_type = converted::INT_16; break;
+        case FieldType::INT24:
+        case FieldType::INT32: break;
+        case FieldType::BOOL: physical_type = type::BOOLEAN; break;
+        case FieldType::STRING:
+            physical_type = type::BYTE_ARRAY;
+            converted_type = converted::UTF8;
+            break;
+        case FieldType::BYTES: physical_type = type::BYTE_ARRAY; break;
+    }
+}
+
+void add_field_columns(const std::string& item_id, const std::vector<Field>& fields,
+                       std::vector<ParquetColumn>& columns, std::vector<size_t>& item_columns) {
+    for (const auto& field : fields) {
+        if (field.name == "spare") {
+            continue;
+        }
+
+        ParquetColumn column;
+        column.name = item_id + "_" + field.name;
+        std::replace(column.name.begin(), column.name.end(), '/', '_');
+        column.item_id = item_id;
+        column.field = field.name;
+        column_type(field, column.physical_type, column.converted_type);
+        column.dictionary = !field.enums.empty() && column.physical_type != type::BYTE_ARRAY &&
+                            column.physical_type != type::BOOLEAN;
+
+        // Names repeat in some items (FX); keep the first
+        bool duplicate = std::any_of(item_columns.begin(), item_columns.end(),
+                                     [&](size_t index) { return columns[index].name == column.name; });
+        if (!duplicate) {
+            item_columns.push_back(columns.size());
+            columns.push_back(std::move(column));
+        }
+
+        add_field_columns(item_id, field.extension_fields, columns, item_columns);
+    }
+}
+
+} // namespace
+
+ParquetWriter::ParquetWriter(std::shared_ptr<const AsterixCategory> category, ParquetOptions options)
+    : category_(std::move(category)), options_(options) {
+    build_columns();
+}
+
+ParquetWriter::~ParquetWriter() {
+    if (file_.is_open()) {
+        close();
+    }
+}
+
+void ParquetWriter::build_columns() {
+    // Columns in UAP order
+    for (const auto& item_id : category_->uap.items) {
+        auto it = category_->data_items.find(item_id);
+        if (it == category_->data_items.end()) {
+            continue;
+        }
+
+        ItemColumns item;
+        item.item_id = item_id;
+        add_field_columns(item_id, it->second.fields, columns_, item.columns);
+        if (!item.columns.empty()) {
+            items_.push_back(std::move(item));
+        }
+    }
+
+    buffers_.resize(columns_.size());
+}
+
+bool ParquetWriter::open(const std::string& path) {
+    if (!file_.open(path)) {
+        return false;
+    }
+
+    offset_ = 0;
+    failed_ = false;
+    row_groups_.clear();
+    total_rows_ = 0;
+    write_bytes(std::vector<uint8_t>(kMagic, kMagic + 4));
+    return !failed_;
+}
+
+void ParquetWriter::write_bytes(const std::vector<uint8_t>& bytes) {
+    if (!file_.write(bytes)) {
+        failed_ = true;
+    }
+    offset_ += static_cast<int64_t>(bytes.size());
+}
+
+void ParquetWriter::write(const AsterixBlock& block) {
+    for (const auto& message : block.messages) {
+        write(message);
+    }
+}
+
+bool ParquetWriter::write(const AsterixMessage& message) {
+    if (message.category != category_->header.category || !file_.is_open()) {
+        return false;
+    }
+
+    for (auto& buffer : buffers_) {
+        buffer.defined.push_back(0);
+    }
+
+    // Items come in UAP order: scan forward from the previous match
+    size_t cursor = 0;
+    for (const auto& item : message.data_items) {
+        const ItemColumns* columns = nullptr;
+        for (size_t n = 0; n < items_.size(); ++n) {
+            size_t index = cursor + n < items_.size() ? cursor + n : cursor + n - items_.size();
+            if (items_[index].item_id == item.id) {
+                columns = &items_[index];
+                cursor = index + 1;
+                break;
+            }
+        }
+        if (!columns) {
+            continue;
+        }
+
+        for (const auto& field : item.fields) {
+            for (size_t index : columns->columns) {
+                const ParquetColumn& column = columns_[index];
+                ColumnBuffer& buffer = buffers_[index];
+                if (column.field != field.name || buffer.defined.back()) {
+                    continue;
+                }
+
+                buffer.defined.back() = 1;
+                if (column.physical_type == type::BYTE_ARRAY) {
+                    put_le(buffer.byte_arrays, field.value.size(), 4);
+                    buffer.byte_arrays.insert(buffer.byte_arrays.end(), field.value.data(),
+                                              field.value.data() + field.value.size());
+                    buffered_bytes_ += 4 + field.value.size();
+                } else {
+                    buffer.integers.push_back(field.value.as_signed());
+                    buffered_bytes_ += sizeof(int64_t);
+                }
+                break;
+            }
+        }
+    }
+
+    buffered_rows_++;
+    total_rows_++;
+    if (buffered_rows_ >= options_.row_group_rows || buffered_bytes_ >= options_.row_group_bytes) {
+        flush_row_group();
+    }
+    return !failed_;
+}
+
+ParquetWriter::ColumnChunkInfo ParquetWriter::write_column_chunk(size_t index) {
+    const ParquetColumn& column = columns_[index];
+    ColumnBuffer& buffer = buffers_[index];
+
+    ColumnChunkInfo info;
+    info.file_offset = offset_;
+    info.dictionary_page_offset = -1;
+    info.num_values = static_cast<int64_t>(buffer.defined.size());
+    info.null_count = static_cast<int64_t>(std::count(buffer.defined.begin(), buffer.defined.end(), 0));
+    info.dictionary_encoded = false;
+
+    // Statistics on integer and boolean columns
+    if (!buffer.integers.empty()) {
+        auto range = std::minmax_element(buffer.integers.begin(), buffer.integers.end());
+        plain_value(info.min_value, column.physical_type, *range.first);
+        plain_value(info.max_value, column.physical_type, *range.second);
+    }
+
+    // Dictionary of the enum columns, in order of first appearance
+    std::vector<int64_t> dictionary;
+    std::vector<uint32_t> indices;
+    if (column.dictionary && !buffer.integers.empty()) {
+        std::unordered_map<int64_t, uint32_t> lookup;
+        indices.reserve(buffer.integers.size());
+        for (int64_t value : buffer.integers) {
+            auto inserted = lookup.emplace(value, static_cast<uint32_t>(dictionary.size()));
+            if (inserted.second) {
+                dictionary.push_back(value);
+            }
+            indices.push_back(inserted.first->second);
+        }
+        info.dictionary_encoded = dictionary.size() <= options_.max_dictionary_size;
+    }
+
+    int64_t chunk_start = offset_;
+
+    auto write_page = [&](int32_t page_type, const std::vector<uint8_t>& body, int32_t num_values,
+                          int32_t value_encoding) {
+        std::vector<uint8_t> header;
+        CompactWriter thrift(header);
+        thrift.begin_struct();
+        thrift.field_i32(1, page_type);
+        thrift.field_i32(2, static_cast<int32_t>(body.size()));
+        thrift.field_i32(3, static_cast<int32_t>(body.size()));
+        if (page_type == kDataPage) {
+            thrift.begin_struct_field(5);
+            thrift.field_i32(1, num_values);
+            thrift.field_i32(2, value_encoding);
+            thrift.field_i32(3, encoding::RLE);
+            thrift.field_i32(4, encoding::RLE);
+            thrift.end_struct();
+        } else {
+            thrift.begin_struct_field(7);
+            thrift.field_i32(1, num_values);
+            thrift.field_i32(2, value_encoding);
+            thrift.end_struct();
+        }
+        thrift.end_struct();
+
+        write_bytes(header);
+        write_bytes(body);
+    };
+
+    if (info.dictionary_encoded) {
+        std::vector<uint8_t> body;
+        for (int64_t value : dictionary) {
+            plain_value(body, column.physical_type, value);
+        }
+        info.dictionary_page_offset = offset_;
+        write_page(kDictionaryPage, body, static_cast<int32_t>(dictionary.size()), encoding::PLAIN);
+    }
+
+    // Data page: definition levels, then the non-null values
+    std::vector<uint8_t> body;
+    {
+        std::vector<uint32_t> levels(buffer.defined.begin(), buffer.defined.end());
+        std::vector<uint8_t> encoded;
+        encode_hybrid(levels.data(), levels.size(), 1, encoded);
+        put_le(body, encoded.size(), 4);
+        body.insert(body.end(), encoded.begin(), encoded.end());
+    }
+
+    int32_t value_encoding = encoding::PLAIN;
+    if (info.dictionary_encoded) {
+        unsigned width = std::max(1u, bit_width(dictionary.size() - 1));
+        body.push_back(static_cast<uint8_t>(width));
+        encode_hybrid(indices.data(), indices.size(), width, body);
+        value_encoding = encoding::RLE_DICTIONARY;
+    } else if (column.physical_type == type::BYTE_ARRAY) {
+        body.insert(body.end(), buffer.byte_arrays.begin(), buffer.byte_arrays.end());
+    } else if (column.physical_type == type::BOOLEAN) {
+        size_t first = body.size();
+        body.resize(first + (buffer.integers.size() + 7) / 8, 0);
+        for (size_t i = 0; i < buffer.integers.size(); ++i) {
+            if (buffer.integers[i]) {
+                body[first + i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+            }
+        }
+    } else {
+        for (int64_t value : buffer.integers) {
+            plain_value(body, column.physical_type, value);
+        }
+    }
+
+    info.data_page_offset = offset_;
+    write_page(kDataPage, body, static_cast<int32_t>(info.num_values), value_encoding);
+    info.size = offset_ - chunk_start;
+
+    buffer.defined.clear();
+    buffer.integers.clear();
+    buffer.byte_arrays.clear();
+    return info;
+}
+
+void ParquetWriter::flush_row_group() {
+    if (buffered_rows_ == 0 || !file_.is_open()) {
+        return;
+    }
+
+    RowGroupInfo group;
+    group.num_rows = static_cast<int64_t>(buffered_rows_);
+    group.total_byte_size = 0;
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        group.columns.push_back(write_column_chunk(i));
+        group.total_byte_size += group.columns.back().size;
+    }
+    row_groups_.push_back(std::move(group));
+
+    buffered_rows_ = 0;
+    buffered_bytes_ = 0;
+}
+
+bool ParquetWriter::write_footer() {
+    std::vector<uint8_t> footer;
+    CompactWriter thrift(footer);
+
+    thrift.begin_struct();
+    thrift.field_i32(1, 1);     // version
+
+    // Schema: the root group, then one optional leaf per column
+    thrift.begin_list_field(2, CompactWriter::kStruct, columns_.size() + 1);
+    thrift.begin_struct();
+    char table[16];
+    std::snprintf(table, sizeof(table), "cat%03u", static_cast<unsigned>(category_->header.category));
+    thrift.field_string(4, table);
+    thrift.field_i32(5, static_cast<int32_t>(columns_.size()));
+    thrift.end_struct();
+    for (const auto& column : columns_) {
+        thrift.begin_struct();
+        thrift.field_i32(1, column.physical_type);
+        thrift.field_i32(3, kOptional);
+        thrift.field_string(4, column.name);
+        if (column.converted_type != converted::NONE) {
+            thrift.field_i32(6, column.converted_type);
+        }
+        thrift.end_struct();
+    }
+
+    int64_t total_rows = 0;
+    for (const auto& group : row_groups_) {
+        total_rows += group.num_rows;
+    }
+    thrift.field_i64(3, total_rows);
+
+    thrift.begin_list_field(4, CompactWriter::kStruct, row_groups_.size());
+    for (const auto& group : row_groups_) {
+        thrift.begin_struct();
+        thrift.begin_list_field(1, CompactWriter::kStruct, group.columns.size());
+        for (size_t i = 0; i < group.columns.size(); ++i) {
+            const ColumnChunkInfo& chunk = group.columns[i];
+            const ParquetColumn& column = columns_[i];
+
+            thrift.begin_struct();
+            thrift.field_i64(2, chunk.file_offset);
+            thrift.begin_struct_field(3);
+            thrift.field_i32(1, column.physical_type);
+            if (chunk.dictionary_encoded) {
+                thrift.begin_list_field(2, CompactWriter::kI32, 3);
+                thrift.element_i32(encoding::PLAIN);
+                thrift.element_i32(encoding::RLE);
+                thrift.element_i32(encoding::RLE_DICTIONARY);
+            } else {
+                thrift.begin_list_field(2, CompactWriter::kI32, 2);
+                thrift.element_i32(encoding::PLAIN);
+                thrift.element_i32(encoding::RLE);
+            }
+            thrift.begin_list_field(3, CompactWriter::kBinary, 1);
+            thrift.element_string(column.name);
+            thrift.field_i32(4, kUncompressed);
+            thrift.field_i64(5, chunk.num_values);
+            thrift.field_i64(6, chunk.size);
+            thrift.field_i64(7, chunk.size);
+            thrift.field_i64(9, chunk.data_page_offset);
+            if (chunk.dictionary_page_offset >= 0) {
+                thrift.field_i64(11, chunk.dictionary_page_offset);
+            }
+            thrift.begin_struct_field(12);
+            thrift.field_i64(3, chunk.null_count);
+            if (!chunk.min_value.empty()) {
+                thrift.field_binary(5, chunk.max_value.data(), chunk.max_value.size());
+                thrift.field_binary(6, chunk.min_value.data(), chunk.min_value.size());
+            }
+            thrift.end_struct();
+            thrift.end_struct();    // ColumnMetaData
+            thrift.end_struct();    // ColumnChunk
+        }
+        thrift.field_i64(2, group.total_byte_size);
+        thrift.field_i64(3, group.num_rows);
+        thrift.end_struct();
+    }
+
+    thrift.field_string(6, "skydecoder");
+
+    // Type-defined ordering, so readers use the min/max statistics
+    thrift.begin_list_field(7, CompactWriter::kStruct, columns_.size());
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        thrift.begin_struct();
+        thrift.begin_struct_field(1);
+        thrift.end_struct();
+        thrift.end_struct();
+    }
+    thrift.end_struct();
+
+    put_le(footer, footer.size(), 4);
+    footer.insert(footer.end(), kMagic, kMagic + 4);
+    write_bytes(footer);
+    return !failed_;
+}
+
+bool ParquetWriter::close() {
+    if (!file_.is_open()) {
+        return false;
+    }
+
+    flush_row_group();
+    bool ok = write_footer();
+    bool closed = file_.close();
+    return ok && !failed_ && closed;
+}
+
+} // namespace skydecoder
\ No newline at end of file
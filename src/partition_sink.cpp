@@ -0,0 +1,355 @@
+#include "skydecoder/partition_sink.h"
+#include "day_time.h"
+#include <algorithm>
+#include <cmath>
+
+namespace skydecoder {
+
+namespace {
+
+using day_time::kSecondsPerDay;
+
+bool is_source_identifier(const std::string& item_id) {
+    return item_id.size() >= 4 && item_id.compare(item_id.size() - 4, 4, "/010") == 0;
+}
+
+const char* extension(PartitionFormat format) {
+    switch (format) {
+        case PartitionFormat::RAW: return ".ast";
+        case PartitionFormat::CBOR: return ".cbor";
+        case PartitionFormat::MSGPACK: return ".msgpack";
+    }
+    return "";
+}
+
+} // namespace
+
+PartitionSink::PartitionSink(PartitionOptions options) : options_(std::move(options)) {
+    options_.partition_seconds = options_.partition_seconds > 0.0 ? options_.partition_seconds : 3600.0;
+    options_.max_open_files = std::max<size_t>(options_.max_open_files, 1);
+    options_.write_size = std::max<size_t>(options_.write_size, 4096);
+    writer_ = std::thread(&PartitionSink::writer_loop, this);
+}
+
+PartitionSink::~PartitionSink() {
+    close();
+}
+
+PartitionSink::Route PartitionSink::route_of(const AsterixMessage& message) const {
+    Route route;
+    auto time_item = options_.time_items.find(message.category);
+
+    for (const auto& item : message.data_items) {
+        if (item.fields.empty()) {
+            continue;
+        }
+        if (is_source_identifier(item.id) && item.fields.size() >= 2) {
+            route.radar = static_cast<uint16_t>((item.fields[0].value.as_unsigned() << 8) |
+                                                (item.fields[1].value.as_unsigned() & 0xFF));
+        } else if (time_item != options_.time_items.end() && item.id == time_item->second) {
+            double lsb = 1.0;
+            if (message.definition) {
+                auto definition = message.definition->data_items.find(item.id);
+                if (definition != message.definition->data_items.end() && !definition->second.fields.empty()) {
+                    lsb = definition->second.fields[0].lsb;
+                }
+            }
+            route.time = item.fields[0].value.as_double() * lsb;
+            route.has_time = true;
+        }
+    }
+    return route;
+}
+
+std::string PartitionSink::partition_path(uint16_t radar, int64_t span, uint32_t sequence) const {
+    double start = span * options_.partition_seconds;
+    int64_t day = static_cast<int64_t>(std::floor(start / kSecondsPerDay));
+    int64_t seconds = static_cast<int64_t>(start - day * kSecondsPerDay);
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "_%03u-%03u_d%03lld_%02lld%02lld%02lld", radar >> 8, radar & 0xFF,
+                  static_cast<long long>(day), static_cast<long long>(seconds / 3600),
+                  static_cast<long long>(seconds / 60 % 60), static_cast<long long>(seconds % 60));
+
+    std::string path = options_.directory + "/" + options_.prefix + name;
+    if (sequence > 0) {
+        path += "_" + std::to_string(sequence);
+    }
+    return path + extension(options_.format);
+}
+
+PartitionSink::Partition& PartitionSink::partition_for(const Route& route) {
+    double time;
+    if (route.has_time) {
+        time = day_time::resolve(route.time, watermark_);
+        radar_times_[route.radar] = time;
+    } else {
+        auto latest = radar_times_.find(route.radar);
+        time = latest != radar_times_.end() ? latest->second : std::max(watermark_, 0.0);
+    }
+
+    int64_t span = static_cast<int64_t>(std::floor(time / options_.partition_seconds));
+    uint64_t key = (static_cast<uint64_t>(route.radar) << 32) | static_cast<uint32_t>(span);
+
+    auto it = partitions_.find(key);
+    if (it == partitions_.end()) {
+        Partition partition;
+        partition.id = next_id_++;
+        partition.radar = route.radar;
+        partition.span = span;
+        auto completed = completions_.find(key);
+        partition.path = partition_path(route.radar, span, completed != completions_.end() ? completed->second : 0);
+        partition.buffer.reserve(options_.write_size + 4096);
+        if (options_.format != PartitionFormat::RAW) {
+            partition.serializer = std::make_unique<BinarySerializer>(
+                options_.format == PartitionFormat::CBOR ? BinaryFormat::CBOR : BinaryFormat::MSGPACK);
+        }
+        it = partitions_.emplace(key, std::move(partition)).first;
+        produced_.partitions_opened++;
+
+        double expiry = (span + 1) * options_.partition_seconds + options_.lateness_seconds;
+        if (next_expiry_ < 0.0 || expiry < next_expiry_) {
+            next_expiry_ = expiry;
+        }
+    }
+
+    if (route.has_time) {
+        watermark_ = std::max(watermark_, time);
+    }
+    return it->second;
+}
+
+void PartitionSink::write(const AsterixBlock& block) {
+    for (const auto& message : block.messages) {
+        write(message);
+    }
+    produced_.blocks++;
+}
+
+void PartitionSink::write(const AsterixMessage& message) {
+    if (options_.format == PartitionFormat::RAW || closed_) {
+        produced_.errors++;
+        return;
+    }
+
+    Partition& partition = partition_for(route_of(message));
+    partition.serializer->write(message);
+    const auto& encoded = partition.serializer->buffer();
+    partition.buffer.insert(partition.buffer.end(), encoded.begin(), encoded.end());
+    partition.serializer->clear();
+    produced_.records++;
+    if (partition.buffer.size() >= options_.write_size) {
+        hand_over(partition, false, false);
+    }
+    complete_expired();
+}
+
+void PartitionSink::write_raw(const uint8_t* data, size_t size, const AsterixBlock& decoded) {
+    if (options_.format != PartitionFormat::RAW || closed_) {
+        produced_.errors++;
+        return;
+    }
+
+    Route route;
+    for (const auto& message : decoded.messages) {
+        route = route_of(message);
+        if (route.has_time) {
+            break;
+        }
+    }
+
+    Partition& partition = partition_for(route);
+    partition.buffer.insert(partition.buffer.end(), data, data + size);
+    produced_.records += decoded.messages.size();
+    produced_.blocks++;
+    if (partition.buffer.size() >= options_.write_size) {
+        hand_over(partition, false, false);
+    }
+    complete_expired();
+}
+
+void PartitionSink::hand_over(Partition& partition, bool complete, bool whole) {
+    Command command;
+    command.id = partition.id;
+    command.path = partition.path;
+    command.complete = complete;
+
+    // Writes are whole multiples of 4 KiB, the tail waits for the next one
+    size_t size = complete || whole ? partition.buffer.size() : partition.buffer.size() / 4096 * 4096;
+    if (size == partition.buffer.size()) {
+        command.data.swap(partition.buffer);
+        partition.buffer.reserve(options_.write_size + 4096);
+    } else {
+        command.data.assign(partition.buffer.begin(), partition.buffer.begin() + size);
+        partition.buffer.erase(partition.buffer.begin(), partition.buffer.begin() + size);
+    }
+    if (command.data.empty() && !complete) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (queued_bytes_ + size > options_.max_queued_bytes && !queue_.empty()) {
+        stats_.producer_waits++;
+        space_ready_.wait(lock, [&] { return queued_bytes_ + size <= options_.max_queued_bytes || queue_.empty(); });
+    }
+    queued_bytes_ += size;
+    queue_.push_back(std::move(command));
+    work_ready_.notify_one();
+}
+
+void PartitionSink::complete_expired() {
+    if (next_expiry_ < 0.0 || watermark_ < next_expiry_) {
+        return;
+    }
+
+    next_expiry_ = -1.0;
+    for (auto it = partitions_.begin(); it != partitions_.end();) {
+        double expiry = (it->second.span + 1) * options_.partition_seconds + options_.lateness_seconds;
+        if (expiry <= watermark_) {
+            hand_over(it->second, true, true);
+            completions_[it->first]++;
+            it = partitions_.erase(it);
+        } else {
+            if (next_expiry_ < 0.0 || expiry < next_expiry_) {
+                next_expiry_ = expiry;
+            }
+            ++it;
+        }
+    }
+}
+
+void PartitionSink::flush() {
+    for (auto& entry : partitions_) {
+        hand_over(entry.second, false, true);
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    space_ready_.wait(lock, [&] { return queue_.empty() && !busy_; });
+}
+
+bool PartitionSink::close() {
+    if (closed_) {
+        return stats().errors == 0;
+    }
+
+    for (auto& entry : partitions_) {
+        hand_over(entry.second, true, true);
+    }
+    partitions_.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_one();
+    writer_.join();
+    closed_ = true;
+    return stats().errors == 0;
+}
+
+PartitionStats PartitionSink::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PartitionStats stats = stats_;
+    stats.records = produced_.records;
+    stats.blocks = produced_.blocks;
+    stats.partitions_opened = produced_.partitions_opened;
+    stats.errors += produced_.errors;
+    return stats;
+}
+
+std::vector<std::string> PartitionSink::completed_files() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return completed_;
+}
+
+void PartitionSink::writer_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        work_ready_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            break;
+        }
+
+        Command command = std::move(queue_.front());
+        queue_.pop_front();
+        busy_ = true;
+        lock.unlock();
+
+        execute(command);
+
+        lock.lock();
+        queued_bytes_ -= command.data.size();
+        busy_ = false;
+        space_ready_.notify_all();
+    }
+    lock.unlock();
+
+    for (auto& entry : files_) {
+        std::fclose(entry.second.file);
+    }
+    files_.clear();
+}
+
+std::FILE* PartitionSink::file_for(const Command& command) {
+    auto it = files_.find(command.id);
+    if (it != files_.end()) {
+        it->second.last_use = ++use_counter_;
+        return it->second.file;
+    }
+
+    if (files_.size() >= options_.max_open_files) {
+        auto oldest = std::min_element(files_.begin(), files_.end(), [](const auto& a, const auto& b) {
+            return a.second.last_use < b.second.last_use;
+        });
+        std::fclose(oldest->second.file);
+        files_.erase(oldest);
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.evictions++;
+    }
+
+    // A new partition replaces a stale .part file, an evicted one appends
+    bool started = !started_.insert(command.id).second;
+    std::string part = command.path + ".part";
+    std::FILE* file = std::fopen(part.c_str(), started ? "ab" : "wb");
+    if (!file) {
+        return nullptr;
+    }
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    files_[command.id] = OpenFile{file, ++use_counter_};
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.file_opens++;
+    return file;
+}
+
+void PartitionSink::execute(Command& command) {
+    std::FILE* file = file_for(command);
+    bool ok = file != nullptr;
+    if (ok && !command.data.empty()) {
+        ok = std::fwrite(command.data.data(), 1, command.data.size(), file) == command.data.size();
+    }
+
+    bool renamed = false;
+    if (command.complete && file) {
+        ok = std::fclose(file) == 0 && ok;
+        files_.erase(command.id);
+        started_.erase(command.id);
+        std::string part = command.path + ".part";
+        renamed = ok && std::rename(part.c_str(), command.path.c_str()) == 0;
+        ok = ok && renamed;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!command.data.empty()) {
+        stats_.writes++;
+        stats_.bytes_written += ok ? command.data.size() : 0;
+    }
+    if (renamed) {
+        stats_.partitions_completed++;
+        completed_.push_back(command.path);
+    }
+    if (!ok) {
+        stats_.errors++;
+    }
+}
+
+} // namespace skydecoder
\ No newline at end of file
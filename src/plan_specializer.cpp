@@ -0,0 +1,193 @@
+#include "skydecoder/plan_specializer.h"
+#include "skydecoder/fspec_plan_cache.h"
+
+namespace skydecoder {
+
+namespace {
+
+// Value representation of a field, mirroring FieldParser::convert_raw_value
+enum class ValueKind {
+    U8,
+    U16,
+    U32,
+    I8,
+    I16,
+    I24,
+    I32,
+    BOOL,
+    UNSUPPORTED
+};
+
+ValueKind value_kind(FieldType type) {
+    switch (type) {
+        case FieldType::UINT8:
+        case FieldType::UINT1:
+        case FieldType::UINT2:
+        case FieldType::UINT3:
+        case FieldType::UINT4:
+        case FieldType::UINT5:
+        case FieldType::UINT6:
+        case FieldType::UINT7:
+            return ValueKind::U8;
+        case FieldType::UINT16:
+        case FieldType::UINT12:
+        case FieldType::UINT14:
+            return ValueKind::U16;
+        case FieldType::UINT24:
+        case FieldType::UINT32:
+            return ValueKind::U32;
+        case FieldType::INT8: return ValueKind::I8;
+        case FieldType::INT16: return ValueKind::I16;
+        case FieldType::INT24: return ValueKind::I24;
+        case FieldType::INT32: return ValueKind::I32;
+        case FieldType::BOOL: return ValueKind::BOOL;
+        case FieldType::STRING:
+        case FieldType::BYTES:
+            return ValueKind::UNSUPPORTED;
+    }
+    return ValueKind::UNSUPPORTED;
+}
+
+// Big-endian load of a compile-time number of bytes
+template <unsigned Span>
+inline uint64_t load_span(const uint8_t* p) {
+    uint64_t value = 0;
+    for (unsigned i = 0; i < Span; ++i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+template <unsigned Span, ValueKind Kind>
+void field_kernel(const uint8_t* data, uint32_t shift, uint32_t mask, FieldValue& out) {
+    uint32_t raw = static_cast<uint32_t>(load_span<Span>(data) >> shift) & mask;
+
+    if constexpr (Kind == ValueKind::U8) {
+        out = FieldValue::from_unsigned(static_cast<uint8_t>(raw), 1);
+    } else if constexpr (Kind == ValueKind::U16) {
+        out = FieldValue::from_unsigned(static_cast<uint16_t>(raw), 2);
+    } else if constexpr (Kind == ValueKind::U32) {
+        out = FieldValue::from_unsigned(raw, 4);
+    } else if constexpr (Kind == ValueKind::I8) {
+        out = FieldValue::from_signed(static_cast<int8_t>(core::sign_extend(raw, 8)), 1);
+    } else if constexpr (Kind == ValueKind::I16) {
+        out = FieldValue::from_signed(static_cast<int16_t>(core::sign_extend(raw, 16)), 2);
+    } else if constexpr (Kind == ValueKind::I24) {
+        out = FieldValue::from_signed(core::sign_extend(raw, 24), 4);
+    } else if constexpr (Kind == ValueKind::I32) {
+        out = FieldValue::from_signed(static_cast<int32_t>(raw), 4);
+    } else {
+        out = FieldValue::from_bool(raw != 0);
+    }
+}
+
+template <unsigned Span>
+SpecializedDecoder::Kernel kernel_for_kind(ValueKind kind) {
+    switch (kind) {
+        case ValueKind::U8: return &field_kernel<Span, ValueKind::U8>;
+        case ValueKind::U16: return &field_kernel<Span, ValueKind::U16>;
+        case ValueKind::U32: return &field_kernel<Span, ValueKind::U32>;
+        case ValueKind::I8: return &field_kernel<Span, ValueKind::I8>;
+        case ValueKind::I16: return &field_kernel<Span, ValueKind::I16>;
+        case ValueKind::I24: return &field_kernel<Span, ValueKind::I24>;
+        case ValueKind::I32: return &field_kernel<Span, ValueKind::I32>;
+        case ValueKind::BOOL: return &field_kernel<Span, ValueKind::BOOL>;
+        case ValueKind::UNSUPPORTED: return nullptr;
+    }
+    return nullptr;
+}
+
+// A field of up to 32 bits spans at most 5 bytes
+SpecializedDecoder::Kernel kernel_for(size_t span, ValueKind kind) {
+    switch (span) {
+        case 1: return kernel_for_kind<1>(kind);
+        case 2: return kernel_for_kind<2>(kind);
+        case 3: return kernel_for_kind<3>(kind);
+        case 4: return kernel_for_kind<4>(kind);
+        case 5: return kernel_for_kind<5>(kind);
+        default: return nullptr;
+    }
+}
+
+} // namespace
+
+std::unique_ptr<SpecializedDecoder> SpecializedDecoder::build(const FspecPlan& plan) {
+    if (!plan.all_fixed || !plan.unknown_items.empty()) {
+        return nullptr;
+    }
+
+    auto decoder = std::unique_ptr<SpecializedDecoder>(new SpecializedDecoder());
+    decoder->length_ = plan.fixed_length;
+
+    for (size_t i = 0; i < plan.items.size(); ++i) {
+        const DataItem& item = *plan.items[i];
+        size_t item_bits = static_cast<size_t>(item.length.value_or(0)) * 8;
+
+        ParsedDataItem prototype;
+        prototype.id = item.id;
+        prototype.name = item.name;
+        prototype.frn = plan.item_frns[i];
+
+        size_t bit_offset = 0;
+        for (const auto& field : item.fields) {
+            if (field.name == "spare") {
+                bit_offset += field.bits;
+                continue;
+            }
+
+            ValueKind kind = value_kind(field.type);
+            if (kind == ValueKind::UNSUPPORTED || field.bits == 0 || field.bits > 32 ||
+                field.encoding.has_value() || field.condition.has_value() ||
+                bit_offset + field.bits > item_bits) {
+                return nullptr;
+            }
+
+            size_t span = core::bytes_spanned(bit_offset, field.bits);
+
+            Operation op;
+            op.kernel = kernel_for(span, kind);
+            op.byte_offset = static_cast<uint32_t>(plan.item_offsets[i] + bit_offset / 8);
+            op.shift = static_cast<uint32_t>(span * 8 - (bit_offset % 8 + field.bits));
+            op.mask = field.bits >= 32 ? 0xFFFFFFFFu : ((1u << field.bits) - 1);
+            op.item = static_cast<uint16_t>(i);
+            op.field = static_cast<uint16_t>(prototype.fields.size());
+            if (!op.kernel) {
+                return nullptr;
+            }
+            decoder->ops_.push_back(op);
+
+            ParsedField parsed;
+            parsed.name = field.name;
+            parsed.description = field.description;
+            parsed.unit = field.unit;
+            prototype.fields.push_back(parsed);
+
+            bit_offset += field.bits;
+        }
+
+        decoder->prototype_.push_back(std::move(prototype));
+    }
+
+    return decoder;
+}
+
+void SpecializedDecoder::decode(const uint8_t* data, std::vector<ParsedDataItem>& items) const {
+    // Fill the new items in place: only the metadata is taken from the
+    // prototypes, the field values are written once by the operations
+    size_t first = items.size();
+    items.resize(first + prototype_.size());
+
+    ParsedDataItem* out = items.data() + first;
+    for (size_t i = 0; i < prototype_.size(); ++i) {
+        const ParsedDataItem& prototype = prototype_[i];
+        out[i].id = prototype.id;
+        out[i].name = prototype.name;
+        out[i].frn = prototype.frn;
+        out[i].fields.assign(prototype.fields.begin(), prototype.fields.end());
+    }
+    for (const Operation& op : ops_) {
+        op.kernel(data + op.byte_offset, op.shift, op.mask, out[op.item].fields[op.field].value);
+    }
+}
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,249 @@
+#include "skydecoder/quarantine_sink.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+
+namespace skydecoder {
+
+namespace {
+
+constexpr uint8_t kMagic[4] = {'S', 'K', 'Y', 'Q'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kEntryHeaderSize = 24;
+
+void put_le(uint8_t* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint64_t get_le(const uint8_t* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+QuarantineSink::QuarantineSink(QuarantineOptions options) : options_(std::move(options)) {
+    size_t capacity = 2;
+    while (capacity < options_.queue_capacity) {
+        capacity <<= 1;
+    }
+    options_.queue_capacity = capacity;
+    options_.flush_interval_ms = std::max(options_.flush_interval_ms, 1);
+
+    slots_.reset(new Slot[capacity]);
+    for (size_t i = 0; i < capacity; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+        slots_[i].entry = nullptr;
+    }
+    mask_ = capacity - 1;
+    for (auto& count : by_error_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+QuarantineSink::~QuarantineSink() {
+    if (open_) {
+        close();
+    }
+}
+
+bool QuarantineSink::open(const std::string& path) {
+    if (open_) {
+        close();
+    }
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        return false;
+    }
+    uint8_t header[8];
+    std::copy(kMagic, kMagic + 4, header);
+    put_le(header + 4, kVersion, 4);
+    if (std::fwrite(header, 1, sizeof(header), file_) != sizeof(header) || std::fflush(file_) != 0) {
+        std::fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+    file_bytes_ = sizeof(header);
+
+    stopping_.store(false);
+    open_ = true;
+    writer_ = std::thread(&QuarantineSink::writer_loop, this);
+    return true;
+}
+
+bool QuarantineSink::check(const AsterixBlock& block, const uint8_t* data, size_t size, uint64_t offset) {
+    if (block.error == BlockError::NONE ||
+        (block.error == BlockError::RECORD_ERROR && !options_.include_record_errors)) {
+        return false;
+    }
+    return submit(data, size, offset, block.error);
+}
+
+bool QuarantineSink::submit(const uint8_t* data, size_t size, uint64_t offset, BlockError error) {
+    if (!open_) {
+        return false;
+    }
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    by_error_[static_cast<size_t>(error) & 7].fetch_add(1, std::memory_order_relaxed);
+
+    auto* entry = new QuarantineEntry;
+    entry->offset = offset;
+    entry->time_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    entry->error = error;
+    entry->data.assign(data, data + size);
+
+    if (!push(entry)) {
+        delete entry;
+        dropped_queue_full_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (sleeping_.load(std::memory_order_acquire)) {
+        wake_.notify_one();
+    }
+    return true;
+}
+
+bool QuarantineSink::push(QuarantineEntry* entry) {
+    size_t position = head_.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots_[position & mask_];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+        if (difference == 0) {
+            if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                slot.entry = entry;
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            return false;                       // Full: the consumer has not freed this slot yet
+        } else {
+            position = head_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+QuarantineEntry* QuarantineSink::pop() {
+    Slot& slot = slots_[tail_ & mask_];
+    size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (static_cast<std::ptrdiff_t>(sequence - (tail_ + 1)) < 0) {
+        return nullptr;
+    }
+    QuarantineEntry* entry = slot.entry;
+    slot.sequence.store(tail_ + mask_ + 1, std::memory_order_release);
+    tail_++;
+    return entry;
+}
+
+void QuarantineSink::writer_loop() {
+    for (;;) {
+        bool stopping = stopping_.load(std::memory_order_acquire);
+        while (QuarantineEntry* entry = pop()) {
+            if (!write_entry(*entry)) {
+                errors_.fetch_add(1, std::memory_order_relaxed);
+            }
+            delete entry;
+        }
+        if (std::fflush(file_) != 0) {
+            errors_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (stopping) {
+            break;
+        }
+
+        // Producers only notify while the writer sleeps; the timeout covers a missed wake-up
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        sleeping_.store(true, std::memory_order_release);
+        wake_.wait_for(lock, std::chrono::milliseconds(options_.flush_interval_ms));
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+bool QuarantineSink::write_entry(const QuarantineEntry& entry) {
+    uint64_t size = kEntryHeaderSize + entry.data.size();
+    if (options_.max_file_bytes > 0 && file_bytes_ + size > options_.max_file_bytes) {
+        dropped_file_limit_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    uint8_t header[kEntryHeaderSize] = {};
+    put_le(header, entry.data.size(), 4);
+    header[4] = static_cast<uint8_t>(entry.error);
+    put_le(header + 8, entry.offset, 8);
+    put_le(header + 16, entry.time_us, 8);
+    if (std::fwrite(header, 1, sizeof(header), file_) != sizeof(header) ||
+        std::fwrite(entry.data.data(), 1, entry.data.size(), file_) != entry.data.size()) {
+        return false;
+    }
+
+    file_bytes_ += size;
+    written_.fetch_add(1, std::memory_order_relaxed);
+    bytes_written_.fetch_add(size, std::memory_order_relaxed);
+    return true;
+}
+
+bool QuarantineSink::close() {
+    if (!open_) {
+        return false;
+    }
+
+    stopping_.store(true, std::memory_order_release);
+    wake_.notify_one();
+    writer_.join();
+    open_ = false;
+
+    if (std::fclose(file_) != 0) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+    }
+    file_ = nullptr;
+    return errors_.load() == 0;
+}
+
+QuarantineStats QuarantineSink::stats() const {
+    QuarantineStats stats;
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    stats.written = written_.load(std::memory_order_relaxed);
+    stats.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+    stats.dropped_queue_full = dropped_queue_full_.load(std::memory_order_relaxed);
+    stats.dropped_file_limit = dropped_file_limit_.load(std::memory_order_relaxed);
+    stats.errors = errors_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < 8; ++i) {
+        stats.by_error[i] = by_error_[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+bool QuarantineSink::replay(const std::string& path, const EntryHandler& handler) {
+    std::ifstream file(path, std::ios::binary);
+    uint8_t header[8];
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        !std::equal(kMagic, kMagic + 4, header) || get_le(header + 4, 4) != kVersion) {
+        return false;
+    }
+
+    QuarantineEntry entry;
+    uint8_t entry_header[kEntryHeaderSize];
+    while (file.read(reinterpret_cast<char*>(entry_header), sizeof(entry_header))) {
+        entry.data.resize(static_cast<size_t>(get_le(entry_header, 4)));
+        entry.error = static_cast<BlockError>(entry_header[4]);
+        entry.offset = get_le(entry_header + 8, 8);
+        entry.time_us = get_le(entry_header + 16, 8);
+        if (!file.read(reinterpret_cast<char*>(entry.data.data()), static_cast<std::streamsize>(entry.data.size()))) {
+            break;
+        }
+        if (!handler(entry)) {
+            break;
+        }
+    }
+    return true;
+}
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "skydecoder/range_checker.h"
+#include <cmath>
+
+namespace skydecoder {
+
+namespace {
+
+// Enum sets of fields wider than this are not turned into bitsets
+constexpr unsigned kMaxEnumBits = 16;
+
+int64_t to_raw_bound(double value, double lsb, bool upper) {
+    double raw = value / lsb;
+    // Absorb the rounding of fractional LSBs such as 1/128
+    raw = upper ? std::floor(raw + 1e-9) : std::ceil(raw - 1e-9);
+    if (raw >= 9.2e18) {
+        return std::numeric_limits<int64_t>::max();
+    }
+    if (raw <= -9.2e18) {
+        return std::numeric_limits<int64_t>::min();
+    }
+    return static_cast<int64_t>(raw);
+}
+
+// 1 if the value is outside the range
+inline uint64_t out_of_range(const FieldCheck& check, int64_t value) {
+    return static_cast<uint64_t>(value < check.raw_min) | static_cast<uint64_t>(value > check.raw_max);
+}
+
+// 1 if the field has an enum set and the value is not in it
+inline uint64_t not_member(const FieldCheck& check, int64_t value) {
+    uint64_t index = static_cast<uint64_t>(value);
+    uint64_t in_table = index < check.allowed.size() * 64;
+    uint64_t word = check.allowed[in_table ? index >> 6 : 0];
+    return in_table ? ((word >> (index & 63)) & 1) ^ 1 : 1;
+}
+
+} // namespace
+
+RangeChecker::RangeChecker(const AsterixCategory& category) {
+    std::unordered_map<const Field*, int32_t> check_of_field;
+    for (const auto& item_pair : category.data_items) {
+        add_checks(item_pair.first, item_pair.second.fields, check_of_field);
+    }
+    
+    const auto& uap = category.uap.items;
+    for (size_t i = 0; i < uap.size(); ++i) {
+        auto it = category.data_items.find(uap[i]);
+        if (it == category.data_items.end()) {
+            continue;
+        }
+        
+        ItemPlan plan;
+        bool checked = false;
+        auto add_field = [&](const Field& field) {
+            auto check = check_of_field.find(&field);
+            plan.fields.push_back(&field);
+            plan.checks.push_back(check != check_of_field.end() ? check->second : -1);
+            checked = checked || check != check_of_field.end();
+        };
+        for (const auto& field : it->second.fields) {
+            if (field.name == "spare") {
+                continue;
+            }
+            add_field(field);
+            if (field.condition.has_value()) {
+                for (const auto& extension : field.extension_fields) {
+                    if (extension.name != "spare") {
+                        add_field(extension);
+                    }
+                }
+            }
+        }
+        
+        if (checked) {
+            items_.resize(i + 1);
+            items_[i] = std::move(plan);
+            frn_by_id_[uap[i]] = static_cast<uint16_t>(i + 1);
+        }
+    }
+}
+
+void RangeChecker::add_checks(const std::string& item_id, const std::vector<Field>& fields,
+                              std::unordered_map<const Field*, int32_t>& check_of_field) {
+    for (const auto& field : fields) {
+        add_checks(item_id, field.extension_fields, check_of_field);
+        
+        bool has_enum = !field.enums.empty() && field.bits > 0 && field.bits <= kMaxEnumBits;
+        if (!field.min_value && !field.max_value && !has_enum) {
+            continue;
+        }
+        
+        FieldCheck check;
+        check.item_id = item_id;
+        check.field = field.name;
+        if (field.min_value) {
+            check.raw_min = to_raw_bound(*field.min_value, field.lsb, false);
+        }
+        if (field.max_value) {
+            check.raw_max = to_raw_bound(*field.max_value, field.lsb, true);
+        }
+        if (has_enum) {
+            check.allowed.assign(((size_t(1) << field.bits) + 63) / 64, 0);
+            for (const auto& value : field.enums) {
+                if (value.value < (uint64_t(1) << field.bits)) {
+                    check.allowed[value.value >> 6] |= uint64_t(1) << (value.value & 63);
+                }
+            }
+        }
+        check_of_field[&field] = static_cast<int32_t>(checks_.size());
+        checks_.push_back(std::move(check));
+    }
+}
+
+void RangeChecker::check(const AsterixMessage& message) {
+    for (const auto& item : message.data_items) {
+        size_t frn = item.frn;
+        if (frn == 0) {
+            auto it = frn_by_id_.find(item.id);
+            frn = it != frn_by_id_.end() ? it->second : 0;
+        }
+        if (frn > 0 && frn <= items_.size() && !items_[frn - 1].fields.empty()) {
+            check_item(items_[frn - 1], item);
+        }
+    }
+}
+
+void RangeChecker::check_item(const ItemPlan& plan, const ParsedDataItem& item) {
+    // Decoded fields follow the plan, minus the extensions whose condition did
+    // not hold. Names view the definition, so a match is a pointer compare
+    // unless the checker was built from a copy of it.
+    size_t position = 0;
+    for (const auto& parsed : item.fields) {
+        while (position < plan.fields.size() && plan.fields[position]->name.data() != parsed.name.data() &&
+               plan.fields[position]->name != parsed.name) {
+            position++;
+        }
+        if (position == plan.fields.size()) {
+            return;
+        }
+        
+        int32_t index = plan.checks[position++];
+        FieldValue::Kind kind = parsed.value.kind();
+        if (index < 0 || (!parsed.value.is_integer() && kind != FieldValue::Kind::BOOL)) {
+            continue;
+        }
+        
+        FieldCheck& check = checks_[static_cast<size_t>(index)];
+        int64_t value = parsed.value.as_signed();
+        check.checked++;
+        check.range_violations += out_of_range(check, value);
+        if (!check.allowed.empty()) {
+            check.enum_violations += not_member(check, value);
+        }
+    }
+}
+
+void RangeChecker::check_column(size_t index, const int64_t* raw, size_t count) {
+    FieldCheck& check = checks_.at(index);
+    
+    // Separate plain loops so the range pass vectorises
+    uint64_t range_violations = 0;
+    const int64_t lo = check.raw_min;
+    const int64_t hi = check.raw_max;
+    for (size_t i = 0; i < count; ++i) {
+        range_violations += static_cast<uint64_t>(raw[i] < lo) | static_cast<uint64_t>(raw[i] > hi);
+    }
+    
+    uint64_t enum_violations = 0;
+    if (!check.allowed.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            enum_violations += not_member(check, raw[i]);
+        }
+    }
+    
+    check.checked += count;
+    check.range_violations += range_violations;
+    check.enum_violations += enum_violations;
+}
+
+uint64_t RangeChecker::total_violations() const {
+    uint64_t total = 0;
+    for (const auto& check : checks_) {
+        total += check.range_violations + check.enum_violations;
+    }
+    return total;
+}
+
+void RangeChecker::reset() {
+    for (auto& check : checks_) {
+        check.checked = 0;
+        check.range_violations = 0;
+        check.enum_violations = 0;
+    }
+}
+
+} // namespace skydecoder
\ No newline at end of file
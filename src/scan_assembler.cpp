@@ -0,0 +1,141 @@
+#include "skydecoder/scan_assembler.h"
+
+namespace skydecoder {
+
+namespace {
+
+constexpr int kNorthMarker = 1;
+constexpr int kSectorCrossing = 2;
+constexpr double kTimeOfDayLsb = 1.0 / 128.0;
+
+bool is_source_identifier(std::string_view item_id) {
+    return item_id.size() >= 4 && item_id.substr(item_id.size() - 4) == "/010";
+}
+
+} // namespace
+
+ScanAssembler::ScanAssembler(BatchHandler handler, ScanAssemblerOptions options)
+    : handler_(std::move(handler)), options_(options) {}
+
+ScanBatch& ScanAssembler::batch_for(uint16_t radar) {
+    auto& batch = batches_[radar];
+    if (!batch) {
+        batch = std::make_unique<ScanBatch>();
+        batch->radar = radar;
+        batch->records.reserve(options_.reserve_bytes, options_.reserve_records);
+    }
+    return *batch;
+}
+
+void ScanAssembler::emit(ScanBatch& batch, double end_time, bool closed_by_marker) {
+    if (batch.records.record_count() > 0) {
+        batch.end_time = end_time;
+        batch.complete = closed_by_marker && batch.sector >= 0;
+        handler_(batch);
+        batches_emitted_++;
+    }
+
+    batch.records.clear();
+    batch.sector = -1;
+    batch.start_time = -1.0;
+    batch.end_time = -1.0;
+    batch.complete = false;
+}
+
+template <typename Append>
+void ScanAssembler::route(const Marker& marker, Append&& append) {
+    ScanBatch& batch = batch_for(marker.radar);
+
+    if (marker.message_type == kNorthMarker) {
+        emit(batch, marker.time, true);
+        batch.scan++;
+        batch.sector = 0;
+        batch.start_time = marker.time;
+    } else if (marker.message_type == kSectorCrossing && options_.granularity == ScanGranularity::SECTOR) {
+        emit(batch, marker.time, true);
+        batch.sector = marker.sector >= 0 ? marker.sector : 0;
+        batch.start_time = marker.time;
+    }
+
+    append(batch.records);
+}
+
+void ScanAssembler::add(const AsterixBlock& block) {
+    for (const auto& message : block.messages) {
+        add(message);
+    }
+}
+
+void ScanAssembler::add(const AsterixMessage& message) {
+    Marker marker;
+    for (const auto& item : message.data_items) {
+        if (item.fields.empty()) {
+            continue;
+        }
+        const FieldValue& first = item.fields[0].value;
+
+        if (is_source_identifier(item.id) && item.fields.size() >= 2) {
+            marker.radar = static_cast<uint16_t>((first.as_unsigned() << 8) | (item.fields[1].value.as_unsigned() & 0xFF));
+        } else if (message.category == 2 && item.id == "I002/000") {
+            marker.message_type = static_cast<int>(first.as_unsigned());
+        } else if (message.category == 2 && item.id == "I002/020") {
+            marker.sector = static_cast<int>(first.as_unsigned());
+        } else if (message.category == 2 && item.id == "I002/030") {
+            marker.time = first.as_double() * kTimeOfDayLsb;
+        }
+    }
+
+    route(marker, [&](FlatRecordWriter& records) { records.append(message); });
+}
+
+void ScanAssembler::add(const FlatRecordView& record) {
+    Marker marker;
+    for (size_t i = 0; i < record.item_count(); ++i) {
+        FlatItemView item = record.item(i);
+        if (item.field_count() == 0) {
+            continue;
+        }
+        FlatFieldView first = item.field(0);
+
+        if (is_source_identifier(item.id()) && item.field_count() >= 2) {
+            marker.radar = static_cast<uint16_t>((first.as_unsigned() << 8) | (item.field(1).as_unsigned() & 0xFF));
+        } else if (record.category() == 2 && item.id() == "I002/000") {
+            marker.message_type = static_cast<int>(first.as_unsigned());
+        } else if (record.category() == 2 && item.id() == "I002/020") {
+            marker.sector = static_cast<int>(first.as_unsigned());
+        } else if (record.category() == 2 && item.id() == "I002/030") {
+            marker.time = first.scaled();
+        }
+    }
+
+    route(marker, [&](FlatRecordWriter& records) { records.append(record); });
+}
+
+void ScanAssembler::add(LazyRecord& record) {
+    Marker marker;
+    for (size_t i = 0; i < record.item_count(); ++i) {
+        const std::string& id = record.item_id(i);
+        const uint8_t* data = record.item_data(i);
+        size_t size = record.item_size(i);
+
+        if (is_source_identifier(id) && size >= 2) {
+            marker.radar = static_cast<uint16_t>((data[0] << 8) | data[1]);
+        } else if (record.category() == 2 && id == "I002/000" && size >= 1) {
+            marker.message_type = data[0];
+        } else if (record.category() == 2 && id == "I002/020" && size >= 1) {
+            marker.sector = data[0];
+        } else if (record.category() == 2 && id == "I002/030" && size >= 3) {
+            marker.time = ((data[0] << 16) | (data[1] << 8) | data[2]) * kTimeOfDayLsb;
+        }
+    }
+
+    route(marker, [&](FlatRecordWriter& records) { records.append(record); });
+}
+
+void ScanAssembler::flush() {
+    for (auto& entry : batches_) {
+        emit(*entry.second, -1.0, false);
+    }
+}
+
+} // namespace skydecoder
\ No newline at end of file
@@ -0,0 +1,284 @@
+#include "skydecoder/scan_correlator.h"
+#include <algorithm>
+
+namespace skydecoder {
+
+namespace {
+
+constexpr int kNorthMarker = 1;
+constexpr int kSectorCrossing = 2;
+constexpr size_t kRadarCount = 65536;
+constexpr double kTimeOfDayLsb = 1.0 / 128.0;
+
+bool is_source_identifier(std::string_view item_id) {
+    return item_id.size() >= 4 && item_id.substr(item_id.size() - 4) == "/010";
+}
+
+} // namespace
+
+ScanCorrelator::ScanCorrelator(SummaryHandler handler, CorrelatorOptions options)
+    : handler_(std::move(handler)), options_(std::move(options)),
+      radars_(new std::atomic<RadarState*>[kRadarCount]) {
+    options_.boundaries_per_radar = std::max<size_t>(options_.boundaries_per_radar, 1);
+    options_.scans_retained = std::max<size_t>(options_.scans_retained, 1);
+    for (size_t i = 0; i < kRadarCount; ++i) {
+        radars_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ScanCorrelator::~ScanCorrelator() {
+    for (size_t i = 0; i < kRadarCount; ++i) {
+        delete radars_[i].load(std::memory_order_relaxed);
+    }
+}
+
+ScanCorrelator::RadarState& ScanCorrelator::radar_state(uint16_t radar) {
+    std::atomic<RadarState*>& slot = radars_[radar];
+    RadarState* state = slot.load(std::memory_order_acquire);
+    if (state) {
+        return *state;
+    }
+
+    auto created = std::make_unique<RadarState>();
+    created->boundaries.resize(options_.boundaries_per_radar);
+    created->scans.resize(options_.scans_retained);
+    created->scan_open.assign(options_.scans_retained, false);
+    for (auto& summary : created->scans) {
+        summary.sector_records.assign(options_.max_sectors, 0);
+    }
+
+    // Another thread may have installed the radar meanwhile; keep theirs
+    if (slot.compare_exchange_strong(state, created.get(), std::memory_order_acq_rel)) {
+        return *created.release();
+    }
+    return *state;
+}
+
+bool ScanCorrelator::is_track(uint8_t category) const {
+    return std::find(options_.track_categories.begin(), options_.track_categories.end(), category) !=
+           options_.track_categories.end();
+}
+
+double ScanCorrelator::time_lsb(const AsterixMessage& message, const std::string& item_id) const {
+    if (message.definition) {
+        auto it = message.definition->data_items.find(item_id);
+        if (it != message.definition->data_items.end() && !it->second.fields.empty()) {
+            return it->second.fields[0].lsb;
+        }
+    }
+    return kTimeOfDayLsb;
+}
+
+void ScanCorrelator::emit(RadarState& state, size_t slot) {
+    if (state.scan_open[slot]) {
+        ScanSummary& summary = state.scans[slot];
+        if (handler_) {
+            handler_(summary);
+        }
+        state.scan_open[slot] = false;
+    }
+}
+
+void ScanCorrelator::add_marker(uint16_t radar, int message_type, int sector, double time) {
+    RadarState& state = radar_state(radar);
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.stats.markers++;
+
+    if (message_type == kNorthMarker) {
+        state.scan++;
+        sector = 0;
+
+        // The slot of the new scan holds the oldest retained one
+        size_t slot = state.scan % options_.scans_retained;
+        emit(state, slot);
+        ScanSummary& summary = state.scans[slot];
+        summary.radar = radar;
+        summary.scan = state.scan;
+        summary.start_time = time;
+        summary.plots = 0;
+        summary.tracks = 0;
+        std::fill(summary.sector_records.begin(), summary.sector_records.end(), 0);
+        summary.min_delay = 0.0;
+        summary.max_delay = 0.0;
+        summary.total_delay = 0.0;
+        state.scan_open[slot] = true;
+    } else if (message_type != kSectorCrossing) {
+        return;
+    }
+
+    if (time < 0.0) {
+        return;
+    }
+    state.boundaries[state.next] = Boundary{time, state.scan, std::max(sector, 0)};
+    state.next = (state.next + 1) % state.boundaries.size();
+    state.count = std::min(state.count + 1, state.boundaries.size());
+    state.latest_time = std::max(state.latest_time, time);
+}
+
+Correlation ScanCorrelator::add_record(uint16_t radar, uint8_t category, double time) {
+    Correlation result;
+    result.radar = radar;
+
+    RadarState& state = radar_state(radar);
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    if (time < 0.0 || state.count == 0) {
+        state.stats.unmatched++;
+        return result;
+    }
+
+    // Newest boundary at or before the record; records mostly belong to the
+    // current sector, so the walk back is short
+    const size_t size = state.boundaries.size();
+    const Boundary* found = nullptr;
+    for (size_t i = 1; i <= state.count; ++i) {
+        const Boundary& boundary = state.boundaries[(state.next + size - i) % size];
+        if (boundary.time <= time) {
+            found = &boundary;
+            break;
+        }
+    }
+
+    if (!found || found->scan == 0 || state.scan - found->scan >= options_.scans_retained) {
+        // Before the ring, before the first north marker or of an emitted scan
+        if (found && found->scan == 0) {
+            state.stats.unmatched++;
+        } else {
+            state.stats.too_old++;
+        }
+        return result;
+    }
+
+    result.matched = true;
+    result.scan = found->scan;
+    result.sector = found->sector;
+    result.sector_start = found->time;
+    result.delay = state.latest_time - time;
+
+    ScanSummary& summary = state.scans[found->scan % options_.scans_retained];
+    const uint64_t before = summary.plots + summary.tracks;
+    if (is_track(category)) {
+        summary.tracks++;
+    } else {
+        summary.plots++;
+    }
+    if (static_cast<size_t>(found->sector) < summary.sector_records.size()) {
+        summary.sector_records[found->sector]++;
+    }
+    if (before == 0) {
+        summary.min_delay = result.delay;
+        summary.max_delay = result.delay;
+    } else {
+        summary.min_delay = std::min(summary.min_delay, result.delay);
+        summary.max_delay = std::max(summary.max_delay, result.delay);
+    }
+    summary.total_delay += result.delay;
+
+    state.stats.matched++;
+    return result;
+}
+
+Correlation ScanCorrelator::add(const AsterixMessage& message) {
+    uint16_t radar = 0;
+    int message_type = -1;
+    int sector = -1;
+    double time = -1.0;
+
+    auto time_item = message.category == 2 ? options_.time_items.end() : options_.time_items.find(message.category);
+
+    for (const auto& item : message.data_items) {
+        if (item.fields.empty()) {
+            continue;
+        }
+        const FieldValue& first = item.fields[0].value;
+
+        if (is_source_identifier(item.id) && item.fields.size() >= 2) {
+            radar = static_cast<uint16_t>((first.as_unsigned() << 8) | (item.fields[1].value.as_unsigned() & 0xFF));
+        } else if (message.category == 2) {
+            if (item.id == "I002/000") {
+                message_type = static_cast<int>(first.as_unsigned());
+            } else if (item.id == "I002/020") {
+                sector = static_cast<int>(first.as_unsigned());
+            } else if (item.id == "I002/030") {
+                time = first.as_double() * kTimeOfDayLsb;
+            }
+        } else if (time_item != options_.time_items.end() && item.id == time_item->second) {
+            time = first.as_double() * time_lsb(message, item.id);
+        }
+    }
+
+    if (message.category == 2) {
+        add_marker(radar, message_type, sector, time);
+        return Correlation();
+    }
+    return add_record(radar, message.category, time);
+}
+
+Correlation ScanCorrelator::add(const FlatRecordView& record) {
+    uint16_t radar = 0;
+    int message_type = -1;
+    int sector = -1;
+    double time = -1.0;
+
+    auto time_item = record.category() == 2 ? options_.time_items.end() : options_.time_items.find(record.category());
+
+    for (size_t i = 0; i < record.item_count(); ++i) {
+        FlatItemView item = record.item(i);
+        if (item.field_count() == 0) {
+            continue;
+        }
+        FlatFieldView first = item.field(0);
+
+        if (is_source_identifier(item.id()) && item.field_count() >= 2) {
+            radar = static_cast<uint16_t>((first.as_unsigned() << 8) | (item.field(1).as_unsigned() & 0xFF));
+        } else if (record.category() == 2) {
+            if (item.id() == "I002/000") {
+                message_type = static_cast<int>(first.as_unsigned());
+            } else if (item.id() == "I002/020") {
+                sector = static_cast<int>(first.as_unsigned());
+            } else if (item.id() == "I002/030") {
+                time = first.scaled();
+            }
+        } else if (time_item != options_.time_items.end() && item.id() == time_item->second) {
+            time = first.scaled();
+        }
+    }
+
+    if (record.category() == 2) {
+        add_marker(radar, message_type, sector, time);
+        return Correlation();
+    }
+    return add_record(radar, record.category(), time);
+}
+
+void ScanCorrelator::flush() {
+    for (size_t i = 0; i < kRadarCount; ++i) {
+        RadarState* state = radars_[i].load(std::memory_order_acquire);
+        if (!state) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(state->mutex);
+        // Oldest scan first
+        for (size_t k = 1; k <= options_.scans_retained; ++k) {
+            emit(*state, (state->scan + k) % options_.scans_retained);
+        }
+    }
+}
+
+CorrelatorStats ScanCorrelator::stats() const {
+    CorrelatorStats total;
+    for (size_t i = 0; i < kRadarCount; ++i) {
+        RadarState* state = radars_[i].load(std::memory_order_acquire);
+        if (!state) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(state->mutex);
+        total.markers += state->stats.markers;
+        total.matched += state->stats.matched;
+        total.too_old += state->stats.too_old;
+        total.unmatched += state->stats.unmatched;
+    }
+    return total;
+}
+
+} // namespace skydecoder
\ No newline at end of file
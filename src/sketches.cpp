@@ -0,0 +1,362 @@
+#include "skydecoder/sketches.h"
+#include "byte_io.h"
+#include <algorithm>
+#include <cmath>
+
+namespace skydecoder {
+
+CountMinSketch::CountMinSketch(size_t width, size_t depth) : width_(1), depth_(std::max<size_t>(depth, 1)) {
+    while (width_ < width) {
+        width_ <<= 1;
+    }
+    counters_.assign(width_ * depth_, 0);
+}
+
+void CountMinSketch::add(uint64_t key, uint64_t count) {
+    // Row hashes h1 + i * h2 (Kirsch-Mitzenmacher)
+    uint64_t hash = sketch_hash(key);
+    uint64_t h1 = hash;
+    uint64_t h2 = (hash >> 32) | 1;
+    for (size_t row = 0; row < depth_; ++row) {
+        counters_[row * width_ + ((h1 + row * h2) & (width_ - 1))] += count;
+    }
+    total_ += count;
+}
+
+uint64_t CountMinSketch::estimate(uint64_t key) const {
+    uint64_t hash = sketch_hash(key);
+    uint64_t h1 = hash;
+    uint64_t h2 = (hash >> 32) | 1;
+    uint64_t result = UINT64_MAX;
+    for (size_t row = 0; row < depth_; ++row) {
+        result = std::min(result, counters_[row * width_ + ((h1 + row * h2) & (width_ - 1))]);
+    }
+    return result;
+}
+
+bool CountMinSketch::merge(const CountMinSketch& other) {
+    if (other.width_ != width_ || other.depth_ != depth_) {
+        return false;
+    }
+    for (size_t i = 0; i < counters_.size(); ++i) {
+        counters_[i] += other.counters_[i];
+    }
+    total_ += other.total_;
+    return true;
+}
+
+void CountMinSketch::clear() {
+    std::fill(counters_.begin(), counters_.end(), 0);
+    total_ = 0;
+}
+
+std::vector<uint8_t> CountMinSketch::serialize() const {
+    std::vector<uint8_t> out;
+    byte_io::put_u64(out, width_);
+    byte_io::put_u64(out, depth_);
+    byte_io::put_u64(out, total_);
+    for (uint64_t counter : counters_) {
+        byte_io::put_u64(out, counter);
+    }
+    return out;
+}
+
+bool CountMinSketch::deserialize(const uint8_t* data, size_t size) {
+    byte_io::Reader reader(data, size);
+    size_t width = reader.u64();
+    size_t depth = reader.u64();
+    uint64_t total = reader.u64();
+    if (!reader.ok() || width == 0 || (width & (width - 1)) || depth == 0) {
+        return false;
+    }
+    // Divide first: width * depth may overflow
+    size_t stored = (size - 24) / 8;
+    if (depth > stored / width || width * depth != stored) {
+        return false;
+    }
+
+    std::vector<uint64_t> counters(width * depth);
+    for (auto& counter : counters) {
+        counter = reader.u64();
+    }
+    if (!reader.ok() || !reader.at_end()) {
+        return false;
+    }
+    width_ = width;
+    depth_ = depth;
+    total_ = total;
+    counters_ = std::move(counters);
+    return true;
+}
+
+SpaceSaving::SpaceSaving(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {
+    entries_.reserve(capacity_);
+    slots_.reserve(capacity_ * 2);
+}
+
+size_t SpaceSaving::min_slot() const {
+    size_t slot = 0;
+    for (size_t i = 1; i < entries_.size(); ++i) {
+        if (entries_[i].count < entries_[slot].count) {
+            slot = i;
+        }
+    }
+    return slot;
+}
+
+uint64_t SpaceSaving::min_count() const {
+    return entries_.size() < capacity_ || entries_.empty() ? 0 : entries_[min_slot()].count;
+}
+
+void SpaceSaving::add(uint64_t key, uint64_t count) {
+    auto it = slots_.find(key);
+    if (it != slots_.end()) {
+        entries_[it->second].count += count;
+        return;
+    }
+
+    if (entries_.size() < capacity_) {
+        slots_.emplace(key, static_cast<uint32_t>(entries_.size()));
+        entries_.push_back(Entry{key, count, 0});
+        return;
+    }
+
+    // Replace the smallest counter; the new key inherits its count as error
+    size_t slot = min_slot();
+    Entry& entry = entries_[slot];
+    slots_.erase(entry.key);
+    slots_.emplace(key, static_cast<uint32_t>(slot));
+    entry.error = entry.count;
+    entry.count += count;
+    entry.key = key;
+}
+
+std::vector<SpaceSaving::Entry> SpaceSaving::top(size_t n) const {
+    std::vector<Entry> result = entries_;
+    std::sort(result.begin(), result.end(), [](const Entry& a, const Entry& b) {
+        return a.count != b.count ? a.count > b.count : a.key < b.key;
+    });
+    if (result.size() > n) {
+        result.resize(n);
+    }
+    return result;
+}
+
+void SpaceSaving::merge(const SpaceSaving& other) {
+    const uint64_t own_min = min_count();
+    const uint64_t other_min = other.min_count();
+
+    std::vector<Entry> merged;
+    merged.reserve(entries_.size() + other.entries_.size());
+    for (const auto& entry : entries_) {
+        auto it = other.slots_.find(entry.key);
+        if (it != other.slots_.end()) {
+            const Entry& match = other.entries_[it->second];
+            merged.push_back(Entry{entry.key, entry.count + match.count, entry.error + match.error});
+        } else {
+            merged.push_back(Entry{entry.key, entry.count + other_min, entry.error + other_min});
+        }
+    }
+    for (const auto& entry : other.entries_) {
+        if (slots_.find(entry.key) == slots_.end()) {
+            merged.push_back(Entry{entry.key, entry.count + own_min, entry.error + own_min});
+        }
+    }
+
+    std::sort(merged.begin(), merged.end(), [](const Entry& a, const Entry& b) {
+        return a.count != b.count ? a.count > b.count : a.key < b.key;
+    });
+    if (merged.size() > capacity_) {
+        merged.resize(capacity_);
+    }
+
+    entries_ = std::move(merged);
+    slots_.clear();
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        slots_.emplace(entries_[i].key, static_cast<uint32_t>(i));
+    }
+}
+
+void SpaceSaving::clear() {
+    entries_.clear();
+    slots_.clear();
+}
+
+std::vector<uint8_t> SpaceSaving::serialize() const {
+    std::vector<uint8_t> out;
+    byte_io::put_u64(out, capacity_);
+    byte_io::put_u64(out, entries_.size());
+    for (const auto& entry : entries_) {
+        byte_io::put_u64(out, entry.key);
+        byte_io::put_u64(out, entry.count);
+        byte_io::put_u64(out, entry.error);
+    }
+    return out;
+}
+
+bool SpaceSaving::deserialize(const uint8_t* data, size_t size) {
+    byte_io::Reader reader(data, size);
+    size_t capacity = reader.u64();
+    size_t count = reader.u64();
+    if (!reader.ok() || capacity == 0 || count > capacity || count != (size - 16) / 24) {
+        return false;
+    }
+
+    std::vector<Entry> entries(count);
+    for (auto& entry : entries) {
+        entry.key = reader.u64();
+        entry.count = reader.u64();
+        entry.error = reader.u64();
+    }
+    if (!reader.ok() || !reader.at_end()) {
+        return false;
+    }
+
+    // A key may only be counted once
+    std::unordered_map<uint64_t, uint32_t> slots;
+    slots.reserve(count * 2);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (!slots.emplace(entries[i].key, static_cast<uint32_t>(i)).second) {
+            return false;
+        }
+    }
+
+    capacity_ = capacity;
+    entries_ = std::move(entries);
+    slots_ = std::move(slots);
+    return true;
+}
+
+std::vector<SpaceSaving::Entry> HeavyHitters::top(size_t n) const {
+    // Rank on the tighter of the two upper bounds
+    std::vector<SpaceSaving::Entry> result = candidates_.top(candidates_.size());
+    for (auto& entry : result) {
+        uint64_t bound = frequencies_.estimate(entry.key);
+        if (bound < entry.count) {
+            entry.error -= std::min(entry.error, entry.count - bound);
+            entry.count = bound;
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const SpaceSaving::Entry& a, const SpaceSaving::Entry& b) {
+        return a.count != b.count ? a.count > b.count : a.key < b.key;
+    });
+    if (result.size() > n) {
+        result.resize(n);
+    }
+    return result;
+}
+
+bool HeavyHitters::merge(const HeavyHitters& other) {
+    if (!frequencies_.merge(other.frequencies_)) {
+        return false;
+    }
+    candidates_.merge(other.candidates_);
+    return true;
+}
+
+void HeavyHitters::clear() {
+    candidates_.clear();
+    frequencies_.clear();
+}
+
+std::vector<uint8_t> HeavyHitters::serialize() const {
+    std::vector<uint8_t> out;
+    std::vector<uint8_t> candidates = candidates_.serialize();
+    std::vector<uint8_t> frequencies = frequencies_.serialize();
+    byte_io::put_bytes(out, candidates.data(), candidates.size());
+    byte_io::put_bytes(out, frequencies.data(), frequencies.size());
+    return out;
+}
+
+bool HeavyHitters::deserialize(const uint8_t* data, size_t size) {
+    byte_io::Reader reader(data, size);
+    size_t candidates_size, frequencies_size;
+    const uint8_t* candidates = reader.bytes(candidates_size);
+    const uint8_t* frequencies = reader.bytes(frequencies_size);
+    if (!reader.ok() || !reader.at_end()) {
+        return false;
+    }
+
+    // Both or neither
+    SpaceSaving restored_candidates;
+    CountMinSketch restored_frequencies;
+    if (!restored_candidates.deserialize(candidates, candidates_size) ||
+        !restored_frequencies.deserialize(frequencies, frequencies_size)) {
+        return false;
+    }
+    candidates_ = std::move(restored_candidates);
+    frequencies_ = std::move(restored_frequencies);
+    return true;
+}
+
+HyperLogLog::HyperLogLog(unsigned precision) : precision_(std::min(std::max(precision, 4u), 18u)) {
+    registers_.assign(size_t(1) << precision_, 0);
+}
+
+void HyperLogLog::add_hash(uint64_t hash) {
+    size_t index = hash >> (64 - precision_);
+    uint64_t rest = hash << precision_;
+
+    // Position of the first set bit of the remaining bits
+    uint8_t rank = 1;
+    while (rank <= 64 - precision_ && !(rest & 0x8000000000000000ULL)) {
+        rest <<= 1;
+        rank++;
+    }
+    registers_[index] = std::max(registers_[index], rank);
+}
+
+double HyperLogLog::estimate() const {
+    const double m = static_cast<double>(registers_.size());
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (uint8_t value : registers_) {
+        sum += std::ldexp(1.0, -static_cast<int>(value));
+        zeros += value == 0;
+    }
+
+    const double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+
+    // Linear counting for small cardinalities
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / static_cast<double>(zeros));
+    }
+    return estimate;
+}
+
+bool HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.precision_ != precision_) {
+        return false;
+    }
+    for (size_t i = 0; i < registers_.size(); ++i) {
+        registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+    return true;
+}
+
+void HyperLogLog::clear() {
+    std::fill(registers_.begin(), registers_.end(), 0);
+}
+
+std::vector<uint8_t> HyperLogLog::serialize() const {
+    std::vector<uint8_t> out;
+    byte_io::put_u64(out, precision_);
+    byte_io::put_bytes(out, registers_.data(), registers_.size());
+    return out;
+}
+
+bool HyperLogLog::deserialize(const uint8_t* data, size_t size) {
+    byte_io::Reader reader(data, size);
+    unsigned precision = static_cast<unsigned>(reader.u64());
+    size_t count;
+    const uint8_t* registers = reader.bytes(count);
+    if (!reader.ok() || !reader.at_end() || precision < 4 || precision > 18 || count != (size_t(1) << precision)) {
+        return false;
+    }
+    precision_ = precision;
+    registers_.assign(registers, registers + count);
+    return true;
+}
+
+} // namespace skydecoder
\ No newline at end of file
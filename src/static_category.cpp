@@ -0,0 +1,309 @@
+#include "skydecoder/static_category.h"
+#include "skydecoder/static_cat002.h"
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <sstream>
+
+namespace skydecoder {
+
+namespace {
+
+// The built-in plan is resolved by the compiler: a north marker record
+// (I002/010, 000, 030, 041, 090) has 10 bytes of items
+constexpr uint8_t kNorthMarkerFspec[] = {0xD9, 0x10};
+static_assert(static_categories::kCat002Plan.fixed_record_length(kNorthMarkerFspec, 2) == 10,
+              "CAT002 static plan does not match the UAP");
+static_assert(static_field_offset(*find_static_item(static_categories::kCat002, "I002/090"), 1) == 8,
+              "CAT002 static field offsets do not match the item layout");
+
+Field to_field(const StaticField& definition) {
+    Field field;
+    field.name = definition.name;
+    field.type = definition.type;
+    field.bits = definition.bits;
+    field.description = definition.description;
+    field.lsb = definition.lsb;
+    field.unit = definition.unit;
+
+    for (size_t i = 0; i < definition.enum_count; ++i) {
+        field.enums.push_back({definition.enums[i].value, definition.enums[i].description});
+    }
+
+    if (definition.encoding) {
+        field.encoding = definition.encoding;
+    }
+    if (definition.condition) {
+        field.condition = definition.condition;
+    }
+    if (definition.has_min) {
+        field.min_value = definition.min_value;
+    }
+    if (definition.has_max) {
+        field.max_value = definition.max_value;
+    }
+    for (size_t i = 0; i < definition.extension_count; ++i) {
+        field.extension_fields.push_back(to_field(definition.extension_fields[i]));
+    }
+
+    return field;
+}
+
+const char* field_type_name(FieldType type) {
+    switch (type) {
+        case FieldType::UINT8: return "UINT8";
+        case FieldType::UINT16: return "UINT16";
+        case FieldType::UINT24: return "UINT24";
+        case FieldType::UINT32: return "UINT32";
+        case FieldType::UINT1: return "UINT1";
+        case FieldType::UINT2: return "UINT2";
+        case FieldType::UINT3: return "UINT3";
+        case FieldType::UINT4: return "UINT4";
+        case FieldType::UINT5: return "UINT5";
+        case FieldType::UINT6: return "UINT6";
+        case FieldType::UINT7: return "UINT7";
+        case FieldType::UINT12: return "UINT12";
+        case FieldType::UINT14: return "UINT14";
+        case FieldType::INT8: return "INT8";
+        case FieldType::INT16: return "INT16";
+        case FieldType::INT24: return "INT24";
+        case FieldType::INT32: return "INT32";
+        case FieldType::BOOL: return "BOOL";
+        case FieldType::STRING: return "STRING";
+        case FieldType::BYTES: return "BYTES";
+    }
+    return "BYTES";
+}
+
+const char* data_format_name(DataFormat format) {
+    switch (format) {
+        case DataFormat::FIXED: return "FIXED";
+        case DataFormat::VARIABLE: return "VARIABLE";
+        case DataFormat::EXPLICIT: return "EXPLICIT";
+        case DataFormat::REPETITIVE: return "REPETITIVE";
+    }
+    return "FIXED";
+}
+
+const char* unit_name(Unit unit) {
+    switch (unit) {
+        case Unit::NONE: return "NONE";
+        case Unit::SECONDS: return "SECONDS";
+        case Unit::NAUTICAL_MILES: return "NAUTICAL_MILES";
+        case Unit::DEGREES: return "DEGREES";
+        case Unit::FLIGHT_LEVEL: return "FLIGHT_LEVEL";
+        case Unit::FEET: return "FEET";
+        case Unit::KNOTS: return "KNOTS";
+        case Unit::METERS_PER_SECOND: return "METERS_PER_SECOND";
+    }
+    return "NONE";
+}
+
+// C++ string literal
+std::string quote(const std::string& text) {
+    std::string result = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\t': result += "\\t"; break;
+            case '\r': break;
+            default: result += c;
+        }
+    }
+    return result + "\"";
+}
+
+std::string quote_or_null(const std::optional<std::string>& text) {
+    return text.has_value() ? quote(text.value()) : "nullptr";
+}
+
+// Identifier derived from an item id, e.g. "I002/010" -> "i002_010"
+std::string symbol(const std::string& id) {
+    std::string result;
+    for (char c : id) {
+        result += std::isalnum(static_cast<unsigned char>(c))
+            ? static_cast<char>(std::tolower(static_cast<unsigned char>(c))) : '_';
+    }
+    return result;
+}
+
+class SourceWriter {
+public:
+    explicit SourceWriter(const std::string& prefix) : prefix_(prefix) {}
+
+    // Emit the tables of a field list (enums and extensions first) and return its symbol
+    std::string write_fields(const std::vector<Field>& fields, const std::string& name) {
+        std::vector<std::string> enum_symbols;
+        std::vector<std::string> extension_symbols;
+
+        for (size_t i = 0; i < fields.size(); ++i) {
+            const Field& field = fields[i];
+            std::string field_symbol = name + "_" + symbol(field.name);
+
+            enum_symbols.push_back("nullptr");
+            if (!field.enums.empty()) {
+                enum_symbols.back() = field_symbol + "_enums";
+                out_ << "inline constexpr StaticEnum " << enum_symbols.back() << "[] = {\n";
+                for (const auto& value : field.enums) {
+                    out_ << "    {" << value.value << ", " << quote(value.description) << "},\n";
+                }
+                out_ << "};\n\n";
+            }
+
+            extension_symbols.push_back("nullptr");
+            if (!field.extension_fields.empty()) {
+                extension_symbols.back() = write_fields(field.extension_fields, field_symbol + "_ext");
+            }
+        }
+
+        std::string fields_symbol = name + "_fields";
+        out_ << "inline constexpr StaticField " << fields_symbol << "[] = {\n";
+        for (size_t i = 0; i < fields.size(); ++i) {
+            const Field& field = fields[i];
+            out_ << "    {" << quote(field.name) << ", FieldType::" << field_type_name(field.type)
+                 << ", " << static_cast<int>(field.bits) << ", " << quote(field.description)
+                 << ", " << std::setprecision(17) << field.lsb << ", Unit::" << unit_name(field.unit) << ",\n"
+                 << "     " << enum_symbols[i] << ", " << field.enums.size()
+                 << ", " << quote_or_null(field.encoding)
+                 << ", " << quote_or_null(field.condition)
+                 << ", " << extension_symbols[i] << ", " << field.extension_fields.size();
+            if (field.min_value.has_value() || field.max_value.has_value()) {
+                out_ << ",\n     " << (field.min_value.has_value() ? "true" : "false") << ", " << field.min_value.value_or(0.0)
+                     << ", " << (field.max_value.has_value() ? "true" : "false") << ", " << field.max_value.value_or(0.0);
+            }
+            out_ << "},\n";
+        }
+        out_ << "};\n\n";
+
+        return fields_symbol;
+    }
+
+    std::ostringstream& out() { return out_; }
+    const std::string& prefix() const { return prefix_; }
+
+private:
+    std::string prefix_;
+    std::ostringstream out_;
+};
+
+} // namespace
+
+AsterixCategory to_category(const StaticCategory& definition) {
+    AsterixCategory category;
+
+    category.header.category = definition.category;
+    category.header.name = definition.name;
+    category.header.description = definition.description;
+    category.header.version = definition.version;
+    category.header.date = definition.date;
+
+    category.uap.items.assign(definition.uap, definition.uap + definition.uap_size);
+
+    for (size_t i = 0; i < definition.item_count; ++i) {
+        const StaticDataItem& static_item = definition.items[i];
+
+        DataItem item;
+        item.id = static_item.id;
+        item.name = static_item.name;
+        item.definition = static_item.definition;
+        item.format = static_item.format;
+        if (static_item.length > 0) {
+            item.length = static_item.length;
+        }
+        for (size_t f = 0; f < static_item.field_count; ++f) {
+            item.fields.push_back(to_field(static_item.fields[f]));
+        }
+
+        category.data_items[item.id] = std::move(item);
+    }
+
+    for (size_t i = 0; i < definition.validation_rule_count; ++i) {
+        const StaticValidationRule& static_rule = definition.validation_rules[i];
+
+        ValidationRule rule;
+        rule.field = static_rule.field;
+        rule.type = static_rule.type;
+        if (static_rule.condition) {
+            rule.condition = static_rule.condition;
+        }
+        category.validation_rules.push_back(std::move(rule));
+    }
+
+    return category;
+}
+
+std::string generate_static_category_source(const AsterixCategory& category) {
+    std::ostringstream cat_number;
+    cat_number << std::setw(3) << std::setfill('0') << static_cast<int>(category.header.category);
+
+    SourceWriter writer("cat" + cat_number.str());
+    auto& out = writer.out();
+    const std::string& prefix = writer.prefix();
+
+    out << "#pragma once\n\n"
+        << "// Generated from the XML definition of category " << cat_number.str()
+        << " (" << category.header.name << ", version " << category.header.version << ")\n"
+        << "#include \"skydecoder/static_category.h\"\n\n"
+        << "namespace skydecoder {\n"
+        << "namespace static_categories {\n\n";
+
+    out << "inline constexpr const char* " << prefix << "_uap[] = {\n";
+    for (const auto& item : category.uap.items) {
+        out << "    " << quote(item) << ",\n";
+    }
+    out << "};\n\n";
+
+    // Stable output: items in id order
+    std::vector<const DataItem*> items;
+    for (const auto& entry : category.data_items) {
+        items.push_back(&entry.second);
+    }
+    std::sort(items.begin(), items.end(), [](const DataItem* a, const DataItem* b) { return a->id < b->id; });
+
+    std::vector<std::string> field_symbols;
+    for (const DataItem* item : items) {
+        field_symbols.push_back(writer.write_fields(item->fields, prefix + "_" + symbol(item->id)));
+    }
+
+    out << "inline constexpr StaticDataItem " << prefix << "_items[] = {\n";
+    for (size_t i = 0; i < items.size(); ++i) {
+        const DataItem* item = items[i];
+        out << "    {" << quote(item->id) << ", " << quote(item->name) << ",\n"
+            << "     " << quote(item->definition) << ",\n"
+            << "     DataFormat::" << data_format_name(item->format) << ", " << item->length.value_or(0)
+            << ", " << field_symbols[i] << ", " << item->fields.size() << "},\n";
+    }
+    out << "};\n\n";
+
+    out << "inline constexpr StaticValidationRule " << prefix << "_validation_rules[] = {\n";
+    for (const auto& rule : category.validation_rules) {
+        out << "    {" << quote(rule.field) << ", " << quote(rule.type) << ", "
+            << quote_or_null(rule.condition) << "},\n";
+    }
+    if (category.validation_rules.empty()) {
+        out << "    {\"\", \"\", nullptr},\n";
+    }
+    out << "};\n\n";
+
+    std::string name = "kCat" + cat_number.str();
+    out << "inline constexpr StaticCategory " << name << " = {\n"
+        << "    " << static_cast<int>(category.header.category) << ", " << quote(category.header.name) << ",\n"
+        << "    " << quote(category.header.description) << ",\n"
+        << "    " << quote(category.header.version) << ", " << quote(category.header.date) << ",\n"
+        << "    " << prefix << "_uap, " << category.uap.items.size() << ",\n"
+        << "    " << prefix << "_items, " << items.size() << ",\n"
+        << "    " << prefix << "_validation_rules, " << category.validation_rules.size() << "\n"
+        << "};\n\n";
+
+    out << "// UAP positions resolved at compile time\n"
+        << "inline constexpr auto " << name << "Plan = make_static_plan<"
+        << category.uap.items.size() << ">(" << name << ");\n\n"
+        << "} // namespace static_categories\n"
+        << "} // namespace skydecoder\n";
+
+    return out.str();
+}
+
+} // namespace skydecoder
\ No newline at end of file
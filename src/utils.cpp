@@ -1,21 +1,20 @@
 #include "skydecoder/utils.h"
+#include "kernels.h"
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 #include <regex>
 
 namespace skydecoder {
 namespace utils {
 
 std::string to_hex_string(const std::vector<uint8_t>& data) {
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
-    for (uint8_t byte : data) {
-        ss << std::setw(2) << static_cast<unsigned>(byte);
-    }
-    return ss.str();
+    std::string result(data.size() * 2, '\0');
+    kernels::active().hex_encode(data.data(), data.size(), &result[0]);
+    return result;
 }
 
 std::string to_hex_string(uint32_t value, size_t width) {
@@ -53,40 +52,39 @@ std::vector<uint8_t> from_hex_string(const std::string& hex) {
 }
 
 std::string format_value(const FieldValue& value, Unit unit, double lsb) {
-    return std::visit([&](const auto& val) -> std::string {
-        using T = std::decay_t<decltype(val)>;
-        
-        if constexpr (std::is_same_v<T, bool>) {
-            return val ? "true" : "false";
-        } else if constexpr (std::is_same_v<T, std::string>) {
-            return val;
-        } else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
-            return to_hex_string(val);
-        } else if constexpr (std::is_arithmetic_v<T>) {
-            double numeric_val = static_cast<double>(val) * lsb;
-            
-            switch (unit) {
-                case Unit::SECONDS:
-                    return format_time_of_day(val, lsb);
-                case Unit::NAUTICAL_MILES:
-                    return std::to_string(numeric_val) + " NM";
-                case Unit::DEGREES:
-                    return std::to_string(numeric_val) + "°";
-                case Unit::FLIGHT_LEVEL:
-                    return format_flight_level(val, lsb);
-                case Unit::FEET:
-                    return std::to_string(numeric_val) + " ft";
-                case Unit::KNOTS:
-                    return std::to_string(numeric_val) + " kts";
-                case Unit::METERS_PER_SECOND:
-                    return std::to_string(numeric_val) + " m/s";
-                default:
-                    return std::to_string(numeric_val);
-            }
-        } else {
+    switch (value.kind()) {
+        case FieldValue::Kind::BOOL:
+            return value.as_bool() ? "true" : "false";
+        case FieldValue::Kind::STRING:
+            return std::string(value.as_string());
+        case FieldValue::Kind::BYTES:
+            return to_hex_string(value.to_bytes());
+        case FieldValue::Kind::NONE:
             return "unknown";
-        }
-    }, value);
+        default:
+            break;
+    }
+    
+    double numeric_val = value.as_double() * lsb;
+    
+    switch (unit) {
+        case Unit::SECONDS:
+            return format_time_of_day(static_cast<uint32_t>(value.as_signed()), lsb);
+        case Unit::NAUTICAL_MILES:
+            return std::to_string(numeric_val) + " NM";
+        case Unit::DEGREES:
+            return std::to_string(numeric_val) + "°";
+        case Unit::FLIGHT_LEVEL:
+            return format_flight_level(static_cast<uint16_t>(value.as_signed()), lsb);
+        case Unit::FEET:
+            return std::to_string(numeric_val) + " ft";
+        case Unit::KNOTS:
+            return std::to_string(numeric_val) + " kts";
+        case Unit::METERS_PER_SECOND:
+            return std::to_string(numeric_val) + " m/s";
+        default:
+            return std::to_string(numeric_val);
+    }
 }
 
 std::string format_time_of_day(uint32_t tod_value, double lsb) {
@@ -212,29 +210,134 @@ std::string bits_to_string(const std::vector<uint8_t>& data) {
     return result;
 }
 
-MessageStatistics analyze_messages(const std::vector<AsterixMessage>& messages) {
-    MessageStatistics stats;
-    
-    stats.total_messages = messages.size();
+size_t fspec_length(const uint8_t* data, size_t size) {
+    return kernels::active().fspec_length(data, size);
+}
+
+std::vector<uint8_t> unpack_6bit(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> codes(data.size() * 8 / 6 + 1);
+    codes.resize(kernels::active().unpack_6bit(data.data(), data.size(), codes.data()));
+    return codes;
+}
+
+namespace {
+
+// FSPEC of a decoded message, rebuilt from its items' UAP positions
+uint64_t fspec_pattern(const AsterixMessage& message) {
+    if (!message.definition) {
+        return 0;
+    }
+    const auto& uap = message.definition->uap.items;
+    uint8_t bytes[8] = {};
+    size_t length = 0;
     
-    for (const auto& message : messages) {
-        if (message.valid) {
-            stats.valid_messages++;
-        } else {
-            stats.invalid_messages++;
-            stats.errors.push_back(message.error_message);
+    for (const auto& item : message.data_items) {
+        auto it = std::find(uap.begin(), uap.end(), item.id);
+        size_t index = static_cast<size_t>(it - uap.begin());
+        if (it == uap.end() || index >= 56) {
+            continue;
         }
+        bytes[index / 7] |= static_cast<uint8_t>(0x80 >> (index % 7));
+        length = std::max(length, index / 7 + 1);
+    }
+    
+    uint64_t pattern = 0;
+    for (size_t i = 0; i < length; ++i) {
+        pattern = (pattern << 8) | bytes[i] | (i + 1 < length ? 0x01 : 0x00);
+    }
+    return pattern;
+}
+
+std::string format_fspec(uint64_t pattern) {
+    std::ostringstream out;
+    out << std::hex << std::uppercase << std::setfill('0');
+    size_t bytes = 1;
+    while (bytes < 8 && (pattern >> (8 * bytes))) {
+        bytes++;
+    }
+    for (size_t i = bytes; i-- > 0;) {
+        out << std::setw(2) << ((pattern >> (8 * i)) & 0xFF) << (i ? " " : "");
+    }
+    return out.str();
+}
+
+bool ends_with(const std::string& value, const char* suffix) {
+    size_t length = std::strlen(suffix);
+    return value.size() >= length && value.compare(value.size() - length, length, suffix) == 0;
+}
+
+void count_error(MessageStatistics& stats, const std::string& message, size_t count) {
+    auto it = stats.error_counts.find(message);
+    if (it != stats.error_counts.end()) {
+        it->second += count;
+    } else if (stats.error_counts.size() < MessageStatistics::kMaxErrorMessages) {
+        stats.error_counts.emplace(message, count);
+    } else {
+        stats.other_errors += count;
+    }
+}
+
+} // namespace
+
+void accumulate_statistics(MessageStatistics& stats, const AsterixMessage& message) {
+    stats.total_messages++;
+    if (message.valid) {
+        stats.valid_messages++;
+    } else {
+        stats.invalid_messages++;
+        count_error(stats, message.error_message, 1);
+    }
+    
+    stats.category_counts[message.category]++;
+    
+    for (const auto& item : message.data_items) {
+        stats.data_item_counts[item.id]++;
         
-        stats.category_counts[message.category]++;
-        
-        for (const auto& item : message.data_items) {
-            stats.data_item_counts[item.id]++;
+        if (ends_with(item.id, "/010") && item.fields.size() >= 2) {
+            stats.radars.add((item.fields[0].value.as_unsigned() << 8) | (item.fields[1].value.as_unsigned() & 0xFF));
+        } else if (item.id == "I002/080") {
+            // WE_VALUE and the WE_VALUE2... of the extensions
+            for (const auto& field : item.fields) {
+                if (field.name.compare(0, 8, "WE_VALUE") == 0) {
+                    stats.warning_codes.add(field.value.as_unsigned());
+                }
+            }
         }
     }
     
+    if (uint64_t pattern = fspec_pattern(message)) {
+        stats.fspec_patterns.add(pattern);
+    }
+}
+
+MessageStatistics analyze_messages(const std::vector<AsterixMessage>& messages) {
+    MessageStatistics stats;
+    for (const auto& message : messages) {
+        accumulate_statistics(stats, message);
+    }
     return stats;
 }
 
+void merge_statistics(MessageStatistics& stats, const MessageStatistics& other) {
+    stats.total_messages += other.total_messages;
+    stats.valid_messages += other.valid_messages;
+    stats.invalid_messages += other.invalid_messages;
+    for (const auto& pair : other.category_counts) {
+        stats.category_counts[pair.first] += pair.second;
+    }
+    for (const auto& pair : other.data_item_counts) {
+        stats.data_item_counts[pair.first] += pair.second;
+    }
+    for (const auto& pair : other.error_counts) {
+        count_error(stats, pair.first, pair.second);
+    }
+    stats.other_errors += other.other_errors;
+    
+    stats.warning_codes.merge(other.warning_codes);
+    stats.fspec_patterns.merge(other.fspec_patterns);
+    stats.radars.merge(other.radars);
+}
+
 void print_statistics(const MessageStatistics& stats) {
     std::cout << "=== MESSAGE STATISTICS ===" << std::endl;
     std::cout << "Total messages: " << stats.total_messages << std::endl;
@@ -266,16 +369,35 @@ void print_statistics(const MessageStatistics& stats) {
         }
     }
     
-    if (!stats.errors.empty()) {
-        std::cout << "\nErrors encountered:" << std::endl;
-        std::unordered_map<std::string, size_t> error_counts;
-        for (const auto& error : stats.errors) {
-            error_counts[error]++;
+    if (stats.radars.estimate() > 0.0) {
+        std::cout << "\nDistinct radars (SAC/SIC): ~" << std::fixed << std::setprecision(0)
+                  << stats.radars.estimate() << std::endl;
+    }
+    
+    auto warnings = stats.warning_codes.top(10);
+    if (!warnings.empty()) {
+        std::cout << "\nTop warning codes (I002/080):" << std::endl;
+        for (const auto& entry : warnings) {
+            std::cout << "  " << std::setw(12) << entry.key << ": " << std::setw(6) << entry.count << std::endl;
         }
-        
-        for (const auto& pair : error_counts) {
+    }
+    
+    auto patterns = stats.fspec_patterns.top(10);
+    if (!patterns.empty()) {
+        std::cout << "\nTop FSPEC patterns:" << std::endl;
+        for (const auto& entry : patterns) {
+            std::cout << "  " << std::setw(12) << format_fspec(entry.key) << ": " << std::setw(6) << entry.count << std::endl;
+        }
+    }
+    
+    if (!stats.error_counts.empty() || stats.other_errors > 0) {
+        std::cout << "\nErrors encountered:" << std::endl;
+        for (const auto& pair : stats.error_counts) {
             std::cout << "  " << pair.first << " (" << pair.second << " times)" << std::endl;
         }
+        if (stats.other_errors > 0) {
+            std::cout << "  Other errors (" << stats.other_errors << " times)" << std::endl;
+        }
     }
 }
 
@@ -291,18 +413,15 @@ std::string to_json(const ParsedField& field) {
     }
     
     ss << "  \"value\": ";
-    std::visit([&](const auto& value) {
-        using T = std::decay_t<decltype(value)>;
-        if constexpr (std::is_same_v<T, bool>) {
-            ss << (value ? "true" : "false");
-        } else if constexpr (std::is_same_v<T, std::string>) {
-            ss << "\"" << value << "\"";
-        } else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
-            ss << "\"" << to_hex_string(value) << "\"";
-        } else {
-            ss << value;
-        }
-    }, field.value);
+    switch (field.value.kind()) {
+        case FieldValue::Kind::BOOL: ss << (field.value.as_bool() ? "true" : "false"); break;
+        case FieldValue::Kind::STRING: ss << "\"" << field.value.as_string() << "\""; break;
+        case FieldValue::Kind::BYTES: ss << "\"" << to_hex_string(field.value.to_bytes()) << "\""; break;
+        case FieldValue::Kind::UNSIGNED: ss << field.value.as_unsigned(); break;
+        case FieldValue::Kind::SIGNED: ss << field.value.as_signed(); break;
+        case FieldValue::Kind::REAL: ss << field.value.as_double(); break;
+        case FieldValue::Kind::NONE: ss << "null"; break;
+    }
     
     ss << ",\n";
     ss << "  \"unit\": \"";
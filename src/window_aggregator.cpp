@@ -0,0 +1,379 @@
+#include "skydecoder/window_aggregator.h"
+#include "day_time.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace skydecoder {
+
+namespace {
+
+const Field* find_field(const std::vector<Field>& fields, const std::string& name) {
+    for (const auto& field : fields) {
+        if (field.name == name) {
+            return &field;
+        }
+        if (const Field* extension = find_field(field.extension_fields, name)) {
+            return extension;
+        }
+    }
+    return nullptr;
+}
+
+const ParsedField* find_value(const ParsedDataItem& item, const std::string& name) {
+    for (const auto& field : item.fields) {
+        if (field.name == name) {
+            return field.valid ? &field : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+uint64_t hash_key(const uint64_t* key, size_t size) {
+    uint64_t hash = 0x9E3779B97F4A7C15ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= key[i] + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    }
+    return hash ^ (hash >> 29);
+}
+
+} // namespace
+
+// Group states of one window, in first-seen order
+struct WindowAggregator::Window {
+    int64_t index = 0;
+    std::vector<uint32_t> table;                // State index + 1, 0 if empty
+    std::vector<uint64_t> keys;                 // group_by size per state
+    std::vector<Accumulator> accumulators;      // aggregates size per state
+    std::vector<uint64_t> records;
+
+    size_t groups() const { return records.size(); }
+
+    void reserve(size_t expected, size_t key_size, size_t aggregate_count) {
+        size_t capacity = 16;
+        while (capacity < expected * 2) {
+            capacity <<= 1;
+        }
+        table.assign(capacity, 0);
+        keys.reserve(expected * key_size);
+        accumulators.reserve(expected * aggregate_count);
+        records.reserve(expected);
+    }
+
+    void clear() {
+        std::fill(table.begin(), table.end(), 0);
+        keys.clear();
+        accumulators.clear();
+        records.clear();
+    }
+
+    void insert_slot(size_t state, size_t key_size) {
+        size_t mask = table.size() - 1;
+        size_t position = hash_key(keys.data() + state * key_size, key_size) & mask;
+        while (table[position] != 0) {
+            position = (position + 1) & mask;
+        }
+        table[position] = static_cast<uint32_t>(state + 1);
+    }
+
+    // State of the group, created if new
+    size_t find_or_insert(const std::vector<uint64_t>& key, size_t aggregate_count) {
+        const size_t key_size = key.size();
+        size_t mask = table.size() - 1;
+        size_t position = hash_key(key.data(), key_size) & mask;
+
+        while (uint32_t entry = table[position]) {
+            size_t state = entry - 1;
+            if (std::equal(key.begin(), key.end(), keys.begin() + state * key_size)) {
+                return state;
+            }
+            position = (position + 1) & mask;
+        }
+
+        size_t state = groups();
+        keys.insert(keys.end(), key.begin(), key.end());
+        accumulators.insert(accumulators.end(), aggregate_count,
+                            Accumulator{std::numeric_limits<double>::infinity(),
+                                        -std::numeric_limits<double>::infinity(), 0.0, 0});
+        records.push_back(0);
+
+        if ((state + 1) * 2 > table.size()) {
+            table.assign(table.size() * 2, 0);
+            for (size_t i = 0; i <= state; ++i) {
+                insert_slot(i, key_size);
+            }
+        } else {
+            table[position] = static_cast<uint32_t>(state + 1);
+        }
+        return state;
+    }
+};
+
+WindowAggregator::WindowAggregator(const AsterixCategory& category, ResultHandler handler, WindowOptions options)
+    : handler_(std::move(handler)), options_(std::move(options)), category_(category.header.category) {
+    if (!(options_.size > 0.0)) {
+        throw std::runtime_error("Window size must be positive");
+    }
+    slide_ = options_.slide > 0.0 && options_.slide < options_.size ? options_.slide : options_.size;
+
+    time_ = resolve(category, options_.time, false);
+    for (const auto& ref : options_.group_by) {
+        group_by_.push_back(resolve(category, ref, false));
+    }
+    for (const auto& spec : options_.aggregates) {
+        bool record_count = spec.kind == AggregateKind::COUNT && spec.source.item_id.empty();
+        aggregates_.push_back(resolve(category, spec.source, record_count));
+    }
+
+    key_.resize(group_by_.size());
+    values_.resize(aggregates_.size());
+    present_.resize(aggregates_.size());
+}
+
+WindowAggregator::~WindowAggregator() = default;
+
+WindowAggregator::Source WindowAggregator::resolve(const AsterixCategory& category, const FieldRef& ref,
+                                                   bool allow_empty) {
+    Source source;
+    source.item_id = ref.item_id;
+    source.field = ref.field;
+    if (ref.item_id.empty() && allow_empty) {
+        return source;
+    }
+
+    auto it = category.data_items.find(ref.item_id);
+    if (it == category.data_items.end()) {
+        throw std::runtime_error("Unknown data item for window aggregation: " + ref.item_id);
+    }
+    const Field* field = find_field(it->second.fields, ref.field);
+    if (!field) {
+        throw std::runtime_error("Unknown field for window aggregation: " + ref.item_id + "/" + ref.field);
+    }
+    source.lsb = field->lsb;
+
+    auto item = std::find(items_.begin(), items_.end(), ref.item_id);
+    source.slot = static_cast<int>(item - items_.begin());
+    if (item == items_.end()) {
+        items_.push_back(ref.item_id);
+    }
+    return source;
+}
+
+void WindowAggregator::reset_values() {
+    has_time_ = false;
+    std::fill(key_.begin(), key_.end(), 0);
+    std::fill(present_.begin(), present_.end(), false);
+}
+
+void WindowAggregator::take(const ParsedDataItem& item, int slot) {
+    if (time_.slot == slot) {
+        if (const ParsedField* field = find_value(item, time_.field)) {
+            record_time_ = field->value.as_double() * time_.lsb;
+            has_time_ = true;
+        }
+    }
+    for (size_t i = 0; i < group_by_.size(); ++i) {
+        if (group_by_[i].slot == slot) {
+            if (const ParsedField* field = find_value(item, group_by_[i].field)) {
+                key_[i] = field->value.as_unsigned();
+            }
+        }
+    }
+    for (size_t i = 0; i < aggregates_.size(); ++i) {
+        if (aggregates_[i].slot == slot) {
+            if (const ParsedField* field = find_value(item, aggregates_[i].field)) {
+                values_[i] = field->value.as_double() * aggregates_[i].lsb;
+                present_[i] = true;
+            }
+        }
+    }
+}
+
+void WindowAggregator::add(const AsterixBlock& block) {
+    for (const auto& message : block.messages) {
+        add(message);
+    }
+}
+
+void WindowAggregator::add(const AsterixMessage& message) {
+    stats_.records++;
+    if (message.category != category_) {
+        stats_.other_category++;
+        return;
+    }
+
+    reset_values();
+    for (const auto& item : message.data_items) {
+        auto it = std::find(items_.begin(), items_.end(), item.id);
+        if (it != items_.end()) {
+            take(item, static_cast<int>(it - items_.begin()));
+        }
+    }
+    aggregate();
+}
+
+void WindowAggregator::add(LazyRecord& record) {
+    stats_.records++;
+    if (record.category() != category_) {
+        stats_.other_category++;
+        return;
+    }
+
+    reset_values();
+    for (size_t slot = 0; slot < items_.size(); ++slot) {
+        if (const ParsedDataItem* item = record.item(items_[slot])) {
+            take(*item, static_cast<int>(slot));
+        }
+    }
+    aggregate();
+}
+
+void WindowAggregator::aggregate() {
+    if (!has_time_) {
+        stats_.no_time++;
+        return;
+    }
+
+    double time = day_time::resolve(record_time_, watermark_);
+
+    // Windows [index * slide, index * slide + size) holding the time
+    int64_t last = static_cast<int64_t>(std::floor(time / slide_));
+    int64_t first = static_cast<int64_t>(std::floor((time - options_.size) / slide_)) + 1;
+    bool late = false;
+    bool aggregated = false;
+
+    for (int64_t index = first; index <= last; ++index) {
+        if (index < emitted_below_) {
+            late = true;
+            continue;
+        }
+
+        Window& window = *window_for(index);
+        size_t state = window.find_or_insert(key_, aggregates_.size());
+        window.records[state]++;
+
+        Accumulator* accumulators = window.accumulators.data() + state * aggregates_.size();
+        for (size_t i = 0; i < aggregates_.size(); ++i) {
+            Accumulator& accumulator = accumulators[i];
+            if (aggregates_[i].slot < 0) {
+                accumulator.count++;
+            } else if (present_[i]) {
+                accumulator.min = std::min(accumulator.min, values_[i]);
+                accumulator.max = std::max(accumulator.max, values_[i]);
+                accumulator.sum += values_[i];
+                accumulator.count++;
+            }
+        }
+        aggregated = true;
+    }
+
+    if (late) {
+        stats_.late++;
+    }
+    if (aggregated) {
+        stats_.aggregated++;
+    }
+    advance(time);
+}
+
+WindowAggregator::Window* WindowAggregator::window_for(int64_t index) {
+    auto position = std::lower_bound(open_.begin(), open_.end(), index,
+                                     [](const std::unique_ptr<Window>& window, int64_t value) {
+                                         return window->index < value;
+                                     });
+    if (position != open_.end() && (*position)->index == index) {
+        return position->get();
+    }
+
+    std::unique_ptr<Window> window;
+    if (!spare_.empty()) {
+        window = std::move(spare_.back());
+        spare_.pop_back();
+    } else {
+        window = std::make_unique<Window>();
+        window->reserve(options_.expected_keys, group_by_.size(), aggregates_.size());
+    }
+    window->index = index;
+    return open_.insert(position, std::move(window))->get();
+}
+
+void WindowAggregator::advance(double time) {
+    watermark_ = std::max(watermark_, time);
+
+    size_t closed = 0;
+    while (closed < open_.size()) {
+        Window& window = *open_[closed];
+        double end = window.index * slide_ + options_.size;
+        if (end + options_.allowed_lateness > watermark_) {
+            break;
+        }
+        emit(window);
+        closed++;
+    }
+
+    for (size_t i = 0; i < closed; ++i) {
+        open_[i]->clear();
+        spare_.push_back(std::move(open_[i]));
+    }
+    open_.erase(open_.begin(), open_.begin() + closed);
+}
+
+void WindowAggregator::emit(Window& window) {
+    const size_t key_size = group_by_.size();
+    const size_t aggregate_count = aggregates_.size();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    WindowResult result;
+    result.start = window.index * slide_;
+    result.end = result.start + options_.size;
+    result.key = &result_key_;
+    result.values = &result_values_;
+
+    for (size_t state = 0; state < window.groups(); ++state) {
+        result_key_.assign(window.keys.begin() + state * key_size, window.keys.begin() + (state + 1) * key_size);
+        result_values_.resize(aggregate_count);
+
+        const Accumulator* accumulators = window.accumulators.data() + state * aggregate_count;
+        for (size_t i = 0; i < aggregate_count; ++i) {
+            const Accumulator& accumulator = accumulators[i];
+            switch (options_.aggregates[i].kind) {
+                case AggregateKind::COUNT:
+                    result_values_[i] = static_cast<double>(accumulator.count);
+                    break;
+                case AggregateKind::MIN:
+                    result_values_[i] = accumulator.count ? accumulator.min : nan;
+                    break;
+                case AggregateKind::MAX:
+                    result_values_[i] = accumulator.count ? accumulator.max : nan;
+                    break;
+                case AggregateKind::SUM:
+                    result_values_[i] = accumulator.sum;
+                    break;
+                case AggregateKind::AVG:
+                    result_values_[i] = accumulator.count ? accumulator.sum / accumulator.count : nan;
+                    break;
+            }
+        }
+
+        result.records = window.records[state];
+        if (handler_) {
+            handler_(result);
+        }
+        stats_.results_emitted++;
+    }
+
+    stats_.windows_emitted++;
+    emitted_below_ = std::max(emitted_below_, window.index + 1);
+}
+
+void WindowAggregator::flush() {
+    for (auto& window : open_) {
+        emit(*window);
+        window->clear();
+        spare_.push_back(std::move(window));
+    }
+    open_.clear();
+}
+
+} // namespace skydecoder
\ No newline at end of file
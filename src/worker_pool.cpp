@@ -0,0 +1,104 @@
+#include "skydecoder/worker_pool.h"
+#include <algorithm>
+
+namespace skydecoder {
+
+WorkerPool::WorkerPool(size_t threads, const MemoryOptions& options) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    for (size_t worker = 1; worker < threads; ++worker) {
+        threads_.emplace_back(&WorkerPool::worker_loop, this, worker, options);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_all();
+    
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkerPool::worker_loop(size_t worker, const MemoryOptions& options) {
+    if (options.pin_threads && options.numa_node >= 0) {
+        // One CPU per worker, wrapping around the CPUs of the node
+        auto cpus = numa::node_cpus(options.numa_node);
+        if (!cpus.empty()) {
+            numa::pin_current_thread_to_cpu(cpus[worker % cpus.size()]);
+        }
+    }
+    
+    size_t seen_generation = 0;
+    
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_ready_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+        
+        run_chunks(worker);
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--active_ == 0) {
+                work_done_.notify_one();
+            }
+        }
+    }
+}
+
+void WorkerPool::run_chunks(size_t worker) {
+    while (true) {
+        size_t begin = next_.fetch_add(grain_, std::memory_order_relaxed);
+        if (begin >= count_) {
+            return;
+        }
+        
+        size_t end = std::min(begin + grain_, count_);
+        for (size_t index = begin; index < end; ++index) {
+            (*task_)(worker, index);
+        }
+    }
+}
+
+void WorkerPool::parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+    
+    if (threads_.empty() || count <= grain) {
+        for (size_t index = 0; index < count; ++index) {
+            task(0, index);
+        }
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        grain_ = std::max<size_t>(grain, 1);
+        next_.store(0, std::memory_order_relaxed);
+        active_ = threads_.size();
+        generation_++;
+    }
+    work_ready_.notify_all();
+    
+    run_chunks(0);
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    work_done_.wait(lock, [&] { return active_ == 0; });
+    task_ = nullptr;
+}
+
+} // namespace skydecoder
\ No newline at end of file
@@ -238,6 +238,16 @@ Field XmlParser::parse_field(const tinyxml2::XMLElement* field_elem) {
         field.encoding = encoding_attr;
     }
     
+    auto min_attr = field_elem->Attribute("min");
+    if (min_attr) {
+        field.min_value = std::stod(min_attr);
+    }
+    
+    auto max_attr = field_elem->Attribute("max");
+    if (max_attr) {
+        field.max_value = std::stod(max_attr);
+    }
+    
     // Parse enums
     field.enums = parse_enums(field_elem);
     